@@ -0,0 +1,131 @@
+/*
+ * Runs random lookups and replacements on a concurrent map from 1 up to 64
+ * threads, with 100%, 95% and 50% of the operations being lookups, and
+ * prints the throughput of every mix.
+ *
+ * Usage: cmap_bench [keys] [operations per thread]
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "ds/cmap.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <pthread.h>
+
+#define MAX_THREADS 64
+
+
+struct job
+{
+    cmap_t   map;
+    uint64_t seed;
+    unsigned read_percent;
+    uint64_t found;
+};
+
+
+static size_t key_amount = (size_t)1 << 16;
+static size_t op_amount  = 50000;
+
+
+static double
+now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+
+static uint64_t
+next_random(uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+
+static void *
+run(void *arg)
+{
+    struct job *job = arg;
+
+    for (size_t i = 0; i < op_amount; i++)
+    {
+        uint64_t random = next_random(&job->seed);
+        uint64_t key    = (random >> 8) % key_amount;
+        uint64_t value;
+
+        if (random % 100 < job->read_percent)
+            job->found += cmap_get(job->map, &key, &value) == 0;
+        else
+            cmap_put(job->map, &key, &random);
+    }
+
+    return NULL;
+}
+
+
+static double
+measure(cmap_t map, size_t threads, unsigned read_percent)
+{
+    pthread_t  ids[MAX_THREADS];
+    struct job jobs[MAX_THREADS];
+
+    double start = now();
+    for (size_t t = 0; t < threads; t++)
+    {
+        jobs[t].map          = map;
+        jobs[t].seed         = 0x9e3779b97f4a7c15ULL * (t + 1);
+        jobs[t].read_percent = read_percent;
+        jobs[t].found        = 0;
+        pthread_create(&ids[t], NULL, run, &jobs[t]);
+    }
+
+    uint64_t found = 0;
+    for (size_t t = 0; t < threads; t++)
+    {
+        pthread_join(ids[t], NULL);
+        found += jobs[t].found;
+    }
+
+    if (found > threads * op_amount) puts("?");
+    return (double)(threads * op_amount) / ((now() - start) / 1e3);
+}
+
+
+int
+main(int argc, char **argv)
+{
+    static const unsigned mixes[] = { 100, 95, 50 };
+
+    if (argc > 1) key_amount = strtoul(argv[1], NULL, 10);
+    if (argc > 2) op_amount = strtoul(argv[2], NULL, 10);
+    if (key_amount == 0) key_amount = 1;
+
+    cmap_t map = cmap_new(sizeof(uint64_t), sizeof(uint64_t));
+    if (map == NULL) return 1;
+
+    for (uint64_t key = 0; key < key_amount; key++)
+        cmap_insert(map, &key, &key);
+
+    printf("%zu keys, %zu operations per thread, million operations/s\n",
+           key_amount, op_amount);
+    printf("threads   100%% reads    95%% reads    50%% reads\n");
+
+    for (size_t threads = 1; threads <= MAX_THREADS; threads *= 2)
+    {
+        printf("%7zu", threads);
+        for (size_t m = 0; m < sizeof(mixes) / sizeof(*mixes); m++)
+            printf("  %11.2f", measure(map, threads, mixes[m]));
+        putchar('\n');
+    }
+
+    cmap_free(map);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * Looks for a missing key in arrays of 1, 2, 4 and 8-byte elements, once
+ * with a loop over darray_at and memcmp, and once with darray_find.
+ *
+ * Usage: find_bench [elements] [rounds]
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "ds/darray.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static size_t elem_amount  = 1000000;
+static size_t round_amount = 50;
+
+
+static double
+now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+
+static void *
+loop_find(darray_t da, const void *key)
+{
+    for (size_t i = 0; i < darray_size(da); i++)
+    {
+        void *elem = darray_at(da, i);
+        if (memcmp(elem, key, darray_type_size(da)) == 0) return elem;
+    }
+
+    return NULL;
+}
+
+
+static void
+run(size_t width)
+{
+    darray_t da = darray_new(width);
+    darray_resize(da, elem_amount);
+
+    /* the key is all ones, every element is smaller */
+    unsigned char *data = darray_data(da);
+    for (size_t i = 0; i < elem_amount * width; i++)
+        data[i] = (unsigned char)(i % 251);
+
+    uint64_t key = UINT64_MAX;
+    void    *res = NULL;
+
+    double start = now();
+    for (size_t i = 0; i < round_amount; i++) res = loop_find(da, &key);
+    double loop = now() - start;
+
+    start = now();
+    for (size_t i = 0; i < round_amount; i++)
+    {
+        /* darray_find is pure, keep it from being hoisted out of the loop */
+        __asm__ volatile("" ::: "memory");
+        res = darray_find(da, &key);
+    }
+    double find = now() - start;
+
+    double scale = (double)(elem_amount * round_amount);
+    printf("%zu-byte elements: loop %6.3f ns, darray_find %6.3f ns%s\n",
+           width, loop / scale, find / scale, res != NULL ? " (found?)" : "");
+
+    darray_free_full(da);
+}
+
+
+int
+main(int argc, char **argv)
+{
+    if (argc > 1) elem_amount = strtoul(argv[1], NULL, 10);
+    if (argc > 2) round_amount = strtoul(argv[2], NULL, 10);
+
+    printf("%zu elements, %zu rounds, per element\n", elem_amount,
+           round_amount);
+    for (size_t width = 1; width <= 8; width *= 2) run(width);
+    return 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * Gathers random elements out of an array of 4 and 8-byte elements larger
+ * than the cache, once with a loop over darray_at, and once with
+ * darray_gather at several prefetch distances.
+ *
+ * Usage: gather_bench [elements] [indices]
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "ds/darray.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static size_t elem_amount  = (size_t)1 << 24;
+static size_t index_amount = (size_t)1 << 22;
+
+
+static double
+now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+
+static void
+run(size_t width, const size_t *indices)
+{
+    static const size_t distances[] = { 0, 8, 16, 32 };
+
+    darray_t src = darray_new(width);
+    darray_t dst = darray_new(width);
+    darray_resize(src, elem_amount);
+    darray_resize(dst, index_amount);
+
+    unsigned char *out   = darray_data(dst);
+    double         start = now();
+    for (size_t i = 0; i < index_amount; i++)
+        memcpy(out + (i * width), darray_at(src, indices[i]), width);
+    double loop = now() - start;
+
+    printf("%zu-byte elements: loop %6.3f ns", width,
+           loop / (double)index_amount);
+
+    for (size_t d = 0; d < sizeof(distances) / sizeof(*distances); d++)
+    {
+        darray_set_prefetch_distance(distances[d]);
+
+        start = now();
+        darray_gather(dst, src, indices, index_amount);
+        printf(", distance %zu %6.3f ns", distances[d],
+               (now() - start) / (double)index_amount);
+    }
+    putchar('\n');
+
+    darray_set_prefetch_distance(16);
+    darray_free_full(src);
+    darray_free_full(dst);
+}
+
+
+int
+main(int argc, char **argv)
+{
+    if (argc > 1) elem_amount = strtoul(argv[1], NULL, 10);
+    if (argc > 2) index_amount = strtoul(argv[2], NULL, 10);
+    if (elem_amount == 0) elem_amount = 1;
+
+    size_t *indices = malloc(index_amount * sizeof(size_t));
+    if (indices == NULL) return 1;
+
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < index_amount; i++)
+    {
+        state      ^= state << 13;
+        state      ^= state >> 7;
+        state      ^= state << 17;
+        indices[i]  = (size_t)(state % elem_amount);
+    }
+
+    printf("%zu elements, %zu random indices, per index\n", elem_amount,
+           index_amount);
+    run(4, indices);
+    run(8, indices);
+
+    free(indices);
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * Walks a list whose nodes were allocated in a shuffled order, with and
+ * without a lookahead, then again after list_compact.
+ *
+ * Usage: list_bench [nodes] [rounds]
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "ds/list.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static size_t node_amount  = 1000000;
+static size_t round_amount = 10;
+
+
+static double
+now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+
+static int
+add(void *value, void *data)
+{
+    *(uintptr_t *)data += (uintptr_t)value;
+    return 0;
+}
+
+
+static double
+walk(list_t list, size_t lookahead)
+{
+    uintptr_t sum   = 0;
+    double    start = now();
+
+    for (size_t r = 0; r < round_amount; r++)
+        list_foreach(list, lookahead, add, &sum);
+
+    if (sum == 1) puts("?");
+    return (now() - start) / (double)(node_amount * round_amount);
+}
+
+
+int
+main(int argc, char **argv)
+{
+    if (argc > 1) node_amount = strtoul(argv[1], NULL, 10);
+    if (argc > 2) round_amount = strtoul(argv[2], NULL, 10);
+    if (node_amount < 2) node_amount = 2;
+
+    /* allocate every node up front, then link them in a shuffled order */
+    list_t *nodes = malloc(node_amount * sizeof(list_t));
+    if (nodes == NULL) return 1;
+
+    for (size_t i = 0; i < node_amount; i++)
+    {
+        nodes[i] = list_new_with_allocator(malloc, free);
+        list_set_data(nodes[i], (void *)(uintptr_t)i);
+    }
+
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = node_amount - 1; i > 0; i--)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        size_t j = (size_t)(state % (i + 1));
+        list_t t = nodes[i];
+        nodes[i] = nodes[j];
+        nodes[j] = t;
+    }
+
+    for (size_t i = 1; i < node_amount; i++)
+        list_concat(nodes[i - 1], nodes[i]);
+
+    list_t list = nodes[0];
+    free(nodes);
+
+    printf("%zu nodes, %zu rounds, per node\n", node_amount, round_amount);
+    double plain = walk(list, 0);
+    double ahead = walk(list, 8);
+    printf("scattered: %6.3f ns, lookahead 8: %6.3f ns\n", plain, ahead);
+
+    list = list_compact(list);
+    if (list == NULL) return 1;
+
+    plain = walk(list, 0);
+    ahead = walk(list, 8);
+    printf("compacted: %6.3f ns, lookahead 8: %6.3f ns\n", plain, ahead);
+
+    list_free(list);
+    return 0;
+}
@@ -0,0 +1,173 @@
+/*
+ * Sums an array of doubles, and takes the min and max of an array of 32-bit
+ * integers and the argmax of an array of 64-bit ones, once with a loop over
+ * darray_at and once with the reductions, single threaded and split between
+ * 4 threads.
+ *
+ * Usage: reduce_bench [elements] [rounds]
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "ds/reduce.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static size_t elem_amount  = 16000000;
+static size_t round_amount = 20;
+
+
+static double
+now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+
+static void
+report(const char *name, double loop, double one, double four)
+{
+    double scale = (double)(elem_amount * round_amount);
+    printf("%-12s loop %6.3f ns, 1 thread %6.3f ns, 4 threads %6.3f ns\n",
+           name, loop / scale, one / scale, four / scale);
+}
+
+
+static void
+run_sum(void)
+{
+    darray_t da = darray_new(sizeof(double));
+    darray_resize(da, elem_amount);
+
+    double *data = darray_data(da);
+    for (size_t i = 0; i < elem_amount; i++) data[i] = (double)(i % 1000);
+
+    double sum = 0, times[3];
+
+    double start = now();
+    for (size_t r = 0; r < round_amount; r++)
+        for (size_t i = 0; i < darray_size(da); i++)
+            sum += *(double *)darray_at(da, i);
+    times[0] = now() - start;
+
+    for (size_t t = 0; t < 2; t++)
+    {
+        darray_reduce_set_threads(t == 0 ? 1 : 4);
+
+        start = now();
+        for (size_t r = 0; r < round_amount; r++)
+        {
+            double part;
+            darray_sum_f64(da, &part);
+            sum += part;
+        }
+        times[t + 1] = now() - start;
+    }
+
+    report("sum_f64", times[0], times[1], times[2]);
+    if (sum < 0) puts("?");
+
+    darray_free_full(da);
+}
+
+
+static void
+run_minmax(void)
+{
+    darray_t da = darray_new(sizeof(int32_t));
+    darray_resize(da, elem_amount);
+
+    int32_t *data = darray_data(da);
+    for (size_t i = 0; i < elem_amount; i++)
+        data[i] = (int32_t)((i * 2654435761U) % 100000);
+
+    int32_t min = INT32_MAX, max = INT32_MIN;
+    double  times[3];
+
+    double start = now();
+    for (size_t r = 0; r < round_amount; r++)
+        for (size_t i = 0; i < darray_size(da); i++)
+        {
+            int32_t value = *(int32_t *)darray_at(da, i);
+            if (value < min) min = value;
+            if (value > max) max = value;
+        }
+    times[0] = now() - start;
+
+    for (size_t t = 0; t < 2; t++)
+    {
+        darray_reduce_set_threads(t == 0 ? 1 : 4);
+
+        start = now();
+        for (size_t r = 0; r < round_amount; r++)
+        {
+            __asm__ volatile("" ::: "memory");
+            darray_minmax_i32(da, &min, &max);
+        }
+        times[t + 1] = now() - start;
+    }
+
+    report("minmax_i32", times[0], times[1], times[2]);
+    if (min > max) puts("?");
+
+    darray_free_full(da);
+}
+
+
+static void
+run_argmax(void)
+{
+    darray_t da = darray_new(sizeof(uint64_t));
+    darray_resize(da, elem_amount);
+
+    uint64_t *data = darray_data(da);
+    for (size_t i = 0; i < elem_amount; i++)
+        data[i] = (i * 0x9e3779b97f4a7c15ULL) >> 20;
+
+    size_t index = 0;
+    double times[3];
+
+    double start = now();
+    for (size_t r = 0; r < round_amount; r++)
+        for (size_t i = 1; i < darray_size(da); i++)
+            if (*(uint64_t *)darray_at(da, i) > data[index]) index = i;
+    times[0] = now() - start;
+
+    for (size_t t = 0; t < 2; t++)
+    {
+        darray_reduce_set_threads(t == 0 ? 1 : 4);
+
+        start = now();
+        for (size_t r = 0; r < round_amount; r++)
+        {
+            __asm__ volatile("" ::: "memory");
+            darray_argmax_u64(da, &index);
+        }
+        times[t + 1] = now() - start;
+    }
+
+    report("argmax_u64", times[0], times[1], times[2]);
+    if (index >= elem_amount) puts("?");
+
+    darray_free_full(da);
+}
+
+
+int
+main(int argc, char **argv)
+{
+    if (argc > 1) elem_amount = strtoul(argv[1], NULL, 10);
+    if (argc > 2) round_amount = strtoul(argv[2], NULL, 10);
+
+    printf("%zu elements, %zu rounds, per element\n", elem_amount,
+           round_amount);
+    run_sum();
+    run_minmax();
+    run_argmax();
+
+    darray_reduce_set_threads(1);
+    return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * Churns list nodes and darray handles from several threads, with half of
+ * the lists freed by another thread than the one that built them, once with
+ * the thread-local cache disabled and once with it enabled.
+ *
+ * Usage: tcache_bench [threads] [rounds]
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "ds/tcache.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <pthread.h>
+
+#include "ds/darray.h"
+#include "ds/list.h"
+
+#define MAX_THREADS 64
+#define LIST_NODES  32
+
+
+static list_t slots[MAX_THREADS];
+static size_t thread_amount = 4;
+static size_t round_amount  = 20000;
+
+
+static void *
+churn(void *arg)
+{
+    uintptr_t id = (uintptr_t)arg;
+
+    for (size_t i = 0; i < round_amount; i++)
+    {
+        list_t head = list_new();
+        list_t tail = head;
+        for (size_t j = 1; j < LIST_NODES; j++) tail = list_append(tail, NULL);
+
+        /* every other list is freed by whichever thread picks it up */
+        if (i % 2 == 0)
+            head = __atomic_exchange_n(&slots[(id + i) % thread_amount], head,
+                                       __ATOMIC_ACQ_REL);
+        if (head != NULL) list_free(head);
+
+        for (size_t j = 0; j < 4; j++)
+        {
+            darray_t da = darray_new(sizeof(int));
+            darray_free(da);
+        }
+    }
+
+    return NULL;
+}
+
+
+static double
+run(int enabled)
+{
+    pthread_t       threads[MAX_THREADS];
+    struct timespec start, end;
+
+    tcache_set_enabled(enabled);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (uintptr_t i = 0; i < thread_amount; i++)
+        pthread_create(&threads[i], NULL, churn, (void *)i);
+    for (size_t i = 0; i < thread_amount; i++) pthread_join(threads[i], NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    for (size_t i = 0; i < thread_amount; i++)
+    {
+        if (slots[i] != NULL) list_free(slots[i]);
+        slots[i] = NULL;
+    }
+
+    tcache_flush();
+    tcache_trim();
+
+    double ns = ((double)(end.tv_sec - start.tv_sec) * 1e9)
+              + (double)(end.tv_nsec - start.tv_nsec);
+    return ns / (double)(thread_amount * round_amount * (LIST_NODES + 4));
+}
+
+
+int
+main(int argc, char **argv)
+{
+    if (argc > 1) thread_amount = strtoul(argv[1], NULL, 10);
+    if (argc > 2) round_amount = strtoul(argv[2], NULL, 10);
+    if (thread_amount == 0 || thread_amount > MAX_THREADS) thread_amount = 4;
+
+    double off = run(0);
+    double on  = run(1);
+
+    printf("%zu threads, %zu rounds\n", thread_amount, round_amount);
+    printf("system allocator: %6.1f ns per object\n", off);
+    printf("thread cache:     %6.1f ns per object\n", on);
+    return 0;
+}
@@ -22,6 +22,26 @@
 #ifndef _DS_H
 #define _DS_H 1
 
+#include <ds/arena.h>
+#include <ds/art.h>
+#include <ds/bitset.h>
+#include <ds/bloom.h>
+#include <ds/btree.h>
+#include <ds/buffer.h>
+#include <ds/clist.h>
+#include <ds/cmap.h>
+#include <ds/csr.h>
 #include <ds/darray.h>
+#include <ds/fenwick.h>
+#include <ds/heap.h>
+#include <ds/lru.h>
+#include <ds/packed.h>
+#include <ds/prof.h>
+#include <ds/reduce.h>
+#include <ds/segtree.h>
+#include <ds/slotmap.h>
+#include <ds/soa.h>
+#include <ds/sparse.h>
+#include <ds/tcache.h>
 
 #endif /* _DS_H */
@@ -0,0 +1,912 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the C++ wrappers `ds::darray` and `ds::list`, typed
+ * views over the `darray_t` and `list_t` handles of the C interface.
+ *
+ * Element access is inlined against the handle's layout instead of going
+ * through the type-erased functions, and the size of the element is known
+ * at compile time. Elements that are not trivially copyable are moved,
+ * never `memcpy`-ed, when the buffer grows or an element is inserted.
+ */
+
+#ifndef _DS_HPP
+#define _DS_HPP 1
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <ds/darray.h>
+#include <ds/list.h>
+
+#include "ds/__priv/darray.h"
+#include "ds/__priv/list.h"
+
+
+namespace ds
+{
+/**
+ * @class darray
+ *
+ * @brief An owning, typed wrapper of a @struct dyn_array holding `T`.
+ *
+ * The iterators are plain pointers into the internal buffer, and the
+ * buffer is the one C code sees through ::handle, so both sides can work
+ * on the same elements without copying.
+ *
+ * @warning Snapshots, see ::darray_snapshot, copy elements byte by byte,
+ *          so they must not be taken of a `T` that is not trivially
+ *          copyable.
+ * @warning A moved-from wrapper holds no handle, and may only be assigned
+ *          to or destroyed.
+ */
+template <typename T> class darray
+{
+public:
+    typedef T                                     value_type;
+    typedef std::size_t                           size_type;
+    typedef std::ptrdiff_t                        difference_type;
+    typedef T                                    &reference;
+    typedef const T                              &const_reference;
+    typedef T                                    *pointer;
+    typedef const T                              *const_pointer;
+    typedef T                                    *iterator;
+    typedef const T                              *const_iterator;
+    typedef std::reverse_iterator<iterator>       reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+
+    darray() : m_handle(darray_new(sizeof(T)))
+    {
+        if (m_handle == NULL) throw std::bad_alloc();
+    }
+
+
+    /**
+     * @brief Takes the ownership of a @struct dyn_array created by C code.
+     *
+     * @warning The type size of @param handle must be `sizeof(T)`.
+     */
+    explicit darray(darray_t handle) noexcept : m_handle(handle) {}
+
+
+    darray(const darray &other) : darray()
+    {
+        reserve(other.size());
+        for (const T &value : other) push_back(value);
+    }
+
+
+    darray(darray &&other) noexcept : m_handle(other.m_handle)
+    {
+        other.m_handle = NULL;
+    }
+
+
+    darray &
+    operator=(darray other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+
+    ~darray()
+    {
+        if (m_handle == NULL) return;
+
+        destroy(begin(), end());
+        darray_free_full(m_handle);
+    }
+
+
+    /**
+     * @brief Get the @struct dyn_array the wrapper owns.
+     */
+    darray_t
+    handle() const noexcept
+    {
+        return m_handle;
+    }
+
+
+    /**
+     * @brief Gives up the ownership of the @struct dyn_array , which the
+     *        caller must free.
+     */
+    darray_t
+    release() noexcept
+    {
+        darray_t handle = m_handle;
+        m_handle        = NULL;
+        return handle;
+    }
+
+
+    void
+    swap(darray &other) noexcept
+    {
+        std::swap(m_handle, other.m_handle);
+    }
+
+
+    size_type
+    size() const noexcept
+    {
+        return m_handle->elem_amount;
+    }
+
+
+    size_type
+    capacity() const noexcept
+    {
+        return m_handle->alloc_size;
+    }
+
+
+    bool
+    empty() const noexcept
+    {
+        return m_handle->elem_amount == 0;
+    }
+
+
+    T *
+    data() noexcept
+    {
+        return static_cast<T *>(m_handle->data);
+    }
+
+
+    const T *
+    data() const noexcept
+    {
+        return static_cast<const T *>(m_handle->data);
+    }
+
+
+    iterator
+    begin() noexcept
+    {
+        return data();
+    }
+
+
+    const_iterator
+    begin() const noexcept
+    {
+        return data();
+    }
+
+
+    iterator
+    end() noexcept
+    {
+        return data() + size();
+    }
+
+
+    const_iterator
+    end() const noexcept
+    {
+        return data() + size();
+    }
+
+
+    reverse_iterator
+    rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+
+
+    reverse_iterator
+    rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+
+
+    T &
+    operator[](size_type index) noexcept
+    {
+        return data()[index];
+    }
+
+
+    const T &
+    operator[](size_type index) const noexcept
+    {
+        return data()[index];
+    }
+
+
+    /**
+     * @brief Gets the element at @param index , with bounds checking.
+     *
+     * @throw std::out_of_range if @param index is past the last element.
+     */
+    T &
+    at(size_type index)
+    {
+        if (index >= size()) throw std::out_of_range("ds::darray::at");
+        return data()[index];
+    }
+
+
+    const T &
+    at(size_type index) const
+    {
+        if (index >= size()) throw std::out_of_range("ds::darray::at");
+        return data()[index];
+    }
+
+
+    T &
+    front() noexcept
+    {
+        return data()[0];
+    }
+
+
+    T &
+    back() noexcept
+    {
+        return data()[size() - 1];
+    }
+
+
+    /**
+     * @brief Ensures the buffer can hold @param amount elements.
+     *
+     * @throw std::bad_alloc if the buffer could not be grown.
+     */
+    void
+    reserve(size_type amount)
+    {
+        if (amount > capacity()) grow(amount);
+    }
+
+
+    /**
+     * @brief Resizes to @param amount elements, value-initializing the new
+     *        ones.
+     */
+    void
+    resize(size_type amount)
+    {
+        if (amount <= size())
+        {
+            destroy(begin() + amount, end());
+            m_handle->elem_amount = amount;
+        }
+        else if (trivial)
+        {
+            /* zero-filled by the C side, which is value-initialization */
+            if (darray_resize(m_handle, amount) == NULL)
+                throw std::bad_alloc();
+        }
+        else
+        {
+            reserve(amount);
+            while (size() < amount)
+            {
+                ::new (static_cast<void *>(end())) T();
+                m_handle->elem_amount++;
+            }
+        }
+    }
+
+
+    void
+    clear() noexcept
+    {
+        destroy(begin(), end());
+        darray_clear(m_handle);
+    }
+
+
+    void
+    push_back(const T &value)
+    {
+        emplace_back(value);
+    }
+
+
+    void
+    push_back(T &&value)
+    {
+        emplace_back(std::move(value));
+    }
+
+
+    /**
+     * @brief Constructs an element at the back in place.
+     *
+     * Appending into spare capacity is a store and an increment. Growing,
+     * or writing over elements a snapshot still sees, is left to the C side.
+     *
+     * @throw std::bad_alloc if the buffer could not be grown.
+     */
+    template <typename... Args>
+    T &
+    emplace_back(Args &&...args)
+    {
+        if (size() < capacity() && size() >= m_handle->shared_size)
+        {
+            T *slot = ::new (static_cast<void *>(end()))
+                T(std::forward<Args>(args)...);
+            m_handle->elem_amount++;
+            return *slot;
+        }
+
+        /* @param args may refer to an element that is about to move */
+        T value(std::forward<Args>(args)...);
+
+        if (trivial)
+        {
+            if (darray_push_back(m_handle, &value) == NULL)
+                throw std::bad_alloc();
+        }
+        else
+        {
+            grow(next_capacity(size() + 1));
+            ::new (static_cast<void *>(end())) T(std::move(value));
+            m_handle->elem_amount++;
+        }
+
+        return back();
+    }
+
+
+    void
+    pop_back() noexcept
+    {
+        back().~T();
+        m_handle->elem_amount--;
+    }
+
+
+    /**
+     * @brief Inserts @param value before @param pos .
+     *
+     * @return An iterator to the inserted element.
+     */
+    iterator
+    insert(const_iterator pos, T value)
+    {
+        size_type index = static_cast<size_type>(pos - begin());
+
+        if (trivial)
+        {
+            if (darray_insert(m_handle, &value, index) == NULL)
+                throw std::bad_alloc();
+        }
+        else
+        {
+            emplace_back(std::move(value));
+            std::rotate(begin() + index, end() - 1, end());
+        }
+
+        return begin() + index;
+    }
+
+
+    /**
+     * @brief Erases the element at @param pos .
+     *
+     * @return An iterator to the element that followed the erased one.
+     */
+    iterator
+    erase(const_iterator pos)
+    {
+        size_type index = static_cast<size_type>(pos - begin());
+
+        if (trivial)
+        {
+            if (darray_erase(m_handle, index) == NULL) throw std::bad_alloc();
+        }
+        else
+        {
+            std::move(begin() + index + 1, end(), begin() + index);
+            pop_back();
+        }
+
+        return begin() + index;
+    }
+
+
+private:
+    static const bool trivial = std::is_trivially_copyable<T>::value;
+
+    darray_t m_handle;
+
+
+    static void
+    destroy(T *first, T *last) noexcept
+    {
+        if (!trivial)
+            for (; first != last; ++first) first->~T();
+    }
+
+
+    /* the growth policy of ::darray_insert */
+    size_type
+    next_capacity(size_type amount) const noexcept
+    {
+        size_type grown = capacity() == 0 ? 5 : capacity() + (capacity() >> 1);
+        return grown > amount ? grown : amount;
+    }
+
+
+    /*
+     * Trivially copyable elements are grown by the C side, which may
+     * `realloc` them in place. Other elements are moved into a new buffer
+     * from the allocator of the handle, falling back to copies if moving
+     * could throw, so a failure leaves the old buffer untouched.
+     */
+    void
+    grow(size_type amount)
+    {
+        if (trivial)
+        {
+            if (darray_reserve(m_handle, amount) == NULL)
+                throw std::bad_alloc();
+            return;
+        }
+
+        if (amount > static_cast<size_type>(-1) / sizeof(T))
+            throw std::bad_alloc();
+
+        std::size_t bytes = amount * sizeof(T);
+        T *buffer = static_cast<T *>(m_handle->realloc_fn != NULL
+                                         ? m_handle->realloc_fn(NULL, bytes)
+                                         : std::malloc(bytes));
+        if (buffer == NULL) throw std::bad_alloc();
+
+        size_type moved = 0;
+        try
+        {
+            for (; moved < size(); moved++)
+                ::new (static_cast<void *>(buffer + moved))
+                    T(std::move_if_noexcept(data()[moved]));
+        }
+        catch (...)
+        {
+            destroy(buffer, buffer + moved);
+            release_buffer(buffer);
+            throw;
+        }
+
+        destroy(begin(), end());
+        if (m_handle->data != NULL) release_buffer(m_handle->data);
+
+        m_handle->data       = buffer;
+        m_handle->alloc_size = amount;
+    }
+
+
+    void
+    release_buffer(void *buffer) noexcept
+    {
+        if (m_handle->free_fn != NULL)
+            m_handle->free_fn(buffer);
+        else
+            std::free(buffer);
+    }
+};
+
+
+/**
+ * @class list
+ *
+ * @brief An owning, typed wrapper of a @struct linked_list whose nodes
+ *        point to a `T` each.
+ *
+ * The nodes are ordinary @struct linked_list nodes, so ::handle can be
+ * walked by C code with ::list_next and ::list_data . Linking, unlinking
+ * and iterating are inlined, only node allocation goes through the C side.
+ *
+ * @warning A moved-from wrapper is empty.
+ */
+template <typename T> class list
+{
+public:
+    typedef T           value_type;
+    typedef std::size_t size_type;
+    typedef T          &reference;
+    typedef const T    &const_reference;
+
+
+    template <typename V> class basic_iterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef V                               value_type;
+        typedef std::ptrdiff_t                  difference_type;
+        typedef V                              *pointer;
+        typedef V                              &reference;
+
+
+        basic_iterator() noexcept : m_node(NULL), m_tail(NULL) {}
+
+
+        basic_iterator(list_t node, const list_t *tail) noexcept
+            : m_node(node), m_tail(tail)
+        {
+        }
+
+
+        /* an iterator converts to a const_iterator */
+        template <typename U, typename = typename std::enable_if<
+                                  std::is_same<const U, V>::value>::type>
+        basic_iterator(const basic_iterator<U> &other) noexcept
+            : m_node(other.m_node), m_tail(other.m_tail)
+        {
+        }
+
+
+        V &
+        operator*() const noexcept
+        {
+            return *static_cast<V *>(m_node->data);
+        }
+
+
+        V *
+        operator->() const noexcept
+        {
+            return static_cast<V *>(m_node->data);
+        }
+
+
+        basic_iterator &
+        operator++() noexcept
+        {
+            m_node = m_node->next;
+            return *this;
+        }
+
+
+        basic_iterator
+        operator++(int) noexcept
+        {
+            basic_iterator old = *this;
+            m_node             = m_node->next;
+            return old;
+        }
+
+
+        /* the end iterator steps back onto the tail */
+        basic_iterator &
+        operator--() noexcept
+        {
+            m_node = m_node != NULL ? m_node->prev : *m_tail;
+            return *this;
+        }
+
+
+        basic_iterator
+        operator--(int) noexcept
+        {
+            basic_iterator old = *this;
+            --*this;
+            return old;
+        }
+
+
+        bool
+        operator==(const basic_iterator &other) const noexcept
+        {
+            return m_node == other.m_node;
+        }
+
+
+        bool
+        operator!=(const basic_iterator &other) const noexcept
+        {
+            return m_node != other.m_node;
+        }
+
+
+        /**
+         * @brief Get the node the iterator points to, `NULL` at the end.
+         */
+        list_t
+        node() const noexcept
+        {
+            return m_node;
+        }
+
+
+    private:
+        template <typename> friend class basic_iterator;
+
+        list_t        m_node;
+        const list_t *m_tail;
+    };
+
+
+    typedef basic_iterator<T>       iterator;
+    typedef basic_iterator<const T> const_iterator;
+
+
+    list() noexcept : m_head(NULL), m_tail(NULL), m_size(0) {}
+
+
+    list(const list &other) : list()
+    {
+        for (const T &value : other) push_back(value);
+    }
+
+
+    list(list &&other) noexcept
+        : m_head(other.m_head), m_tail(other.m_tail), m_size(other.m_size)
+    {
+        other.m_head = NULL;
+        other.m_tail = NULL;
+        other.m_size = 0;
+    }
+
+
+    list &
+    operator=(list other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+
+    ~list()
+    {
+        clear();
+    }
+
+
+    /**
+     * @brief Get the head node, or `NULL` if the list is empty.
+     *
+     * @warning The data of the nodes is owned by the wrapper, C code must
+     *          not free or replace it.
+     */
+    list_t
+    handle() const noexcept
+    {
+        return m_head;
+    }
+
+
+    void
+    swap(list &other) noexcept
+    {
+        std::swap(m_head, other.m_head);
+        std::swap(m_tail, other.m_tail);
+        std::swap(m_size, other.m_size);
+    }
+
+
+    size_type
+    size() const noexcept
+    {
+        return m_size;
+    }
+
+
+    bool
+    empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+
+    iterator
+    begin() noexcept
+    {
+        return iterator(m_head, &m_tail);
+    }
+
+
+    const_iterator
+    begin() const noexcept
+    {
+        return const_iterator(m_head, &m_tail);
+    }
+
+
+    iterator
+    end() noexcept
+    {
+        return iterator(NULL, &m_tail);
+    }
+
+
+    const_iterator
+    end() const noexcept
+    {
+        return const_iterator(NULL, &m_tail);
+    }
+
+
+    T &
+    front() noexcept
+    {
+        return *static_cast<T *>(m_head->data);
+    }
+
+
+    T &
+    back() noexcept
+    {
+        return *static_cast<T *>(m_tail->data);
+    }
+
+
+    void
+    push_back(T value)
+    {
+        emplace(end(), std::move(value));
+    }
+
+
+    void
+    push_front(T value)
+    {
+        emplace(begin(), std::move(value));
+    }
+
+
+    void
+    pop_back() noexcept
+    {
+        erase(iterator(m_tail, &m_tail));
+    }
+
+
+    void
+    pop_front() noexcept
+    {
+        erase(begin());
+    }
+
+
+    /**
+     * @brief Constructs an element in a new node before @param pos .
+     *
+     * @throw std::bad_alloc if the node could not be allocated.
+     */
+    template <typename... Args>
+    iterator
+    emplace(const_iterator pos, Args &&...args)
+    {
+        list_t node = list_new();
+        if (node == NULL) throw std::bad_alloc();
+
+        try
+        {
+            node->data = new T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            list_free_node(node);
+            throw;
+        }
+
+        list_t next = pos.node();
+        list_t prev = next != NULL ? next->prev : m_tail;
+
+        node->prev = prev;
+        node->next = next;
+        (prev != NULL ? prev->next : m_head) = node;
+        (next != NULL ? next->prev : m_tail) = node;
+
+        m_size++;
+        return iterator(node, &m_tail);
+    }
+
+
+    iterator
+    insert(const_iterator pos, T value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+
+    /**
+     * @brief Erases the element at @param pos .
+     *
+     * @return An iterator to the element that followed the erased one.
+     */
+    iterator
+    erase(const_iterator pos) noexcept
+    {
+        list_t node = pos.node();
+        list_t next = node->next;
+
+        (node->prev != NULL ? node->prev->next : m_head) = next;
+        (next != NULL ? next->prev : m_tail)             = node->prev;
+
+        delete static_cast<T *>(node->data);
+
+        /* a detached node is freed without walking to its head */
+        node->prev = NULL;
+        node->next = NULL;
+        list_free_node(node);
+
+        m_size--;
+        return iterator(next, &m_tail);
+    }
+
+
+    void
+    clear() noexcept
+    {
+        if (m_head == NULL) return;
+
+        for (list_t node = m_head; node != NULL; node = node->next)
+            delete static_cast<T *>(node->data);
+
+        list_free(m_head);
+        m_head = NULL;
+        m_tail = NULL;
+        m_size = 0;
+    }
+
+
+    /**
+     * @brief Sorts the elements with `operator<` through ::list_sort ,
+     *        keeping equal elements in order and relinking, not moving,
+     *        them.
+     */
+    void
+    sort()
+    {
+        if (m_size < 2) return;
+
+        m_head = list_sort(m_head, compare);
+
+        m_tail = m_head;
+        while (m_tail->next != NULL) m_tail = m_tail->next;
+    }
+
+
+private:
+    list_t    m_head;
+    list_t    m_tail;
+    size_type m_size;
+
+
+    static int
+    compare(const void *a, const void *b)
+    {
+        const T &lhs = *static_cast<const T *>(a);
+        const T &rhs = *static_cast<const T *>(b);
+
+        return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+    }
+};
+} /* namespace ds */
+
+
+#endif /* _DS_HPP */
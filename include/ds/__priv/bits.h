@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * This file contains the word-level bit manipulation helpers shared by the
+ * libds data structures.
+ */
+
+#ifndef __DS_PRIV_BITS_H
+#define __DS_PRIV_BITS_H 1
+#include <stdint.h>
+
+
+/**
+ * @brief Counts the set bits of @param x .
+ */
+static inline unsigned
+ds_popcount64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (unsigned)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+
+/**
+ * @brief Counts the trailing zero bits of @param x .
+ *
+ * @warning The result is undefined if @param x is 0.
+ */
+static inline unsigned
+ds_ctz64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(x);
+#else
+    return ds_popcount64((x & -x) - 1);
+#endif
+}
+
+
+/**
+ * @brief Counts the leading zero bits of @param x .
+ *
+ * @warning The result is undefined if @param x is 0.
+ */
+static inline unsigned
+ds_clz64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_clzll(x);
+#else
+    unsigned n = 0;
+    while (!(x & 0x8000000000000000ULL))
+    {
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+
+/**
+ * @brief Get the high 64 bits of the 128-bit product of @param a and @param b .
+ */
+static inline uint64_t
+ds_mulhi64(uint64_t a, uint64_t b)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __extension__ typedef unsigned __int128 ds_u128;
+    return (uint64_t)(((ds_u128)a * b) >> 64);
+#else
+    const uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    const uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+
+    const uint64_t lo  = a_lo * b_lo;
+    const uint64_t mid = (a_hi * b_lo) + (lo >> 32);
+    const uint64_t alt = (a_lo * b_hi) + (uint32_t)mid;
+
+    return (a_hi * b_hi) + (mid >> 32) + (alt >> 32);
+#endif
+}
+
+
+#endif /* __DS_PRIV_BITS_H */
@@ -29,10 +29,16 @@
 #endif
 #define __DS_BEGIN_DECLS extern "C" {
 #define __DS_END_DECLS	 }
+#if defined(__GNUC__) || defined(__clang__)
+#define __DS_RESTRICT __restrict
+#else
+#define __DS_RESTRICT
+#endif
 #else
 #define __DS_BEGIN_DECLS
 #define __DS_END_DECLS
 #define __DS_THROW
+#define __DS_RESTRICT restrict
 #endif
 
 #if defined(__GNUC__) || defined(__clang__)
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the runtime CPU feature checks used to pick between
+ * kernels compiled for the baseline and for wider instruction sets.
+ */
+
+#ifndef __DS_PRIV_CPU_H
+#define __DS_PRIV_CPU_H 1
+
+
+#if (defined(__x86_64__) || defined(__i386__)) \
+    && (defined(__GNUC__) || defined(__clang__))
+#define DS_CPU_X86 1
+
+
+/**
+ * @brief Checks whether the CPU runs AVX2 code, POPCNT included.
+ *
+ * @note The check is not free, callers cache its result.
+ */
+static inline int
+ds_cpu_avx2(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+}
+#endif
+
+
+#endif /* __DS_PRIV_CPU_H */
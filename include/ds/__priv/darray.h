@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * This file contains the layout of `struct dyn_array`, shared with the
+ * inlined accessors of ds.hpp.
+ */
+
+#ifndef __DS_PRIV_DARRAY_H
+#define __DS_PRIV_DARRAY_H 1
+#define __need_size_t 1
+#include <stddef.h>
+
+#include "ds/__priv/cdefs.h"
+
+
+struct darray_buffer;
+struct darray_snapshot;
+
+
+struct dyn_array
+{
+    void *data;
+
+    size_t tp_size;
+    size_t alloc_size;
+    size_t elem_amount;
+
+    ds_realloc_fn realloc_fn;
+    ds_free_fn    free_fn;
+
+    /* set while snapshots may see the first `shared_size` elements */
+    struct darray_buffer *shared;
+    size_t                shared_size;
+
+    /* readers count themselves in the half picked by the phase they saw */
+    struct darray_snapshot *published;
+    struct darray_snapshot *retired[2];
+    size_t                  acquiring[2];
+    size_t                  phase;
+};
+
+
+#endif /* __DS_PRIV_DARRAY_H */
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the byte string hash shared by the hashing libds
+ * data structures.
+ */
+
+#ifndef __DS_PRIV_HASH_H
+#define __DS_PRIV_HASH_H 1
+#define __need_size_t 1
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+
+/**
+ * @brief Hashes @param len bytes into 64 well mixed bits.
+ */
+static inline uint64_t
+ds_hash_bytes(const void *key, size_t len)
+{
+    const unsigned char *bytes = key;
+    uint64_t             hash  = 0x9e3779b97f4a7c15U;
+
+    hash ^= (uint64_t)len * 0xff51afd7ed558ccdU;
+
+    while (len > 0)
+    {
+        uint64_t word = 0;
+        size_t   take = len < 8 ? len : 8;
+
+        memcpy(&word, bytes, take);
+        bytes += take;
+        len   -= take;
+
+        word *= 0xbf58476d1ce4e5b9U;
+        word ^= word >> 31;
+        hash  = (hash ^ word) * 0x94d049bb133111ebU;
+        hash  = (hash << 27) | (hash >> 37);
+    }
+
+    /* the splitmix64 finalizer, so both halves of the hash are mixed */
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9U;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebU;
+    return hash ^ (hash >> 31);
+}
+
+
+#endif /* __DS_PRIV_HASH_H */
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * This file contains the layout of `struct linked_list`, shared with the
+ * inlined accessors of ds.hpp.
+ */
+
+#ifndef __DS_PRIV_LIST_H
+#define __DS_PRIV_LIST_H 1
+
+#include "ds/__priv/cdefs.h"
+
+
+/* the allocation ::list_compact moves the nodes of a list into */
+struct list_block
+{
+    /* the nodes inside the block that were not freed yet */
+    size_t refs;
+
+    ds_free_fn free_fn;
+};
+
+
+struct linked_list
+{
+    struct linked_list *prev;
+    struct linked_list *next;
+
+    void *data;
+
+    ds_malloc_fn malloc_fn;
+    ds_free_fn   free_fn;
+
+    /* the block the node lives in, or `NULL` if allocated on its own */
+    struct list_block *block;
+};
+
+
+#endif /* __DS_PRIV_LIST_H */
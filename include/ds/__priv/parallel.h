@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the helper splitting work between threads, shared by
+ * the parallel paths of the libds data structures. Its includers define
+ * `_POSIX_C_SOURCE` first.
+ */
+
+#ifndef __DS_PRIV_PARALLEL_H
+#define __DS_PRIV_PARALLEL_H 1
+#define __need_size_t 1
+#include <stddef.h>
+
+#include <pthread.h>
+
+/* the most jobs a single call runs */
+#define DS_PARALLEL_MAX 64
+
+
+/**
+ * @brief Runs @param fn on each of the @param count jobs of
+ *        @param job_size bytes at @param jobs , every job but the first on
+ *        a thread of its own, and waits for all of them.
+ *
+ * A job whose thread could not be started runs on the calling thread
+ * instead, so every job always runs.
+ */
+static inline void
+ds_parallel_run(void *(*fn)(void *), void *jobs, size_t job_size,
+                size_t count)
+{
+    unsigned char *at = jobs;
+    pthread_t      tids[DS_PARALLEL_MAX];
+    int            started[DS_PARALLEL_MAX];
+
+    for (size_t i = 1; i < count; i++)
+    {
+        started[i] = pthread_create(&tids[i], NULL, fn, at + (i * job_size))
+                  == 0;
+        if (!started[i]) fn(at + (i * job_size));
+    }
+
+    if (count > 0) fn(at);
+
+    for (size_t i = 1; i < count; i++)
+        if (started[i]) pthread_join(tids[i], NULL);
+}
+
+
+#endif /* __DS_PRIV_PARALLEL_H */
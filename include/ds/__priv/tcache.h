@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the allocation functions behind ds/tcache.h, used by
+ * the libds data structures for their small internal objects.
+ */
+
+#ifndef __DS_PRIV_TCACHE_H
+#define __DS_PRIV_TCACHE_H 1
+#define __need_size_t 1
+#include <stddef.h>
+
+
+/**
+ * @brief Allocates @param size bytes, from the calling thread's cache if it
+ *        is enabled and @param size is cached.
+ *
+ * @warning The memory must be freed with ::ds_tcache_free and the same
+ *          @param size , or with `free`.
+ */
+extern void *ds_tcache_malloc(size_t size);
+
+
+/**
+ * @brief Frees memory of @param size bytes allocated by ::ds_tcache_malloc
+ *        or `malloc`, into the calling thread's cache if it is enabled.
+ */
+extern void ds_tcache_free(void *ptr, size_t size);
+
+
+#endif /* __DS_PRIV_TCACHE_H */
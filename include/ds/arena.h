@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the declaration of the region allocator `arena`,
+ * alongside with the functions that manipulates it and the allocator
+ * functions that plug it into the other libds containers.
+ */
+
+#ifndef _DS_ARENA_H
+#define _DS_ARENA_H 1
+#define __need_size_t 1
+#include <stddef.h>
+
+#include "ds/__priv/cdefs.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef arena_t
+ * @struct arena
+ *
+ * @brief A region allocator handing out memory by bumping a pointer through
+ *        a chain of chunks.
+ *
+ * Nothing is freed one allocation at a time: the whole region is reset or
+ * rewound to a mark at once, and the chunks are kept for the allocations
+ * that follow. Only the most recent allocation can grow, shrink or be
+ * freed in place.
+ *
+ * An @struct arena is not thread-safe.
+ */
+typedef struct arena *arena_t;
+
+
+/**
+ * @typedef arena_mark_t
+ *
+ * @brief A position inside an @struct arena , taken by ::mark and returned
+ *        to by ::rewind.
+ */
+typedef struct arena_mark
+{
+    void  *chunk;
+    size_t used;
+} arena_mark_t;
+
+
+/**
+ * @brief Allocate a new @struct arena with a custom allocator for its
+ *        chunks.
+ *
+ * @param chunk_size The size of every chunk, or 0 for the default of
+ *                   64 KiB. Larger allocations get a chunk of their own.
+ *
+ * @return A pointer to the allocated @struct arena , or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern arena_t arena_new_with_allocator(size_t chunk_size,
+                                        ds_malloc_fn malloc_fn,
+                                        ds_free_fn free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct arena .
+ *
+ * @param chunk_size The size of every chunk, or 0 for the default of
+ *                   64 KiB. Larger allocations get a chunk of their own.
+ *
+ * @return A pointer to the allocated @struct arena , or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern arena_t arena_new(size_t chunk_size)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct arena and every chunk it holds.
+ *
+ * @note If the @struct arena is used by the calling thread, the thread is
+ *       left without one.
+ *
+ * @sa ::new
+ */
+extern void arena_free(arena_t arena) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Allocates @param size bytes from a @struct arena , aligned to 16
+ *        bytes.
+ *
+ * @return A pointer to the allocated memory, or `NULL` on failure. Check
+ *         `errno` for more information.
+ *
+ * @sa ::realloc
+ * @sa ::dealloc
+ */
+extern void *arena_alloc(arena_t arena, size_t size)
+    __DS_ATTR_MALLOC __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Frees every allocation of a @struct arena at once, keeping its
+ *        chunks for the allocations that follow.
+ *
+ * @warning Every pointer allocated from the @struct arena is invalidated,
+ *          containers allocated from it must not be freed afterwards.
+ *
+ * @sa ::trim
+ */
+extern void arena_reset(arena_t arena) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Frees the chunks of a @struct arena past the one in use.
+ *
+ * @sa ::reset
+ */
+extern void arena_trim(arena_t arena) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Takes the current position of a @struct arena .
+ *
+ * @sa ::rewind
+ */
+extern arena_mark_t arena_mark(arena_t arena)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees every allocation of a @struct arena made since @param mark
+ *        was taken.
+ *
+ * @warning @param mark must have been taken from the same @struct arena ,
+ *          and not have been freed by an earlier ::reset or ::rewind.
+ *
+ * @sa ::mark
+ */
+extern void arena_rewind(arena_t arena, arena_mark_t mark)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Get the amount of bytes held by the chunks of a @struct arena .
+ */
+extern size_t arena_size(arena_t arena)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/*
+ * The allocator functions below let any libds container allocate from an
+ * arena, through its `_new_with_allocator` function. They take no arena, so
+ * new memory comes from the arena the calling thread uses, set through
+ * ::use. Memory that was already allocated is resized and freed inside the
+ * arena it came from, whichever arena the thread uses at the time.
+ *
+ *     arena_use(request_arena);
+ *     darray_t da = darray_new_with_allocator(sizeof(int), arena_malloc,
+ *                                             arena_realloc, arena_dealloc);
+ *     ...
+ *     arena_reset(request_arena);
+ */
+
+
+/**
+ * @brief Sets the @struct arena the calling thread allocates from, or
+ *        `NULL` for none.
+ *
+ * @return The @struct arena the thread used before.
+ */
+extern arena_t arena_use(arena_t arena);
+
+
+/**
+ * @brief Get the @struct arena the calling thread allocates from.
+ */
+extern arena_t arena_current(void) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocates @param size bytes from the @struct arena of the calling
+ *        thread, as a ::ds_malloc_fn.
+ *
+ * @return A pointer to the allocated memory, or `NULL` and set `errno` to
+ *         EINVAL if the thread uses no @struct arena , or ENOMEM if the
+ *         memory could not be allocated.
+ */
+extern void *arena_malloc(size_t size) __DS_ATTR_MALLOC;
+
+
+/**
+ * @brief Resizes memory allocated from an @struct arena , as a
+ *        ::ds_realloc_fn.
+ *
+ * The most recent allocation of its @struct arena is resized in place when
+ * its chunk has room. Other allocations keep their memory when shrunk, and
+ * are copied into a new allocation when grown.
+ *
+ * @param ptr The memory to resize, or `NULL` to allocate like
+ *            ::arena_malloc.
+ *
+ * @return A pointer to the resized memory, or `NULL` on failure, leaving
+ *         @param ptr untouched. Check `errno` for more information.
+ */
+extern void *arena_realloc(void *ptr, size_t size);
+
+
+/**
+ * @brief Frees memory allocated from an @struct arena , as a ::ds_free_fn.
+ *
+ * Only the most recent allocation of its @struct arena is given back, any
+ * other allocation stays in use until the arena is reset or rewound.
+ *
+ * @param ptr The memory to free, can be `NULL`.
+ */
+extern void arena_dealloc(void *ptr);
+
+
+__DS_END_DECLS
+
+#endif /* _DS_ARENA_H */
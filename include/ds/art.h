@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * This file contains the declaration of the adaptive radix tree
+ * `radix_tree`, alongside with the functions that manipulates it.
+ */
+
+#ifndef _DS_ART_H
+#define _DS_ART_H 1
+#define __need_size_t 1
+#include <stddef.h>
+
+#include "ds/__priv/cdefs.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef art_t
+ * @struct radix_tree
+ *
+ * @brief An adaptive radix tree mapping byte string keys to pointers.
+ *
+ * Every inner node branches on a single byte of the key and grows from
+ * 4 to 16, 48 and 256 children as needed, while chains of single-child
+ * nodes are collapsed into a prefix. A lookup costs O(key length) no matter
+ * how many keys are stored, and keys sharing a prefix share its memory.
+ *
+ * Any key can be a prefix of another key, keys do not need a terminator.
+ */
+typedef struct radix_tree *art_t;
+
+
+/**
+ * @typedef art_iter_fn
+ *
+ * @brief The function signature called for every key visited by
+ *        ::foreach_prefix.
+ *
+ * @param data The pointer passed to ::foreach_prefix.
+ *
+ * @return 0 to continue the iteration, or any other value to stop it.
+ */
+typedef int (*art_iter_fn)(const void *key, size_t len, void *value,
+                           void *data);
+
+
+/**
+ * @brief Allocate a new @struct radix_tree with a custom allocator.
+ *
+ * @return A pointer to the allocated @struct radix_tree , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern art_t art_new_with_allocator(ds_malloc_fn malloc_fn, ds_free_fn free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct radix_tree .
+ *
+ * @return A pointer to the allocated @struct radix_tree , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern art_t art_new(void) __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct radix_tree and all of its nodes.
+ *
+ * @warning The function does not free the stored values.
+ *
+ * @sa ::new
+ */
+extern void art_free(art_t art) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Inserts a key and its value into a @struct radix_tree .
+ *
+ * @param key The key, which is copied.
+ * @param len The length of @param key in bytes.
+ *
+ * @return 0 on success, or -1 on failure. `errno` is set to EEXIST if
+ *         @param key is already inside the @struct radix_tree .
+ *
+ * @sa ::erase
+ */
+extern int art_insert(art_t art, const void *key, size_t len, void *value)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Finds the value of a key.
+ *
+ * @return A pointer to the stored value, or `NULL` if @param key is not
+ *         inside the @struct radix_tree .
+ *
+ * @warning The pointer is invalidated by ::erase.
+ */
+extern void **art_find(art_t art, const void *key, size_t len)
+    __DS_ATTR_NONNULL(1, 2) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Erases a key from a @struct radix_tree .
+ *
+ * @return 0 on success, or -1 and `errno` set to ENOENT if @param key is
+ *         not inside the @struct radix_tree .
+ *
+ * @warning The function does not free the value.
+ *
+ * @sa ::insert
+ */
+extern int art_erase(art_t art, const void *key, size_t len)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Calls a function on every key starting with @param prefix , in
+ *        lexicographic order.
+ *
+ * @param len The length of @param prefix , 0 to visit every key.
+ * @param fn  The function called for every key.
+ *
+ * @return 0 if every key was visited, or the non-zero value @param fn
+ *         stopped the iteration with.
+ *
+ * @warning The @struct radix_tree must not be modified by @param fn .
+ */
+extern int art_foreach_prefix(art_t art, const void *prefix, size_t len,
+                              art_iter_fn fn, void *data)
+    __DS_ATTR_NONNULL(1, 2, 4);
+
+
+/**
+ * @brief Finds the longest key inside a @struct radix_tree that is a prefix
+ *        of @param key .
+ *
+ * @param match_len Where the length of the found key is stored, can be
+ *                  `NULL`.
+ *
+ * @return A pointer to the value of the found key, or `NULL` if no key is
+ *         a prefix of @param key .
+ */
+extern void **art_longest_prefix(art_t art, const void *key, size_t len,
+                                 size_t *match_len)
+    __DS_ATTR_NONNULL(1, 2) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of keys inside a @struct radix_tree .
+ */
+extern size_t art_size(art_t art)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_ART_H */
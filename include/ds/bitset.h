@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * This file contains the declaration of the dynamically sized bitset
+ * structure `bit_set`, alongside with the functions that manipulates it.
+ */
+
+#ifndef _DS_BITSET_H
+#define _DS_BITSET_H 1
+#define __need_size_t 1
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ds/__priv/cdefs.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef bitset_t
+ * @struct bit_set
+ *
+ * @brief A dynamically sized bitset, stored as an array of 64-bit words.
+ */
+typedef struct bit_set *bitset_t;
+
+
+/**
+ * @brief Iterates over the index of every set bit of a @struct bit_set ,
+ *        in ascending order.
+ *
+ * @param bs    The @struct bit_set to iterate over.
+ * @param index A `size_t` variable that holds the current index.
+ */
+#define BITSET_FOREACH(bs, index)                                 \
+    for ((index) = bitset_find_first(bs); (index) < bitset_size(bs); \
+         (index) = bitset_find_next(bs, (index) + 1))
+
+
+/**
+ * @brief Allocate a new @struct bit_set with a custom allocator.
+ *
+ * @param size The amount of bits, all initially cleared.
+ *
+ * @return A pointer to the allocated @struct bit_set , or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern bitset_t bitset_new_with_allocator(size_t size, ds_malloc_fn malloc_fn,
+                                          ds_realloc_fn realloc_fn,
+                                          ds_free_fn    free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct bit_set .
+ *
+ * @param size The amount of bits, all initially cleared.
+ *
+ * @return A pointer to the allocated @struct bit_set , or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern bitset_t
+bitset_new(size_t size) __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct bit_set and its internal buffer.
+ *
+ * @sa ::new
+ */
+extern void bitset_free(bitset_t bs) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Changes the amount of bits a @struct bit_set holds.
+ *
+ * @param size The new amount of bits. Added bits are cleared.
+ *
+ * @return A pointer to the internal word buffer, or `NULL` on failure.
+ *         Check `errno` for more information.
+ */
+extern uint64_t *bitset_resize(bitset_t bs, size_t size) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Sets the bit at the specified index.
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if @param index
+ *         is out of range.
+ *
+ * @sa ::clear
+ * @sa ::test
+ */
+extern int bitset_set(bitset_t bs, size_t index) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Clears the bit at the specified index.
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if @param index
+ *         is out of range.
+ *
+ * @sa ::set
+ * @sa ::test
+ */
+extern int bitset_clear(bitset_t bs, size_t index) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Flips the bit at the specified index.
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if @param index
+ *         is out of range.
+ */
+extern int bitset_flip(bitset_t bs, size_t index) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Checks whether the bit at the specified index is set.
+ *
+ * @return 1 if the bit is set, or 0 if it is not. `errno` is set to ERANGE
+ *         if @param index is out of range.
+ */
+extern int bitset_test(bitset_t bs, size_t index)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Sets every bit of a @struct bit_set .
+ *
+ * @sa ::clear_all
+ */
+extern void bitset_set_all(bitset_t bs) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Clears every bit of a @struct bit_set .
+ *
+ * @sa ::set_all
+ */
+extern void bitset_clear_all(bitset_t bs) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Stores the intersection of @param dest and @param src in
+ *        @param dest .
+ *
+ * @return 0 on success, or -1 and set `errno` to EINVAL if both
+ *         @struct bit_set do not have the same size.
+ *
+ * @sa ::or
+ * @sa ::xor
+ * @sa ::andnot
+ */
+extern int bitset_and(bitset_t __DS_RESTRICT dest, bitset_t __DS_RESTRICT src)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Stores the union of @param dest and @param src in @param dest .
+ *
+ * @return 0 on success, or -1 and set `errno` to EINVAL if both
+ *         @struct bit_set do not have the same size.
+ *
+ * @sa ::and
+ */
+extern int bitset_or(bitset_t __DS_RESTRICT dest, bitset_t __DS_RESTRICT src)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Stores the symmetric difference of @param dest and @param src in
+ *        @param dest .
+ *
+ * @return 0 on success, or -1 and set `errno` to EINVAL if both
+ *         @struct bit_set do not have the same size.
+ *
+ * @sa ::and
+ */
+extern int bitset_xor(bitset_t __DS_RESTRICT dest, bitset_t __DS_RESTRICT src)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Clears every bit of @param dest that is set in @param src .
+ *
+ * @return 0 on success, or -1 and set `errno` to EINVAL if both
+ *         @struct bit_set do not have the same size.
+ *
+ * @sa ::and
+ */
+extern int bitset_andnot(bitset_t __DS_RESTRICT dest,
+                         bitset_t __DS_RESTRICT src) __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Counts the set bits of a @struct bit_set .
+ */
+extern size_t bitset_count(bitset_t bs)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Finds the lowest set bit of a @struct bit_set .
+ *
+ * @return The index of the bit, or ::size if no bit is set.
+ *
+ * @sa ::find_next
+ */
+extern size_t bitset_find_first(bitset_t bs)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Finds the lowest set bit at or after the specified index.
+ *
+ * @return The index of the bit, or ::size if no such bit is set.
+ *
+ * @sa ::find_first
+ */
+extern size_t bitset_find_next(bitset_t bs, size_t index)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of bits a @struct bit_set holds.
+ */
+extern size_t bitset_size(bitset_t bs)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the internal word buffer of a @struct bit_set .
+ *
+ * Bit `i` is stored in word `i / 64` at bit position `i % 64`.
+ *
+ * @warning The unused bits of the last word must stay cleared.
+ */
+extern uint64_t *bitset_data(bitset_t bs)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_BITSET_H */
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * This file contains the declaration of the blocked Bloom filter
+ * `bloom_filter`, alongside with the functions that manipulates it.
+ */
+
+#ifndef _DS_BLOOM_H
+#define _DS_BLOOM_H 1
+#define __need_size_t 1
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "ds/__priv/cdefs.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef bloom_t
+ * @struct bloom_filter
+ *
+ * @brief A Bloom filter, answering whether a key is definitely absent or
+ *        possibly present.
+ *
+ * The filter is split into 64-byte blocks aligned to cache lines. A key
+ * sets and tests 8 bits, one in each 64-bit word of a single block, so
+ * every query costs at most one cache miss.
+ */
+typedef struct bloom_filter *bloom_t;
+
+
+/**
+ * @brief Allocate a new @struct bloom_filter with a custom allocator.
+ *
+ * @param expected The amount of keys the filter is sized for.
+ * @param fpr      The false positive rate wanted once @param expected keys
+ *                 were inserted, between 0 and 1 exclusive.
+ *
+ * @return A pointer to the allocated @struct bloom_filter , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @note The function will fail and set `errno` to EINVAL if @param fpr is
+ *       not between 0 and 1 exclusive.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern bloom_t bloom_new_with_allocator(size_t expected, double fpr,
+                                        ds_malloc_fn malloc_fn,
+                                        ds_free_fn   free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct bloom_filter .
+ *
+ * @param expected The amount of keys the filter is sized for.
+ * @param fpr      The false positive rate wanted once @param expected keys
+ *                 were inserted, between 0 and 1 exclusive.
+ *
+ * @return A pointer to the allocated @struct bloom_filter , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern bloom_t bloom_new(size_t expected, double fpr)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct bloom_filter .
+ *
+ * @sa ::new
+ */
+extern void bloom_free(bloom_t bf) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Hashes a key the way ::insert and ::contains do.
+ *
+ * Hashing once and using ::insert_hash and ::contains_hash avoids hashing
+ * the same key for every filter it is checked against.
+ */
+extern uint64_t bloom_hash(const void *key, size_t len)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Inserts a key into a @struct bloom_filter .
+ *
+ * @sa ::contains
+ */
+extern void bloom_insert(bloom_t bf, const void *key, size_t len)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Checks whether a key may be inside a @struct bloom_filter .
+ *
+ * @return 0 if @param key was never inserted, or 1 if it probably was.
+ */
+extern int bloom_contains(bloom_t bf, const void *key, size_t len)
+    __DS_ATTR_NONNULL(1, 2) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Inserts a key hashed by ::hash into a @struct bloom_filter .
+ */
+extern void bloom_insert_hash(bloom_t bf, uint64_t hash) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Checks whether a key hashed by ::hash may be inside a
+ *        @struct bloom_filter .
+ *
+ * @return 0 if the key was never inserted, or 1 if it probably was.
+ */
+extern int bloom_contains_hash(bloom_t bf, uint64_t hash)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Inserts many keys hashed by ::hash into a @struct bloom_filter .
+ *
+ * @note The blocks of the following keys are prefetched while a key is
+ *       inserted, so the cache misses of a batch overlap.
+ */
+extern void bloom_insert_batch(bloom_t bf, const uint64_t *hashes, size_t n)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Checks whether many keys hashed by ::hash may be inside a
+ *        @struct bloom_filter .
+ *
+ * @param out Where the result of every key is stored, 0 or 1.
+ *
+ * @return The amount of keys that may be inside the @struct bloom_filter .
+ *
+ * @note The blocks are prefetched like in ::insert_batch.
+ */
+extern size_t bloom_contains_batch(bloom_t bf, const uint64_t *hashes,
+                                   size_t n, unsigned char *out)
+    __DS_ATTR_NONNULL(1, 2, 4);
+
+
+/**
+ * @brief Adds every key of @param src into @param dest .
+ *
+ * @return 0 on success, or -1 and `errno` set to EINVAL if the filters do
+ *         not have the same size.
+ */
+extern int bloom_merge(bloom_t __DS_RESTRICT dest, bloom_t __DS_RESTRICT src)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Removes every key from a @struct bloom_filter .
+ */
+extern void bloom_clear(bloom_t bf) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Get the size of the bit array of a @struct bloom_filter in bytes.
+ */
+extern size_t bloom_size(bloom_t bf)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Writes a @struct bloom_filter to a stream.
+ *
+ * @return 0 on success, or -1 on failure. Check `errno` for more
+ *         information.
+ *
+ * @note Every integer is written in little endian, so the output can be
+ *       read back on hosts of either byte order.
+ *
+ * @sa ::read
+ */
+extern int bloom_write(bloom_t bf, FILE *stream) __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Allocate a @struct bloom_filter written by ::write.
+ *
+ * @return A pointer to the allocated @struct bloom_filter , or `NULL` on
+ *         failure. `errno` is set to EINVAL if the stream does not hold a
+ *         @struct bloom_filter .
+ *
+ * @sa ::write
+ */
+extern bloom_t bloom_read(FILE *stream, ds_malloc_fn malloc_fn,
+                          ds_free_fn free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD __DS_ATTR_NONNULL(1);
+
+
+__DS_END_DECLS
+
+#endif /* _DS_BLOOM_H */
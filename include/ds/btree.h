@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * This file contains the declaration of the ordered map `bplus_tree`,
+ * alongside with the functions that manipulates it.
+ */
+
+#ifndef _DS_BTREE_H
+#define _DS_BTREE_H 1
+#define __need_size_t 1
+#include <stddef.h>
+
+#include "ds/__priv/cdefs.h"
+#include "ds/darray.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef btree_t
+ * @struct bplus_tree
+ *
+ * @brief An ordered map of fixed-size keys to fixed-size values, stored as
+ *        a B+-tree.
+ *
+ * Every node spans a whole number of 64-byte cache lines and holds as many
+ * keys as fit, so a lookup touches a handful of nodes instead of one node
+ * per key comparison. The values live in the leaves, which are linked in
+ * key order for range scans.
+ */
+typedef struct bplus_tree *btree_t;
+
+
+/**
+ * @typedef btree_cmp_fn
+ *
+ * @brief The comparison function signature for a @struct bplus_tree .
+ *
+ * @return A negative value if @param a is ordered before @param b, a
+ *         positive value if it is ordered after, or 0 if they are equal.
+ */
+typedef int (*btree_cmp_fn)(const void *a, const void *b);
+
+
+/**
+ * @struct btree_iter
+ *
+ * @brief A position inside a @struct bplus_tree , see ::seek.
+ *
+ * @warning An iterator is invalidated by ::insert and ::erase.
+ */
+struct btree_iter
+{
+    btree_t            tree;
+    struct btree_node *node;
+    size_t             index;
+};
+
+
+/**
+ * @brief Allocate a new @struct bplus_tree with a custom allocator.
+ *
+ * @param key_size   The size of the keys.
+ * @param value_size The size of the values, can be 0 to store a set.
+ * @param cmp        The comparison function, or `NULL` to compare the keys
+ *                   as signed integers.
+ *
+ * @return A pointer to the allocated @struct bplus_tree , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @note The function will fail and set `errno` to EINVAL if @param key_size
+ *       is 0, or if @param cmp is `NULL` and @param key_size is not the
+ *       size of an `int32_t` or an `int64_t`.
+ * @note Integer keys are compared inline, without calling a function.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern btree_t btree_new_with_allocator(size_t key_size, size_t value_size,
+                                        btree_cmp_fn cmp,
+                                        ds_malloc_fn malloc_fn,
+                                        ds_free_fn   free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct bplus_tree .
+ *
+ * @param key_size   The size of the keys.
+ * @param value_size The size of the values, can be 0 to store a set.
+ * @param cmp        The comparison function, or `NULL` to compare the keys
+ *                   as signed integers.
+ *
+ * @return A pointer to the allocated @struct bplus_tree , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern btree_t btree_new(size_t key_size, size_t value_size, btree_cmp_fn cmp)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct bplus_tree and all of its nodes.
+ *
+ * @sa ::new
+ */
+extern void btree_free(btree_t bt) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Inserts a key and its value into a @struct bplus_tree .
+ *
+ * @param value The value to be copied, can be `NULL` if the value size is 0.
+ *
+ * @return 0 on success, or -1 on failure. `errno` is set to EEXIST if
+ *         @param key is already inside the @struct bplus_tree .
+ *
+ * @sa ::erase
+ */
+extern int btree_insert(btree_t bt, const void *key, const void *value)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Fills an empty @struct bplus_tree from sorted keys and values.
+ *
+ * @param keys   The keys, sorted in ascending order without duplicates.
+ * @param values The values, in the same order as @param keys , can be
+ *               `NULL` if the value size is 0.
+ *
+ * @return 0 on success, or -1 on failure. Check `errno` for more
+ *         information.
+ *
+ * @note The leaves are filled completely and built bottom-up, which is
+ *       far faster than inserting the keys one by one.
+ * @note The function will fail and set `errno` to EINVAL if the
+ *       @struct bplus_tree is not empty, if the element sizes of the
+ *       @struct dyn_array do not match, or if @param keys is not sorted.
+ */
+extern int btree_bulk_load(btree_t bt, darray_t keys, darray_t values)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Erases a key and its value from a @struct bplus_tree .
+ *
+ * @return 0 on success, or -1 and `errno` set to ENOENT if @param key is
+ *         not inside the @struct bplus_tree .
+ *
+ * @sa ::insert
+ */
+extern int btree_erase(btree_t bt, const void *key) __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Finds the value of a key.
+ *
+ * @return A pointer to the value inside the @struct bplus_tree , or `NULL`
+ *         if @param key is not inside it.
+ *
+ * @warning The pointer is invalidated by ::insert and ::erase.
+ */
+extern void *btree_find(btree_t bt, const void *key)
+    __DS_ATTR_NONNULL(1, 2) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Checks whether a key is inside a @struct bplus_tree .
+ */
+extern int btree_contains(btree_t bt, const void *key)
+    __DS_ATTR_NONNULL(1, 2) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Positions an iterator at the first key not ordered before
+ *        @param key .
+ *
+ * @param key The key to seek to, or `NULL` to seek to the smallest key.
+ *
+ * @code
+ * struct btree_iter it;
+ * for (btree_seek(bt, &lo, &it); btree_iter_key(&it) != NULL;
+ *      btree_iter_next(&it))
+ * {
+ *     if (*(int64_t *)btree_iter_key(&it) >= hi) break;
+ *     ...
+ * }
+ * @endcode
+ *
+ * @sa ::iter_next
+ */
+extern void btree_seek(btree_t bt, const void *key, struct btree_iter *iter)
+    __DS_ATTR_NONNULL(1, 3);
+
+
+/**
+ * @brief Moves an iterator to the next key.
+ *
+ * @return 1 if the iterator points to a key, or 0 if it reached the end.
+ */
+extern int btree_iter_next(struct btree_iter *iter) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Get the key an iterator points to.
+ *
+ * @return A pointer to the key, or `NULL` if the iterator reached the end.
+ *
+ * @warning Modifying the key breaks the ordering of the
+ *          @struct bplus_tree .
+ */
+extern void *btree_iter_key(const struct btree_iter *iter)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the value an iterator points to.
+ *
+ * @return A pointer to the value, or `NULL` if the iterator reached the end.
+ */
+extern void *btree_iter_value(const struct btree_iter *iter)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of keys inside a @struct bplus_tree .
+ */
+extern size_t btree_size(btree_t bt)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the height of a @struct bplus_tree , 0 if it is empty.
+ */
+extern size_t btree_height(btree_t bt)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the size in bytes of every node of a @struct bplus_tree .
+ */
+extern size_t btree_node_size(btree_t bt)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_BTREE_H */
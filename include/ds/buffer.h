@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * This file contains the declaration of the byte buffer structure
+ * `byte_buffer`, alongside with the functions that manipulates it.
+ */
+
+#ifndef _DS_BUFFER_H
+#define _DS_BUFFER_H 1
+#define __need_size_t 1
+#include <stddef.h>
+
+#include <sys/types.h>
+
+#include "ds/__priv/cdefs.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef buffer_t
+ * @struct byte_buffer
+ *
+ * @brief A growable byte buffer, filled at its end and consumed from its
+ *        front.
+ *
+ * Bytes are written straight into the spare capacity at the end of the
+ * buffer, see ::spare and ::commit, and consuming bytes only moves a read
+ * offset, see ::consume. The readable bytes are always contiguous.
+ */
+typedef struct byte_buffer *buffer_t;
+
+
+/**
+ * @brief Allocate a new @struct byte_buffer with a custom allocator.
+ *
+ * @return A pointer to the allocated @struct byte_buffer , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern buffer_t buffer_new_with_allocator(ds_malloc_fn  malloc_fn,
+                                          ds_realloc_fn realloc_fn,
+                                          ds_free_fn    free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct byte_buffer .
+ *
+ * @return A pointer to the allocated @struct byte_buffer , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern buffer_t
+buffer_new(void) __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct byte_buffer and its internal buffer.
+ *
+ * @sa ::new
+ */
+extern void buffer_free(buffer_t buf) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Get at least @param min bytes of writable space at the end of a
+ *        @struct byte_buffer .
+ *
+ * @return A pointer to the spare capacity, or `NULL` on allocation failure.
+ *         Check `errno` for more information.
+ *
+ * @note Already consumed bytes are reclaimed before the internal buffer is
+ *       grown, which moves the readable bytes to the front.
+ * @note Bytes written to the spare capacity are not readable until they are
+ *       committed, see ::commit.
+ *
+ * @sa ::spare_size
+ * @sa ::commit
+ */
+extern void *buffer_spare(buffer_t buf, size_t min)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of bytes that can be written to the spare capacity
+ *        without growing the @struct byte_buffer .
+ *
+ * @sa ::spare
+ */
+extern size_t buffer_spare_size(buffer_t buf)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Makes @param size bytes written to the spare capacity readable.
+ *
+ * @return 0 on success, or -1 and `errno` set to ERANGE if @param size is
+ *         larger than the spare capacity.
+ *
+ * @sa ::spare
+ */
+extern int buffer_commit(buffer_t buf, size_t size) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Appends @param size bytes to a @struct byte_buffer .
+ *
+ * @return 0 on success, or -1 on allocation failure.
+ *         Check `errno` for more information.
+ */
+extern int buffer_append(buffer_t __DS_RESTRICT buf,
+                         const void *__DS_RESTRICT data, size_t size)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Discards @param size bytes from the front of a
+ *        @struct byte_buffer .
+ *
+ * @return 0 on success, or -1 and `errno` set to ERANGE if @param size is
+ *         larger than the amount of readable bytes.
+ *
+ * @note The remaining bytes are not moved.
+ */
+extern int buffer_consume(buffer_t buf, size_t size) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Discards every readable byte of a @struct byte_buffer .
+ *
+ * @warning The function does not free the internal buffer.
+ */
+extern void buffer_clear(buffer_t buf) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Reads from a file descriptor into the spare capacity of a
+ *        @struct byte_buffer with a single `readv` call.
+ *
+ * @param min The amount of spare capacity to ensure before reading.
+ *
+ * @return The amount of bytes read, 0 on end of file, or -1 on failure.
+ *         Check `errno` for more information.
+ *
+ * @note The @struct byte_buffer is grown to 64 KiB of spare capacity
+ *       before reading when possible. If that allocation fails, only the
+ *       spare capacity is read into, so no byte taken off the file
+ *       descriptor is ever lost.
+ */
+extern ssize_t buffer_readv_fd(buffer_t buf, int fd, size_t min)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Writes the readable bytes of one or more @struct byte_buffer to a
+ *        file descriptor with a single `writev` call, consuming what was
+ *        written.
+ *
+ * @param bufs  The buffers to be written, in order.
+ * @param count The amount of buffers in @param bufs .
+ *
+ * @return The amount of bytes written, or -1 on failure.
+ *         Check `errno` for more information.
+ *
+ * @note A short write leaves the unwritten bytes in their buffers.
+ * @note At most 64 buffers are written per call.
+ */
+extern ssize_t buffer_writev_fd(buffer_t const *bufs, size_t count, int fd)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Get a pointer to the readable bytes of a @struct byte_buffer .
+ *
+ * @warning The pointer is invalidated by ::spare, ::append and
+ *          ::readv_fd.
+ */
+extern void *buffer_data(buffer_t buf)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of readable bytes inside a @struct byte_buffer .
+ */
+extern size_t buffer_size(buffer_t buf)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the size of the internal buffer of a @struct byte_buffer .
+ */
+extern size_t buffer_capacity(buffer_t buf)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_BUFFER_H */
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * This file contains the declaration of the lock-free sorted linked list
+ * structure `concurrent_list`, alongside with the functions that
+ * manipulates it.
+ */
+
+#ifndef _DS_CLIST_H
+#define _DS_CLIST_H 1
+#define __need_size_t 1
+#include <stddef.h>
+
+#include "ds/__priv/cdefs.h"
+#include "ds/epoch.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef clist_t
+ * @struct concurrent_list
+ *
+ * @brief A lock-free sorted singly linked list, safe to be inserted to,
+ *        removed from and searched by any number of threads at once.
+ *
+ * Removed nodes are reclaimed through an @struct epoch_domain , so a node is
+ * only handed to the list's free function once no thread can observe it.
+ */
+typedef struct concurrent_list *clist_t;
+
+
+/**
+ * @typedef clist_cmp_fn
+ *
+ * @brief The key comparison function signature for a @struct concurrent_list .
+ *
+ * @return A negative value if @param a is ordered before @param b, a positive
+ *         value if it is ordered after, or 0 if both are equal.
+ */
+typedef int (*clist_cmp_fn)(const void *a, const void *b);
+
+
+/**
+ * @brief Allocate a new @struct concurrent_list with a custom allocator.
+ *
+ * @param cmp The key comparison function, or `NULL` to compare the key
+ *            pointers themselves.
+ *
+ * @return A pointer to the allocated @struct concurrent_list , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern clist_t clist_new_with_allocator(clist_cmp_fn cmp,
+                                        ds_malloc_fn malloc_fn,
+                                        ds_free_fn   free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct concurrent_list .
+ *
+ * @param cmp The key comparison function, or `NULL` to compare the key
+ *            pointers themselves.
+ *
+ * @return A pointer to the allocated @struct concurrent_list , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern clist_t
+clist_new(clist_cmp_fn cmp) __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct concurrent_list and all of its nodes.
+ *
+ * @warning No other thread may access the list when this is called.
+ * @warning The function does not free the keys or the data.
+ *
+ * @sa ::new
+ */
+extern void clist_free(clist_t cl) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Inserts a key with its associated data into
+ *        a @struct concurrent_list .
+ *
+ * @return 0 on success, or -1 on failure. `errno` is set to EEXIST if the key
+ *         is already present, or to whatever the allocator sets it to.
+ *
+ * @sa ::remove
+ */
+extern int clist_insert(clist_t cl, void *key, void *data)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Removes a key from a @struct concurrent_list .
+ *
+ * @return 0 on success, or -1 and set `errno` to ENOENT if the key
+ *         is not present.
+ *
+ * @warning The function does not free the key or the data.
+ *
+ * @sa ::insert
+ */
+extern int clist_remove(clist_t cl, const void *key) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Searches for a key inside a @struct concurrent_list .
+ *
+ * @return The data associated with the key, or `NULL` and set `errno` to
+ *         ENOENT if the key is not present.
+ *
+ * @sa ::contains
+ */
+extern void *clist_find(clist_t cl, const void *key)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Checks whether a key is present inside a @struct concurrent_list .
+ *
+ * @sa ::find
+ */
+extern int clist_contains(clist_t cl, const void *key)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of keys a @struct concurrent_list holds.
+ *
+ * @note The value is only exact if no other thread modifies the list.
+ */
+extern size_t clist_size(clist_t cl) __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the @struct epoch_domain that protects a @struct concurrent_list .
+ *
+ * Every operation enters the domain on its own. Wrapping a batch of
+ * operations in ::epoch_enter and ::epoch_leave lets them share one entry.
+ */
+extern epoch_t clist_epoch(clist_t cl)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_CLIST_H */
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the declaration of the concurrent hash map
+ * `concurrent_map`, alongside with the functions that manipulates it.
+ */
+
+#ifndef _DS_CMAP_H
+#define _DS_CMAP_H 1
+#define __need_size_t 1
+#include <stddef.h>
+
+#include "ds/__priv/cdefs.h"
+#include "ds/epoch.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef cmap_t
+ * @struct concurrent_map
+ *
+ * @brief A hash map of fixed-size keys and values, safe to be read and
+ *        written by any number of threads at once.
+ *
+ * Readers never lock nor write shared memory: they walk the bucket chains
+ * inside an @struct epoch_domain , and the entries they find are never
+ * changed once published. Writers lock one of a fixed set of stripes,
+ * picked by the key hash, and replace entries instead of changing them.
+ *
+ * The table doubles incrementally: once it is full, every write moves a
+ * few buckets to the next table, and readers look a moved bucket up in
+ * the next table, so no operation waits for the whole table to move.
+ *
+ * There is no limit on the amount of live maps other than memory. Every
+ * thread keeps one small record per map it has accessed, until the map is
+ * freed, and finds the record of the map it last accessed the fastest.
+ */
+typedef struct concurrent_map *cmap_t;
+
+
+/**
+ * @brief Allocate a new @struct concurrent_map with a custom allocator.
+ *
+ * @param key_size   The size of every key, compared bytewise.
+ * @param value_size The size of every value, can be 0.
+ *
+ * @return A pointer to the allocated @struct concurrent_map , or `NULL` on
+ *         failure. `errno` is set to EINVAL if @param key_size is 0.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern cmap_t cmap_new_with_allocator(size_t key_size, size_t value_size,
+                                      ds_malloc_fn malloc_fn,
+                                      ds_free_fn   free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct concurrent_map .
+ *
+ * @param key_size   The size of every key, compared bytewise.
+ * @param value_size The size of every value, can be 0.
+ *
+ * @return A pointer to the allocated @struct concurrent_map , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern cmap_t cmap_new(size_t key_size, size_t value_size)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct concurrent_map and all of its entries.
+ *
+ * @warning No other thread may access the map when this is called.
+ *
+ * @sa ::new
+ */
+extern void cmap_free(cmap_t map) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Inserts a key with a copy of its value into a
+ *        @struct concurrent_map .
+ *
+ * @param value The value, or `NULL` to zero it.
+ *
+ * @return 0 on success, or -1 on failure. `errno` is set to EEXIST if the
+ *         key is already present, or to whatever the allocator sets it to.
+ *
+ * @sa ::put
+ * @sa ::erase
+ */
+extern int cmap_insert(cmap_t map, const void *key, const void *value)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Inserts a key with a copy of its value into a
+ *        @struct concurrent_map , replacing the value if the key is already
+ *        present.
+ *
+ * @param value The value, or `NULL` to zero it.
+ *
+ * @return 0 on success, or -1 on failure. Check `errno` for more
+ *         information.
+ *
+ * @sa ::insert
+ */
+extern int cmap_put(cmap_t map, const void *key, const void *value)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Removes a key from a @struct concurrent_map .
+ *
+ * @return 0 on success, or -1 and set `errno` to ENOENT if the key is not
+ *         present.
+ *
+ * @sa ::insert
+ */
+extern int cmap_erase(cmap_t map, const void *key) __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Copies the value of a key of a @struct concurrent_map into
+ *        @param value .
+ *
+ * @param value Where the value is copied, or `NULL` to only look the key
+ *              up.
+ *
+ * @return 0 on success, or -1 and set `errno` to ENOENT if the key is not
+ *         present.
+ *
+ * @note The value is copied as a whole from a single write, it never mixes
+ *       two concurrent writes.
+ *
+ * @sa ::contains
+ */
+extern int cmap_get(cmap_t __DS_RESTRICT map, const void *__DS_RESTRICT key,
+                    void *__DS_RESTRICT value) __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Checks whether a key is present inside a @struct concurrent_map .
+ *
+ * @sa ::get
+ */
+extern int cmap_contains(cmap_t map, const void *key)
+    __DS_ATTR_NONNULL(1, 2) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of keys a @struct concurrent_map holds.
+ *
+ * @note The value is only exact if no other thread modifies the map.
+ */
+extern size_t cmap_size(cmap_t map) __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the @struct epoch_domain that protects a
+ *        @struct concurrent_map .
+ *
+ * Every operation enters the domain on its own. Wrapping a batch of
+ * operations in ::epoch_enter and ::epoch_leave lets them share one entry.
+ */
+extern epoch_t cmap_epoch(cmap_t map)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_CMAP_H */
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the declaration of the compressed sparse row graph
+ * `csr_graph`, alongside with the functions that manipulates it.
+ */
+
+#ifndef _DS_CSR_H
+#define _DS_CSR_H 1
+#define __need_size_t 1
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ds/__priv/cdefs.h"
+#include "ds/darray.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef csr_t
+ * @struct csr_graph
+ *
+ * @brief An immutable directed graph, stored as the targets of every edge
+ *        sorted by source in one buffer, and the offset of the first edge
+ *        of every vertex in another.
+ *
+ * The neighbors of a vertex are a contiguous span of the targets buffer,
+ * so walking them reads memory sequentially. Edges may carry a payload of
+ * a fixed size, stored in a third buffer parallel to the targets.
+ */
+typedef struct csr_graph *csr_t;
+
+
+/**
+ * @brief An edge from the vertex `from` to the vertex `to`, the element
+ *        type of the edge @struct dyn_array a @struct csr_graph is built
+ *        from.
+ */
+struct csr_edge
+{
+    uint32_t from;
+    uint32_t to;
+};
+
+
+/**
+ * @brief The distance ::bfs gives to the vertices it does not reach.
+ */
+#define CSR_UNREACHED UINT32_MAX
+
+
+/**
+ * @brief Iterates over the neighbors of a vertex of a @struct csr_graph .
+ *
+ * @param g      The @struct csr_graph to iterate over.
+ * @param vertex The vertex whose neighbors are visited, in bounds.
+ * @param it     A `const uint32_t *` variable pointing at the current
+ *               neighbor.
+ */
+#define CSR_FOREACH(g, vertex, it)                                          \
+    for (const uint32_t *csr_end_##it                                       \
+         = ((it) = csr_neighbors(g, vertex, NULL)) + csr_degree(g, vertex); \
+         (it) < csr_end_##it; (it)++)
+
+
+/**
+ * @brief Sets the most threads building a single @struct csr_graph may
+ *        use.
+ *
+ * Edge lists are split into at most @param threads chunks sorted in
+ * parallel. The default, 1, never starts a thread.
+ *
+ * @note The setting is global and may be changed at any time.
+ */
+extern void csr_set_threads(size_t threads);
+
+
+/**
+ * @brief Get the most threads building a single @struct csr_graph may use.
+ */
+extern size_t csr_threads(void) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct csr_graph with a custom allocator, built
+ *        from an unsorted list of edges in O(V + E).
+ *
+ * Edges sharing a source keep their order from @param edges .
+ *
+ * @param vertex_amount The amount of vertices, identified from 0.
+ * @param edges         A @struct dyn_array of @struct csr_edge .
+ * @param payloads      A @struct dyn_array holding the payload of every
+ *                      edge at the same index, or `NULL` for none.
+ *
+ * @return A pointer to the allocated @struct csr_graph , or `NULL` on
+ *         failure. `errno` is set to EINVAL if a @struct dyn_array does not
+ *         match, or ERANGE if an edge refers to a vertex out of bounds.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern csr_t csr_new_with_allocator(size_t vertex_amount, darray_t edges,
+                                    darray_t payloads, ds_malloc_fn malloc_fn,
+                                    ds_free_fn free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD __DS_ATTR_NONNULL(2);
+
+
+/**
+ * @brief Allocate a new @struct csr_graph , built from an unsorted list of
+ *        edges in O(V + E).
+ *
+ * @return A pointer to the allocated @struct csr_graph , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern csr_t csr_new(size_t vertex_amount, darray_t edges, darray_t payloads)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD __DS_ATTR_NONNULL(2);
+
+
+/**
+ * @brief Frees up a @struct csr_graph .
+ *
+ * @sa ::new
+ */
+extern void csr_free(csr_t g) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Get the neighbors of @param vertex , the targets of its edges.
+ *
+ * @param amount Where the amount of neighbors is stored, can be `NULL`.
+ *
+ * @return A pointer to the first neighbor, or `NULL` and set `errno` to
+ *         ERANGE if @param vertex is out of bounds.
+ *
+ * @sa ::payloads
+ */
+extern const uint32_t *csr_neighbors(csr_t g, uint32_t vertex, size_t *amount)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the payloads of the edges of @param vertex , in the order of
+ *        ::neighbors.
+ *
+ * @return A pointer to the first payload, or `NULL` if the
+ *         @struct csr_graph has no payloads or @param vertex is out of
+ *         bounds.
+ */
+extern void *csr_payloads(csr_t g, uint32_t vertex)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of edges leaving @param vertex , or 0 if
+ *        @param vertex is out of bounds.
+ */
+extern size_t csr_degree(csr_t g, uint32_t vertex)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Stores the amount of edges entering every vertex in
+ *        @param degrees , which holds one element per vertex.
+ */
+extern void csr_in_degrees(csr_t g, size_t *degrees) __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Runs a breadth-first search from @param source .
+ *
+ * @param distances Where the amount of edges between @param source and
+ *                  every vertex is stored, or ::CSR_UNREACHED. Holds one
+ *                  element per vertex.
+ * @param order     Where the reached vertices are stored in the order they
+ *                  are visited, can be `NULL`. Holds one element per
+ *                  vertex.
+ *
+ * @return The amount of reached vertices, @param source included, or 0 and
+ *         set `errno` to ERANGE if @param source is out of bounds, or
+ *         ENOMEM if the search could not allocate its queue.
+ */
+extern size_t csr_bfs(csr_t g, uint32_t source, uint32_t *distances,
+                      uint32_t *order) __DS_ATTR_NONNULL(1, 3);
+
+
+/**
+ * @brief Get the amount of vertices of a @struct csr_graph .
+ */
+extern size_t csr_vertex_amount(csr_t g)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of edges of a @struct csr_graph .
+ */
+extern size_t csr_edge_amount(csr_t g)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_CSR_H */
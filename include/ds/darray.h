@@ -39,6 +39,20 @@ __DS_BEGIN_DECLS
 typedef struct dyn_array *darray_t;
 
 
+/**
+ * @typedef darray_snapshot_t
+ * @struct darray_snapshot
+ *
+ * @brief An immutable, reference counted view of the elements a
+ *        @struct dyn_array held when the view was taken.
+ *
+ * A snapshot shares the @struct dyn_array 's buffer. The buffer is only
+ * copied when the @struct dyn_array writes to an element a live snapshot
+ * can see, or needs to grow. Appending into spare capacity does not copy.
+ */
+typedef struct darray_snapshot *darray_snapshot_t;
+
+
 /**
  * @brief Allocate a new @struct dyn_array with a custom allocator.
  *
@@ -74,6 +88,9 @@ darray_new(size_t type_size) __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
 /**
  * @brief Frees up a @struct dyn_array allocated by ::new.
  *
+ * @note If a snapshot still shares the internal buffer, the buffer is freed
+ *       together with the last such snapshot.
+ *
  * @sa ::free_full
  * @sa ::new
  */
@@ -145,6 +162,9 @@ extern void darray_clear(darray_t da) __DS_ATTR_NONNULL(1);
  *
  * @return The pointer to the element, or `NULL` on failure.
  *         Check `errno`  for more information.
+ *
+ * @warning Writing through the pointer is visible to the snapshots sharing
+ *          the internal buffer, see ::snapshot.
  */
 extern void *darray_at(darray_t da, size_t index)
     __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
@@ -162,7 +182,7 @@ extern void *darray_at(darray_t da, size_t index)
  *
  * @sa ::erase
  */
-extern void *darray_insert(darray_t restrict da, void *restrict data,
+extern void *darray_insert(darray_t __DS_RESTRICT da, void *__DS_RESTRICT data,
                            size_t pos) __DS_ATTR_NONNULL(1);
 
 
@@ -204,6 +224,9 @@ extern size_t darray_type_size(darray_t da)
 
 /**
  * @brief Get the internal data buffer of a @struct dyn_array .
+ *
+ * @warning Writing to the buffer is visible to the snapshots sharing it,
+ *          see ::snapshot.
  */
 extern void *darray_data(darray_t da)
     __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
@@ -221,7 +244,7 @@ extern void *darray_data(darray_t da)
  * @sa ::insert
  * @sa ::pop_back
  */
-void *darray_push_back(darray_t restrict da, void *restrict data)
+void *darray_push_back(darray_t __DS_RESTRICT da, void *__DS_RESTRICT data)
     __DS_ATTR_NONNULL(1);
 
 
@@ -251,7 +274,7 @@ void *darray_pop_back(darray_t da) __DS_ATTR_NONNULL(1);
  * @sa ::insert
  * @sa ::pop_front
  */
-void *darray_push_front(darray_t restrict da, void *restrict data)
+void *darray_push_front(darray_t __DS_RESTRICT da, void *__DS_RESTRICT data)
     __DS_ATTR_NONNULL(1);
 
 
@@ -269,6 +292,192 @@ void *darray_push_front(darray_t restrict da, void *restrict data)
 void *darray_pop_front(darray_t da) __DS_ATTR_NONNULL(1);
 
 
+/**
+ * @brief Finds the first element of a @struct dyn_array equal to @param key .
+ *
+ * @param key The element to look for, compared byte by byte over the
+ *            type size of the @struct dyn_array .
+ *
+ * @return A pointer to the element inside the internal buffer, or `NULL`
+ *         if no element is equal to @param key .
+ *
+ * @note Elements of 1, 2, 4 and 8 bytes are compared a vector at a time,
+ *       with AVX2 when the CPU has it.
+ *
+ * @sa ::find_last
+ * @sa ::count
+ */
+extern void *darray_find(darray_t da, const void *key)
+    __DS_ATTR_NONNULL(1, 2) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Finds the last element of a @struct dyn_array equal to @param key .
+ *
+ * @return A pointer to the element inside the internal buffer, or `NULL`
+ *         if no element is equal to @param key .
+ *
+ * @sa ::find
+ */
+extern void *darray_find_last(darray_t da, const void *key)
+    __DS_ATTR_NONNULL(1, 2) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Counts the elements of a @struct dyn_array equal to @param key .
+ *
+ * @sa ::find
+ */
+extern size_t darray_count(darray_t da, const void *key)
+    __DS_ATTR_NONNULL(1, 2) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Sets how many elements ahead ::gather and ::scatter prefetch.
+ *
+ * The default, 16, keeps enough misses in flight to hide most of the
+ * memory latency of random indices. 0 disables prefetching.
+ *
+ * @note The setting is global and may be changed at any time.
+ */
+extern void darray_set_prefetch_distance(size_t distance);
+
+
+/**
+ * @brief Get how many elements ahead ::gather and ::scatter prefetch.
+ */
+extern size_t darray_prefetch_distance(void) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Copies the elements of @param src at @param indices into
+ *        @param dst , in order.
+ *
+ * @param dst     Resized to @param n elements, its old elements are lost.
+ * @param indices @param n indices into @param src .
+ *
+ * @return 0 on success, or -1 on failure. `errno` is set to EINVAL if the
+ *         type sizes differ or both arrays are the same, to ERANGE if an
+ *         index is out of range, leaving @param dst untouched, or to
+ *         whatever the allocator sets it to.
+ *
+ * @note Elements of 1, 2, 4, 8 and 16 bytes are copied by specialized
+ *       loops, without a call per element.
+ *
+ * @sa ::scatter
+ * @sa ::set_prefetch_distance
+ */
+extern int darray_gather(darray_t dst, darray_t src,
+                         const size_t *__DS_RESTRICT indices, size_t n)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Copies the first @param n elements of @param src to
+ *        @param indices inside @param dst .
+ *
+ * @param indices @param n indices into @param dst . When an index repeats,
+ *                the last element copied to it stays.
+ *
+ * @return 0 on success, or -1 on failure. `errno` is set to EINVAL if the
+ *         type sizes differ or both arrays are the same, to ERANGE if an
+ *         index is out of range or @param src holds less than @param n
+ *         elements, leaving @param dst untouched, or to whatever the
+ *         allocator sets it to.
+ *
+ * @sa ::gather
+ */
+extern int darray_scatter(darray_t dst, const size_t *__DS_RESTRICT indices,
+                          darray_t src, size_t n)
+    __DS_ATTR_NONNULL(1, 3);
+
+
+/**
+ * @brief Takes an O(1) snapshot of the elements of a @struct dyn_array .
+ *
+ * @return A snapshot holding one reference, or `NULL` on allocation
+ *         failure. Check `errno` for more information.
+ *
+ * @note The snapshot stays valid after the @struct dyn_array is modified
+ *       or freed, until ::snapshot_release drops its last reference.
+ *
+ * @sa ::snapshot_release
+ * @sa ::publish
+ */
+extern darray_snapshot_t darray_snapshot(darray_t da)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Drops a reference to a @struct darray_snapshot .
+ *
+ * @note The function may be called from any thread.
+ *
+ * @sa ::snapshot
+ * @sa ::acquire
+ */
+extern void darray_snapshot_release(darray_snapshot_t snap)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Get the amount of items a @struct darray_snapshot holds.
+ */
+extern size_t darray_snapshot_size(darray_snapshot_t snap)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the elements of a @struct darray_snapshot .
+ */
+extern const void *darray_snapshot_data(darray_snapshot_t snap)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Gets the element of a @struct darray_snapshot at the
+ *        specified index.
+ *
+ * @return The pointer to the element, or `NULL` and set `errno` to ERANGE
+ *         if @param index is out of range.
+ */
+extern const void *darray_snapshot_at(darray_snapshot_t snap, size_t index)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Takes a snapshot of a @struct dyn_array and atomically makes it
+ *        the one returned by ::acquire.
+ *
+ * @return 0 on success, or -1 on allocation failure.
+ *         Check `errno` for more information.
+ *
+ * @note Only the thread that modifies the @struct dyn_array may call this.
+ * @note The elements of the replaced snapshot are freed with its last
+ *       reference. Only its handle waits for a later call, until every
+ *       ::acquire that could still be loading it has returned.
+ *
+ * @sa ::acquire
+ */
+extern int darray_publish(darray_t da) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Gets a reference to the snapshot last published by ::publish.
+ *
+ * Readers never wait on the writer, nor the writer on the readers.
+ *
+ * @return The snapshot, to be released with ::snapshot_release, or `NULL`
+ *         and set `errno` to ENOENT if nothing was published yet.
+ *
+ * @note The function may be called from any thread.
+ *
+ * @sa ::publish
+ */
+extern darray_snapshot_t darray_acquire(darray_t da)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
 __DS_END_DECLS
 
 #endif /* _DS_DARRAY_H */
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * This file contains the declaration of the epoch-based memory reclamation
+ * domain `epoch_domain`, used by the concurrent libds data structures to
+ * defer freeing memory until no reader can still observe it.
+ */
+
+#ifndef _DS_EPOCH_H
+#define _DS_EPOCH_H 1
+#define __need_size_t 1
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ds/__priv/cdefs.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef epoch_t
+ * @struct epoch_domain
+ *
+ * @brief An epoch-based reclamation domain.
+ *
+ * Threads mark the regions in which they read shared memory with ::enter
+ * and ::leave. Memory handed to ::retire is only freed once every thread
+ * that was inside such a region at the time of the retirement has left it.
+ */
+typedef struct epoch_domain *epoch_t;
+
+
+/**
+ * @struct epoch_node
+ *
+ * @brief The bookkeeping that ::retire needs, embedded in the retired object.
+ *
+ * Embedding the node means retiring memory never has to allocate, and
+ * therefore can never fail.
+ *
+ * @warning The fields are owned by the domain between ::retire and the
+ *          moment the object is freed, do not touch them.
+ */
+struct epoch_node
+{
+    struct epoch_node *next;
+    void              *ptr;
+    uint64_t           epoch;
+};
+
+
+/**
+ * @brief Allocate a new @struct epoch_domain with a custom allocator.
+ *
+ * @param free_fn The function retired memory is freed with.
+ *
+ * @return A pointer to the allocated @struct epoch_domain , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern epoch_t epoch_new_with_allocator(ds_malloc_fn malloc_fn,
+                                        ds_free_fn   free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct epoch_domain .
+ *
+ * @return A pointer to the allocated @struct epoch_domain , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern epoch_t epoch_new(void) __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct epoch_domain and every memory still
+ *        waiting to be reclaimed.
+ *
+ * @note Other threads that have used the domain keep their per-thread record
+ *       until they exit or next enter any domain.
+ *
+ * @warning No thread may be inside the domain when this is called.
+ *
+ * @sa ::new
+ */
+extern void epoch_free(epoch_t ep) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Marks the calling thread as reading memory protected by
+ *        a @struct epoch_domain .
+ *
+ * @return 0 on success, or -1 if the per-thread record could not be
+ *         allocated. Check `errno` for more information.
+ *
+ * @note Calls may be nested, only the outermost pair has an effect.
+ *
+ * @sa ::leave
+ */
+extern int epoch_enter(epoch_t ep) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Marks the calling thread as no longer reading memory protected
+ *        by a @struct epoch_domain .
+ *
+ * @sa ::enter
+ */
+extern void epoch_leave(epoch_t ep) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Schedules @param ptr to be freed once no reader can observe it.
+ *
+ * @param node The @struct epoch_node embedded inside @param ptr .
+ * @param ptr  The memory to be freed.
+ *
+ * @note The calling thread must be inside the domain, see ::enter.
+ * @note @param ptr must already be unreachable for new readers.
+ * @note The function never fails. A thread the domain can not allocate a
+ *       record for retires into a list shared under a lock instead.
+ *
+ * @sa ::collect
+ */
+extern void epoch_retire(epoch_t ep, struct epoch_node *node, void *ptr)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Tries to advance the global epoch and frees the memory retired by
+ *        the calling thread that is no longer observable.
+ *
+ * @note ::retire already does this periodically, calling it explicitly is
+ *       only needed to release memory sooner.
+ *
+ * @sa ::retire
+ */
+extern void epoch_collect(epoch_t ep) __DS_ATTR_NONNULL(1);
+
+
+__DS_END_DECLS
+
+#endif /* _DS_EPOCH_H */
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the declaration of the Fenwick tree `fenwick_tree`,
+ * alongside with the functions that manipulates it.
+ */
+
+#ifndef _DS_FENWICK_H
+#define _DS_FENWICK_H 1
+#define __need_size_t 1
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ds/__priv/cdefs.h"
+#include "ds/darray.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef fenwick_t
+ * @struct fenwick_tree
+ *
+ * @brief An array of numbers answering range sums and taking point updates
+ *        in O(log n).
+ *
+ * The tree is a single implicit array of the same size as the numbers,
+ * where every entry holds the sum of a run of numbers ending at it, whose
+ * length is the lowest set bit of its 1-based index.
+ */
+typedef struct fenwick_tree *fenwick_t;
+
+
+/**
+ * @brief The type of the numbers of a @struct fenwick_tree .
+ */
+enum fenwick_type
+{
+    /* 64-bit integers, summed with wrap around */
+    FENWICK_I64,
+
+    /* doubles */
+    FENWICK_F64,
+};
+
+
+/**
+ * @brief Allocate a new @struct fenwick_tree of @param size zeroes with a
+ *        custom allocator.
+ *
+ * @return A pointer to the allocated @struct fenwick_tree , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern fenwick_t fenwick_new_with_allocator(size_t            size,
+                                            enum fenwick_type type,
+                                            ds_malloc_fn      malloc_fn,
+                                            ds_free_fn        free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct fenwick_tree of @param size zeroes.
+ *
+ * @return A pointer to the allocated @struct fenwick_tree , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::from_darray
+ * @sa ::free
+ */
+extern fenwick_t fenwick_new(size_t size, enum fenwick_type type)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct fenwick_tree holding a copy of the
+ *        elements of a @struct dyn_array , built in O(n).
+ *
+ * @return A pointer to the allocated @struct fenwick_tree , or `NULL` on
+ *         failure. `errno` is set to EINVAL if the type size of the
+ *         @struct dyn_array is not 8.
+ *
+ * @sa ::new
+ */
+extern fenwick_t fenwick_from_darray(darray_t da, enum fenwick_type type)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Frees up a @struct fenwick_tree .
+ *
+ * @sa ::new
+ */
+extern void fenwick_free(fenwick_t ft) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Adds @param delta to the number at @param index .
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if @param index is
+ *         out of bounds, or EINVAL if the @struct fenwick_tree holds
+ *         another type.
+ *
+ * @sa ::set_i64
+ */
+extern int fenwick_add_i64(fenwick_t ft, size_t index, int64_t delta)
+    __DS_ATTR_NONNULL(1);
+extern int fenwick_add_f64(fenwick_t ft, size_t index, double delta)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Replaces the number at @param index with @param value .
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if @param index is
+ *         out of bounds, or EINVAL if the @struct fenwick_tree holds
+ *         another type.
+ *
+ * @note Doubles are replaced by adding their difference, so the sums that
+ *       include them may be off by a rounding error.
+ *
+ * @sa ::add_i64
+ */
+extern int fenwick_set_i64(fenwick_t ft, size_t index, int64_t value)
+    __DS_ATTR_NONNULL(1);
+extern int fenwick_set_f64(fenwick_t ft, size_t index, double value)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Sums the numbers from @param from up to, but not including,
+ *        @param to into @param out .
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if the range is
+ *         out of bounds or reversed, or EINVAL if the @struct fenwick_tree
+ *         holds another type.
+ */
+extern int fenwick_sum_i64(fenwick_t ft, size_t from, size_t to,
+                           int64_t *out) __DS_ATTR_NONNULL(1, 4);
+extern int fenwick_sum_f64(fenwick_t ft, size_t from, size_t to,
+                           double *out) __DS_ATTR_NONNULL(1, 4);
+
+
+/**
+ * @brief Resets every number of a @struct fenwick_tree to zero.
+ */
+extern void fenwick_clear(fenwick_t ft) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Get the amount of numbers of a @struct fenwick_tree .
+ */
+extern size_t fenwick_size(fenwick_t ft)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_FENWICK_H */
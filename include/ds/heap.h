@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * This file contains the declaration of the priority queue structure
+ * `dary_heap`, alongside with the functions that manipulates it.
+ */
+
+#ifndef _DS_HEAP_H
+#define _DS_HEAP_H 1
+#define __need_size_t 1
+#include <stddef.h>
+
+#include "ds/__priv/cdefs.h"
+#include "ds/darray.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef heap_t
+ * @struct dary_heap
+ *
+ * @brief A 4-ary heap that stores fixed-size elements contiguously inside
+ *        a @struct dyn_array .
+ *
+ * The four children of a node are adjacent in memory, so a sift-down step
+ * compares elements that usually share one cache line.
+ */
+typedef struct dary_heap *heap_t;
+
+
+/**
+ * @typedef heap_cmp_fn
+ *
+ * @brief The comparison function signature for a @struct dary_heap .
+ *
+ * @return A negative value if @param a should be closer to the top than
+ *         @param b, a positive value if it should be further, or 0.
+ */
+typedef int (*heap_cmp_fn)(const void *a, const void *b);
+
+
+/**
+ * @typedef heap_index_fn
+ *
+ * @brief The function signature called every time an element is moved to
+ *        a new position inside a @struct dary_heap .
+ *
+ * Keeping track of the positions is what makes ::update and ::erase usable,
+ * for example by storing @param index inside the element itself.
+ *
+ * @param elem  The element, at its new position.
+ * @param index The new position of the element.
+ */
+typedef void (*heap_index_fn)(void *elem, size_t index);
+
+
+/**
+ * @brief Allocate a new @struct dary_heap with a custom allocator.
+ *
+ * @param type_size The size of the type the struct will hold.
+ * @param cmp       The comparison function.
+ *
+ * @return A pointer to the allocated @struct dary_heap , or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern heap_t heap_new_with_allocator(size_t type_size, heap_cmp_fn cmp,
+                                      ds_malloc_fn  malloc_fn,
+                                      ds_realloc_fn realloc_fn,
+                                      ds_free_fn    free_fn) __DS_THROW
+    __DS_ATTR_MALLOC __DS_ATTR_NONNULL(2) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct dary_heap .
+ *
+ * @param type_size The size of the type the struct will hold.
+ * @param cmp       The comparison function.
+ *
+ * @return A pointer to the allocated @struct dary_heap , or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::from_darray
+ * @sa ::free
+ */
+extern heap_t heap_new(size_t type_size, heap_cmp_fn cmp) __DS_THROW
+    __DS_ATTR_MALLOC __DS_ATTR_NONNULL(2) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Turns the elements of a @struct dyn_array into a @struct dary_heap
+ *        in O(n), without copying them.
+ *
+ * @param da  The @struct dyn_array that the heap takes ownership of.
+ * @param cmp The comparison function.
+ *
+ * @return A pointer to the allocated @struct dary_heap , or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @note The @struct dary_heap itself is allocated with the
+ *       standard allocator.
+ *
+ * @sa ::new
+ * @sa ::darray
+ */
+extern heap_t heap_from_darray(darray_t da, heap_cmp_fn cmp) __DS_THROW
+    __DS_ATTR_MALLOC __DS_ATTR_NONNULL(1, 2) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct dary_heap and its internal buffer.
+ *
+ * @sa ::new
+ */
+extern void heap_free(heap_t heap) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Sets the function called whenever an element changes position.
+ *
+ * @param index_fn The function to be called, or `NULL` to disable it.
+ *
+ * @note @param index_fn is immediately called for every element the
+ *       @struct dary_heap already holds.
+ *
+ * @sa ::update
+ * @sa ::erase
+ */
+extern void heap_set_index_fn(heap_t heap, heap_index_fn index_fn)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Inserts an element into a @struct dary_heap .
+ *
+ * @param data The data to be inserted.
+ *
+ * @return A pointer pointing to where @param data is inside the
+ *         internal buffer, or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @sa ::push_bulk
+ * @sa ::pop
+ */
+extern void *heap_push(heap_t __DS_RESTRICT heap,
+                       const void *__DS_RESTRICT data) __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Inserts multiple elements into a @struct dary_heap .
+ *
+ * @param data   The contiguous elements to be inserted.
+ * @param amount The amount of elements inside @param data.
+ *
+ * @return A pointer to the internal buffer, or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @note When @param amount is at least the current size, the whole heap is
+ *       rebuilt in O(n) instead of inserting the elements one by one.
+ *
+ * @sa ::push
+ */
+extern void *heap_push_bulk(heap_t __DS_RESTRICT heap,
+                            const void *__DS_RESTRICT data, size_t amount)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Get the element at the top of a @struct dary_heap .
+ *
+ * @return The pointer to the element, or `NULL` and set `errno` to ERANGE
+ *         if the heap is empty.
+ */
+extern void *heap_top(heap_t heap) __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Removes the element at the top of a @struct dary_heap .
+ *
+ * @param out Where the removed element is copied to, can be `NULL`.
+ *
+ * @return A pointer to the internal buffer, or `NULL` and set `errno`
+ *         to ERANGE if the heap is empty.
+ *
+ * @sa ::push
+ * @sa ::erase
+ */
+extern void *heap_pop(heap_t __DS_RESTRICT heap, void *__DS_RESTRICT out)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Replaces the element at the specified position, moving it up
+ *        or down the @struct dary_heap as needed.
+ *
+ * This is the decrease-key (and increase-key) operation. The position of an
+ * element is known through the function set with ::set_index_fn.
+ *
+ * @param index The position of the element to be replaced.
+ * @param data  The new value of the element.
+ *
+ * @return A pointer pointing to where @param data is inside the
+ *         internal buffer, or `NULL` and set `errno` to ERANGE if
+ *         @param index is out of range.
+ *
+ * @sa ::set_index_fn
+ */
+extern void *heap_update(heap_t __DS_RESTRICT heap, size_t index,
+                         const void *__DS_RESTRICT data)
+    __DS_ATTR_NONNULL(1, 3);
+
+
+/**
+ * @brief Removes the element at the specified position.
+ *
+ * @param index The position of the element to be removed.
+ *
+ * @return A pointer to the internal buffer, or `NULL` and set `errno` to
+ *         ERANGE if @param index is out of range.
+ *
+ * @sa ::set_index_fn
+ * @sa ::pop
+ */
+extern void *heap_erase(heap_t heap, size_t index) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Get the amount of items a @struct dary_heap holds.
+ */
+extern size_t heap_size(heap_t heap)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the @struct dyn_array a @struct dary_heap stores its
+ *        elements in, in heap order.
+ *
+ * @warning Modifying the @struct dyn_array breaks the heap.
+ */
+extern darray_t heap_darray(heap_t heap)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_HEAP_H */
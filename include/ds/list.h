@@ -19,6 +19,34 @@ __DS_BEGIN_DECLS
 typedef struct linked_list *list_t;
 
 
+/**
+ * @typedef list_cmp_fn
+ *
+ * @brief The comparison function signature used by ::sort.
+ *
+ * @param a The data of a node.
+ * @param b The data of another node.
+ *
+ * @return A negative value if @param a should come before @param b, a
+ *         positive value if it should come after, or 0.
+ */
+typedef int (*list_cmp_fn)(const void *a, const void *b);
+
+
+/**
+ * @typedef list_iter_fn
+ *
+ * @brief The function signature called for every node visited by
+ *        ::foreach.
+ *
+ * @param value The data of the node.
+ * @param data  The pointer passed to ::foreach.
+ *
+ * @return 0 to continue the iteration, or any other value to stop it.
+ */
+typedef int (*list_iter_fn)(void *value, void *data);
+
+
 /**
  * @brief Allocate a new @struct linked_list node with a custom allocator.
  *
@@ -76,7 +104,7 @@ extern void list_free(list_t list) __DS_ATTR_NONNULL(1);
  * @sa ::set_data
  * @sa ::prepend
  */
-extern list_t list_append(list_t restrict list, void *restrict data)
+extern list_t list_append(list_t __DS_RESTRICT list, void *__DS_RESTRICT data)
     __DS_ATTR_NONNULL(1);
 
 
@@ -90,7 +118,7 @@ extern list_t list_append(list_t restrict list, void *restrict data)
  * @sa ::append
  * @sa ::prepend
  */
-extern list_t list_set_data(list_t restrict list, void *restrict data)
+extern list_t list_set_data(list_t __DS_RESTRICT list, void *__DS_RESTRICT data)
     __DS_ATTR_NONNULL(1);
 
 
@@ -106,7 +134,7 @@ extern list_t list_set_data(list_t restrict list, void *restrict data)
  * @sa ::set_data
  * @sa ::append
  */
-extern list_t list_prepend(list_t restrict list, void *restrict data)
+extern list_t list_prepend(list_t __DS_RESTRICT list, void *__DS_RESTRICT data)
     __DS_ATTR_NONNULL(1);
 
 
@@ -150,6 +178,106 @@ extern list_t list_prev(list_t list) __DS_ATTR_NONNULL(1);
 extern list_t list_at(list_t list, int64_t index) __DS_ATTR_NONNULL(1);
 
 
+/**
+ * @brief Links the head of the @struct linked_list holding @param other
+ *        after the tail of the one holding @param list .
+ *
+ * @return The head node of @param other 's list, now following the tail of
+ *         @param list 's list.
+ *
+ * @note The function runs in O(1) when @param list is a tail node and
+ *       @param other is a head node.
+ * @warning Both nodes must belong to different lists.
+ *
+ * @sa ::splice
+ * @sa ::split_at
+ */
+extern list_t list_concat(list_t list, list_t other) __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Moves the nodes from @param first to @param last out of their
+ *        @struct linked_list and inserts them after @param pos .
+ *
+ * @param pos   The node the moved nodes will follow.
+ * @param first The first node to move.
+ * @param last  The last node to move, @param first or a node after it.
+ *
+ * @return The pointer @param first.
+ *
+ * @note The function runs in O(1), and @param pos may belong to the same
+ *       list as the moved nodes.
+ * @warning @param pos must not be one of the moved nodes.
+ *
+ * @sa ::concat
+ */
+extern list_t list_splice(list_t pos, list_t first, list_t last)
+    __DS_ATTR_NONNULL(1, 2, 3);
+
+
+/**
+ * @brief Splits a @struct linked_list in two before @param list , which
+ *        becomes the head of the second list.
+ *
+ * @return The tail node of the first list, or `NULL` if @param list was
+ *         already a head node.
+ *
+ * @note The function runs in O(1).
+ *
+ * @sa ::concat
+ */
+extern list_t list_split_at(list_t list) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Sorts the nodes of a @struct linked_list by their data.
+ *
+ * The nodes are relinked in place with a bottom-up merge sort, in
+ * O(n log n) without allocating. Nodes comparing equal keep their order.
+ *
+ * @param list Any node of the list.
+ * @param cmp  The function comparing the data of two nodes.
+ *
+ * @return The new head node.
+ */
+extern list_t list_sort(list_t list, list_cmp_fn cmp) __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Moves every node of a @struct linked_list into one block, in
+ *        traversal order.
+ *
+ * Walking the compacted list streams through memory instead of chasing
+ * nodes scattered over the heap. The block comes from the allocator of the
+ * list, and is freed once every node inside it is freed.
+ *
+ * @param list Any node of the list.
+ *
+ * @return The new head node, or `NULL` on allocation failure, leaving the
+ *         list untouched.
+ *
+ * @warning Every node moves, pointers to the old nodes are left dangling.
+ */
+extern list_t list_compact(list_t list) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Calls a function on the data of every node of a
+ *        @struct linked_list , from @param list to the tail.
+ *
+ * @param lookahead How many nodes ahead of the visited one are prefetched,
+ *                  alongside their data, 0 to not prefetch.
+ * @param fn        The function called for every node.
+ *
+ * @return 0 if every node was visited, or the non-zero value @param fn
+ *         stopped the iteration with.
+ *
+ * @warning The @struct linked_list must not be modified by @param fn .
+ */
+extern int list_foreach(list_t list, size_t lookahead, list_iter_fn fn,
+                        void *data) __DS_ATTR_NONNULL(1, 3);
+
+
 __DS_END_DECLS
 
 #endif /* _DS_LIST_H */
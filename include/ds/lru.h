@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the declaration of the fixed-capacity cache
+ * `lru_cache`, alongside with the functions that manipulates it.
+ */
+
+#ifndef _DS_LRU_H
+#define _DS_LRU_H 1
+#define __need_size_t 1
+#include <stddef.h>
+
+#include "ds/__priv/cdefs.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef lru_t
+ * @struct lru_cache
+ *
+ * @brief A cache mapping fixed-size keys to fixed-size values, evicting an
+ *        old entry when a new one does not fit.
+ *
+ * Every entry lives in one slab allocated upfront, linked by index into a
+ * hash table and a recency list. Lookups, insertions and evictions are
+ * O(1) and never allocate.
+ */
+typedef struct lru_cache *lru_t;
+
+
+/**
+ * @brief The ways a @struct lru_cache picks the entry to evict.
+ */
+enum lru_policy
+{
+    /* the least recently used entry, relinking the entry on every hit */
+    LRU_EXACT,
+
+    /*
+     * An approximation where a hit only sets a flag. A clock hand sweeps
+     * the entries on eviction, clearing flags until it finds an unflagged
+     * entry. Hits do not write to the links, so concurrent ::get calls are
+     * safe while no other function runs, under a read lock for example.
+     */
+    LRU_CLOCK,
+};
+
+
+/**
+ * @typedef lru_evict_fn
+ *
+ * @brief The function signature called with every entry a
+ *        @struct lru_cache evicts to make room.
+ *
+ * @param data The pointer passed to ::set_evict.
+ */
+typedef void (*lru_evict_fn)(const void *key, void *value, void *data);
+
+
+/**
+ * @brief Allocate a new @struct lru_cache with a custom allocator.
+ *
+ * @param capacity   The amount of entries the cache can hold.
+ * @param key_size   The size of every key, compared bytewise.
+ * @param value_size The size of every value.
+ *
+ * @return A pointer to the allocated @struct lru_cache , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @note The function will fail and set `errno` to EINVAL if
+ *       @param capacity or @param key_size is 0, or if @param policy is
+ *       not a valid @enum lru_policy .
+ * @warning Keys are compared bytewise, so padding bytes inside keys must
+ *          be zeroed.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern lru_t lru_new_with_allocator(size_t capacity, size_t key_size,
+                                    size_t value_size, enum lru_policy policy,
+                                    ds_malloc_fn malloc_fn, ds_free_fn free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct lru_cache .
+ *
+ * @return A pointer to the allocated @struct lru_cache , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern lru_t lru_new(size_t capacity, size_t key_size, size_t value_size,
+                     enum lru_policy policy)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct lru_cache and its entries.
+ *
+ * @note The eviction function is not called.
+ *
+ * @sa ::new
+ */
+extern void lru_free(lru_t lru) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Sets the function called with every evicted entry.
+ *
+ * @param fn   The function, or `NULL` to remove it.
+ * @param data The pointer passed to @param fn .
+ */
+extern void lru_set_evict(lru_t lru, lru_evict_fn fn, void *data)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Finds the value of a key and marks it as recently used.
+ *
+ * @return A pointer to the value, or `NULL` if @param key is not cached.
+ *
+ * @warning The pointer is invalidated by ::put and ::erase.
+ */
+extern void *lru_get(lru_t lru, const void *key) __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Caches a value under a key, replacing the value the key had.
+ *
+ * @param value The value copied into the cache, or `NULL` to zero it.
+ *
+ * @return A pointer to the cached value.
+ *
+ * @note If the cache is full and @param key is not cached, an entry is
+ *       evicted first, see @enum lru_policy .
+ * @warning The pointer is invalidated by ::put and ::erase.
+ */
+extern void *lru_put(lru_t lru, const void *key, const void *value)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Removes a key from a @struct lru_cache , without calling the
+ *        eviction function.
+ *
+ * @return 0 on success, or -1 and `errno` set to ENOENT if @param key is
+ *         not cached.
+ */
+extern int lru_erase(lru_t lru, const void *key) __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Removes every entry, without calling the eviction function.
+ */
+extern void lru_clear(lru_t lru) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Get the amount of entries inside a @struct lru_cache .
+ */
+extern size_t lru_size(lru_t lru)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of entries a @struct lru_cache can hold.
+ */
+extern size_t lru_capacity(lru_t lru)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_LRU_H */
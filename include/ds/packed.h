@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the declaration of the compressed integer array
+ * `packed_array`, alongside with the functions that manipulates it.
+ */
+
+#ifndef _DS_PACKED_H
+#define _DS_PACKED_H 1
+#define __need_size_t 1
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ds/__priv/cdefs.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef packed_t
+ * @struct packed_array
+ *
+ * @brief An array of unsigned 64-bit integers stored in compressed form.
+ */
+typedef struct packed_array *packed_t;
+
+
+/**
+ * @brief The ways a @struct packed_array can store its integers.
+ */
+enum packed_mode
+{
+    /*
+     * Every integer takes as many bits as the widest one, chosen
+     * automatically as integers are added. Access is O(1).
+     */
+    PACKED_BITS,
+
+    /*
+     * For non-decreasing integers. Blocks of 128 integers store the
+     * differences between neighbours as 1, 2, 4 or 8 byte varints, and
+     * a skip pointer per block bounds random access to one block decode.
+     */
+    PACKED_DELTA,
+};
+
+
+/**
+ * @brief Allocate a new @struct packed_array with a custom allocator.
+ *
+ * @return A pointer to the allocated @struct packed_array , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @note The function will fail and set `errno` to EINVAL if @param mode is
+ *       not a valid @enum packed_mode .
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern packed_t packed_new_with_allocator(enum packed_mode mode,
+                                          ds_malloc_fn     malloc_fn,
+                                          ds_realloc_fn    realloc_fn,
+                                          ds_free_fn       free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct packed_array .
+ *
+ * @return A pointer to the allocated @struct packed_array , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern packed_t packed_new(enum packed_mode mode)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct packed_array and its internal buffers.
+ *
+ * @sa ::new
+ */
+extern void packed_free(packed_t pa) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Appends an integer to the end of a @struct packed_array .
+ *
+ * @return 0 on success, or -1 on failure. `errno` is set to EINVAL if the
+ *         array is in ::PACKED_DELTA mode and @param value is smaller than
+ *         the last integer.
+ *
+ * @note In ::PACKED_BITS mode, appending a wider integer than the current
+ *       width repacks the whole array.
+ */
+extern int packed_append(packed_t pa, uint64_t value) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Appends @param n integers to the end of a @struct packed_array .
+ *
+ * @return 0 on success, or -1 on failure, in which case some of the
+ *         integers may have been appended. Check `errno` for more
+ *         information.
+ *
+ * @sa ::append
+ */
+extern int packed_append_many(packed_t pa, const uint64_t *values, size_t n)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Gets the integer at the specified index.
+ *
+ * @param value Where the integer is stored.
+ *
+ * @return 0 on success, or -1 and `errno` set to ERANGE if @param index is
+ *         out of range.
+ *
+ * @note The function runs in O(1) in ::PACKED_BITS mode, and decodes at
+ *       most one block in ::PACKED_DELTA mode.
+ */
+extern int packed_get(packed_t pa, size_t index, uint64_t *value)
+    __DS_ATTR_NONNULL(1, 3);
+
+
+/**
+ * @brief Replaces the integer at the specified index.
+ *
+ * @return 0 on success, or -1 on failure. `errno` is set to ERANGE if
+ *         @param index is out of range, or to EINVAL if the array is in
+ *         ::PACKED_DELTA mode.
+ */
+extern int packed_set(packed_t pa, size_t index, uint64_t value)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Decodes consecutive integers into a plain array.
+ *
+ * @param from The index of the first integer to decode.
+ * @param out  Where the integers are stored.
+ * @param n    The maximum amount of integers to decode.
+ *
+ * @return The amount of integers decoded, less than @param n once the end
+ *         of the array is reached.
+ *
+ * @note This is much faster than calling ::get for every index.
+ */
+extern size_t packed_decode(packed_t pa, size_t from, uint64_t *out, size_t n)
+    __DS_ATTR_NONNULL(1, 3);
+
+
+/**
+ * @brief Get the amount of integers inside a @struct packed_array .
+ */
+extern size_t packed_size(packed_t pa)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of bytes used by the integers of a
+ *        @struct packed_array , without unused capacity.
+ */
+extern size_t packed_bytes(packed_t pa)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of bits every integer takes in ::PACKED_BITS mode,
+ *        or 0 in ::PACKED_DELTA mode.
+ */
+extern unsigned packed_width(packed_t pa)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_PACKED_H */
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * This file contains the declaration of the hardware performance counter
+ * profiler `profiler`, used to attribute the cost of libds operations to
+ * cycles, cache misses and branch misses.
+ */
+
+#ifndef _DS_PROF_H
+#define _DS_PROF_H 1
+#define __need_size_t 1
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "ds/__priv/cdefs.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef prof_t
+ * @struct profiler
+ *
+ * @brief A set of hardware performance counters counting the thread that
+ *        created it, alongside with per-name accumulated statistics.
+ *
+ * The counters are read through Linux's `perf_event_open`. Counters the
+ * kernel, the hardware, or the build does not provide are skipped, so
+ * a @struct profiler always works, in the worst case measuring only time.
+ */
+typedef struct profiler *prof_t;
+
+
+/**
+ * @enum prof_counter
+ *
+ * @brief The hardware events a @struct profiler can count.
+ */
+enum prof_counter
+{
+    PROF_CYCLES,
+    PROF_INSTRUCTIONS,
+    PROF_L1D_MISSES,
+    PROF_LLC_MISSES,
+    PROF_BRANCH_MISSES,
+    PROF_COUNTER_AMOUNT,
+};
+
+
+/**
+ * @struct prof_sample
+ *
+ * @brief The counter values measured over one or more regions.
+ *
+ * When the kernel had to share the hardware between more counters than
+ * it has, the values are scaled up from the part of a region that was
+ * counted. Regions the counters were never scheduled for add nothing to
+ * `values` and are left out of `counted`.
+ */
+struct prof_sample
+{
+    uint64_t values[PROF_COUNTER_AMOUNT];
+    uint64_t wall_ns;
+
+    /* the amount of regions `values` was measured over */
+    uint64_t counted;
+};
+
+
+/**
+ * @brief Profiles a single expression, accumulating its cost under a name.
+ *
+ * @code
+ * PROF_SCOPE(prof, "darray_insert", darray_insert(da, &val, 0));
+ * @endcode
+ *
+ * @sa ::begin
+ * @sa ::end
+ */
+#define PROF_SCOPE(prof, name, expr) \
+    do {                             \
+        prof_begin(prof);            \
+        (expr);                      \
+        prof_end(prof, name, NULL);  \
+    } while (0)
+
+
+/**
+ * @brief Allocate a new @struct profiler with a custom allocator.
+ *
+ * @return A pointer to the allocated @struct profiler , or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @note Unavailable counters do not make the function fail, see ::available.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern prof_t prof_new_with_allocator(ds_malloc_fn  malloc_fn,
+                                      ds_realloc_fn realloc_fn,
+                                      ds_free_fn    free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct profiler .
+ *
+ * @return A pointer to the allocated @struct profiler , or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern prof_t prof_new(void) __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Closes the counters of a @struct profiler and frees it up.
+ *
+ * @sa ::new
+ */
+extern void prof_free(prof_t prof) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Checks whether a @struct profiler is able to count an event.
+ */
+extern int prof_available(prof_t prof, enum prof_counter counter)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Resets and starts the counters of a @struct profiler .
+ *
+ * @sa ::end
+ */
+extern void prof_begin(prof_t prof) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Stops the counters of a @struct profiler and reads them.
+ *
+ * @param name The name the region's cost is accumulated under, or `NULL`.
+ *             The string must outlive the @struct profiler .
+ * @param out  Where the region's cost is copied to, can be `NULL`.
+ *
+ * @return 0 on success, or -1 if the statistics for @param name could not
+ *         be allocated. Check `errno` for more information.
+ *
+ * @sa ::begin
+ * @sa ::stats
+ */
+extern int prof_end(prof_t prof, const char *name, struct prof_sample *out)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Get the accumulated cost of every region ended under a name.
+ *
+ * @param out Where the accumulated cost is copied to.
+ *
+ * @return The amount of regions ended under @param name , 0 if none were.
+ */
+extern size_t prof_stats(prof_t prof, const char *name, struct prof_sample *out)
+    __DS_ATTR_NONNULL(1, 2, 3);
+
+
+/**
+ * @brief Prints a table of every name's accumulated cost, averaged per
+ *        region.
+ *
+ * @note The counters are averaged over the regions they measured, and
+ *       unavailable ones are printed as `-`.
+ */
+extern void prof_report(prof_t prof, FILE *stream) __DS_ATTR_NONNULL(1, 2);
+
+
+__DS_END_DECLS
+
+#endif /* _DS_PROF_H */
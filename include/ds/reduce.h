@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the declaration of the typed reductions over the
+ * elements of a @struct dyn_array , alongside with the functions that
+ * configure them.
+ *
+ * Every reduction works on `darray_data` directly, with several vector
+ * accumulators, and fails with `errno` set to EINVAL if the type size of
+ * the @struct dyn_array is not the size of its element type.
+ */
+
+#ifndef _DS_REDUCE_H
+#define _DS_REDUCE_H 1
+#define __need_size_t 1
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ds/__priv/cdefs.h"
+#include "ds/darray.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @brief Sets the most threads a single reduction may use.
+ *
+ * Arrays are split into at most @param threads chunks of at least 1 MiB,
+ * reduced in parallel. The default, 1, never starts a thread.
+ *
+ * @note The setting is global and may be changed at any time.
+ */
+extern void darray_reduce_set_threads(size_t threads);
+
+
+/**
+ * @brief Get the most threads a single reduction may use.
+ */
+extern size_t darray_reduce_threads(void) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Sums the elements of a @struct dyn_array into @param out .
+ *
+ * Integers are summed with wrap around, 32-bit ones into 64 bits. Floats
+ * are summed pairwise, so the rounding error grows with the logarithm of
+ * the amount of elements.
+ *
+ * @return 0 on success, or -1 and set `errno` to EINVAL if the type size
+ *         does not match.
+ *
+ * @sa ::sum_kahan_f64
+ */
+extern int darray_sum_i32(darray_t da, int64_t *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_sum_i64(darray_t da, int64_t *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_sum_u32(darray_t da, uint64_t *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_sum_u64(darray_t da, uint64_t *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_sum_f32(darray_t da, float *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_sum_f64(darray_t da, double *out) __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Sums the elements of a @struct dyn_array into @param out with
+ *        Kahan compensation, so the rounding error does not grow with the
+ *        amount of elements.
+ *
+ * @return 0 on success, or -1 and set `errno` to EINVAL if the type size
+ *         does not match.
+ *
+ * @sa ::sum_f64
+ */
+extern int darray_sum_kahan_f32(darray_t da, float *out)
+    __DS_ATTR_NONNULL(1, 2);
+extern int darray_sum_kahan_f64(darray_t da, double *out)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Stores the smallest element of a @struct dyn_array in @param out .
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if the
+ *         @struct dyn_array is empty, or EINVAL if the type size does not
+ *         match.
+ *
+ * @warning The result is unspecified if a float element is NaN.
+ */
+extern int darray_min_i32(darray_t da, int32_t *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_min_i64(darray_t da, int64_t *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_min_u32(darray_t da, uint32_t *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_min_u64(darray_t da, uint64_t *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_min_f32(darray_t da, float *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_min_f64(darray_t da, double *out) __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Stores the largest element of a @struct dyn_array in @param out .
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if the
+ *         @struct dyn_array is empty, or EINVAL if the type size does not
+ *         match.
+ *
+ * @warning The result is unspecified if a float element is NaN.
+ */
+extern int darray_max_i32(darray_t da, int32_t *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_max_i64(darray_t da, int64_t *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_max_u32(darray_t da, uint32_t *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_max_u64(darray_t da, uint64_t *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_max_f32(darray_t da, float *out) __DS_ATTR_NONNULL(1, 2);
+extern int darray_max_f64(darray_t da, double *out) __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Stores the smallest and the largest element of a
+ *        @struct dyn_array in @param min and @param max , in one pass.
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if the
+ *         @struct dyn_array is empty, or EINVAL if the type size does not
+ *         match.
+ *
+ * @warning The result is unspecified if a float element is NaN.
+ */
+extern int darray_minmax_i32(darray_t da, int32_t *min, int32_t *max)
+    __DS_ATTR_NONNULL(1, 2, 3);
+extern int darray_minmax_i64(darray_t da, int64_t *min, int64_t *max)
+    __DS_ATTR_NONNULL(1, 2, 3);
+extern int darray_minmax_u32(darray_t da, uint32_t *min, uint32_t *max)
+    __DS_ATTR_NONNULL(1, 2, 3);
+extern int darray_minmax_u64(darray_t da, uint64_t *min, uint64_t *max)
+    __DS_ATTR_NONNULL(1, 2, 3);
+extern int darray_minmax_f32(darray_t da, float *min, float *max)
+    __DS_ATTR_NONNULL(1, 2, 3);
+extern int darray_minmax_f64(darray_t da, double *min, double *max)
+    __DS_ATTR_NONNULL(1, 2, 3);
+
+
+/**
+ * @brief Stores the index of the first smallest element of a
+ *        @struct dyn_array in @param index .
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if the
+ *         @struct dyn_array is empty, or EINVAL if the type size does not
+ *         match.
+ *
+ * @warning The result is unspecified if a float element is NaN.
+ */
+extern int darray_argmin_i32(darray_t da, size_t *index)
+    __DS_ATTR_NONNULL(1, 2);
+extern int darray_argmin_i64(darray_t da, size_t *index)
+    __DS_ATTR_NONNULL(1, 2);
+extern int darray_argmin_u32(darray_t da, size_t *index)
+    __DS_ATTR_NONNULL(1, 2);
+extern int darray_argmin_u64(darray_t da, size_t *index)
+    __DS_ATTR_NONNULL(1, 2);
+extern int darray_argmin_f32(darray_t da, size_t *index)
+    __DS_ATTR_NONNULL(1, 2);
+extern int darray_argmin_f64(darray_t da, size_t *index)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Stores the index of the first largest element of a
+ *        @struct dyn_array in @param index .
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if the
+ *         @struct dyn_array is empty, or EINVAL if the type size does not
+ *         match.
+ *
+ * @warning The result is unspecified if a float element is NaN.
+ */
+extern int darray_argmax_i32(darray_t da, size_t *index)
+    __DS_ATTR_NONNULL(1, 2);
+extern int darray_argmax_i64(darray_t da, size_t *index)
+    __DS_ATTR_NONNULL(1, 2);
+extern int darray_argmax_u32(darray_t da, size_t *index)
+    __DS_ATTR_NONNULL(1, 2);
+extern int darray_argmax_u64(darray_t da, size_t *index)
+    __DS_ATTR_NONNULL(1, 2);
+extern int darray_argmax_f32(darray_t da, size_t *index)
+    __DS_ATTR_NONNULL(1, 2);
+extern int darray_argmax_f64(darray_t da, size_t *index)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+__DS_END_DECLS
+
+#endif /* _DS_REDUCE_H */
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the declaration of the segment tree `segment_tree`,
+ * alongside with the functions that manipulates it.
+ */
+
+#ifndef _DS_SEGTREE_H
+#define _DS_SEGTREE_H 1
+#define __need_size_t 1
+#include <stddef.h>
+
+#include "ds/__priv/cdefs.h"
+#include "ds/darray.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef segtree_t
+ * @struct segment_tree
+ *
+ * @brief An array of elements answering range queries over an associative
+ *        operation, such as a sum, a minimum or a maximum, and taking
+ *        point updates in O(log n).
+ *
+ * The tree is a single implicit array of twice the size of the elements,
+ * holding the elements in its second half, and the combination of the
+ * entries `2i` and `2i + 1` at every entry `i` of its first half. Queries
+ * and updates walk it bottom up, without recursion.
+ */
+typedef struct segment_tree *segtree_t;
+
+
+/**
+ * @typedef segtree_combine_fn
+ *
+ * @brief The operation of a @struct segment_tree , storing the combination
+ *        of @param left and @param right into @param out .
+ *
+ * The operation must be associative, but does not need to be commutative:
+ * @param left always comes before @param right inside the array.
+ *
+ * @param out Where the result is stored, may be @param left or
+ *            @param right .
+ */
+typedef void (*segtree_combine_fn)(void *out, const void *left,
+                                   const void *right);
+
+
+/**
+ * @brief Allocate a new @struct segment_tree with a custom allocator, built
+ *        from the @param size elements at @param data in O(n).
+ *
+ * @param type_size The size of the type the struct will hold.
+ *
+ * @return A pointer to the allocated @struct segment_tree , or `NULL` on
+ *         failure. `errno` is set to EINVAL if @param type_size or
+ *         @param size is 0.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern segtree_t segtree_new_with_allocator(size_t type_size,
+                                            const void *data, size_t size,
+                                            segtree_combine_fn combine,
+                                            ds_malloc_fn malloc_fn,
+                                            ds_free_fn free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD __DS_ATTR_NONNULL(2, 4);
+
+
+/**
+ * @brief Allocate a new @struct segment_tree , built from the @param size
+ *        elements at @param data in O(n).
+ *
+ * @param type_size The size of the type the struct will hold.
+ *
+ * @return A pointer to the allocated @struct segment_tree , or `NULL` on
+ *         failure. `errno` is set to EINVAL if @param type_size or
+ *         @param size is 0.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::from_darray
+ * @sa ::free
+ */
+extern segtree_t segtree_new(size_t type_size, const void *data, size_t size,
+                             segtree_combine_fn combine)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD __DS_ATTR_NONNULL(2, 4);
+
+
+/**
+ * @brief Allocate a new @struct segment_tree built from the elements of a
+ *        @struct dyn_array in O(n).
+ *
+ * @return A pointer to the allocated @struct segment_tree , or `NULL` on
+ *         failure. `errno` is set to EINVAL if the @struct dyn_array is
+ *         empty.
+ *
+ * @sa ::new
+ */
+extern segtree_t segtree_from_darray(darray_t da, segtree_combine_fn combine)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Frees up a @struct segment_tree .
+ *
+ * @sa ::new
+ */
+extern void segtree_free(segtree_t st) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Replaces the element at @param index with a copy of
+ *        @param value .
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if @param index is
+ *         out of bounds.
+ */
+extern int segtree_set(segtree_t __DS_RESTRICT st, size_t index,
+                       const void *__DS_RESTRICT value)
+    __DS_ATTR_NONNULL(1, 3);
+
+
+/**
+ * @brief Get the element at @param index , or `NULL` if @param index is out
+ *        of bounds.
+ *
+ * @warning The element must be changed through ::set only.
+ */
+extern const void *segtree_at(segtree_t st, size_t index)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Combines the elements from @param from up to, but not including,
+ *        @param to into @param out .
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if the range is
+ *         empty or out of bounds.
+ */
+extern int segtree_query(segtree_t __DS_RESTRICT st, size_t from, size_t to,
+                         void *__DS_RESTRICT out) __DS_ATTR_NONNULL(1, 4);
+
+
+/**
+ * @brief Get the amount of elements of a @struct segment_tree .
+ */
+extern size_t segtree_size(segtree_t st)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_SEGTREE_H */
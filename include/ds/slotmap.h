@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the declaration of the slot map `slot_map`, alongside
+ * with the functions that manipulates it.
+ */
+
+#ifndef _DS_SLOTMAP_H
+#define _DS_SLOTMAP_H 1
+#define __need_size_t 1
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ds/__priv/cdefs.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef slotmap_t
+ * @struct slot_map
+ *
+ * @brief A container handing out stable handles to its elements.
+ *
+ * The elements are stored contiguously and stay contiguous when one is
+ * erased, by moving the last element into its place. Handles go through an
+ * array of slots instead, which is reused through a free list. Every slot
+ * counts how many times it was reused, so a handle to an erased element
+ * is detected instead of aliasing the element that took its slot.
+ */
+typedef struct slot_map *slotmap_t;
+
+
+/**
+ * @typedef slotmap_handle_t
+ *
+ * @brief A handle to an element of a @struct slot_map , holding the slot
+ *        index in its low 32 bits and the slot generation in its high 32
+ *        bits.
+ */
+typedef uint64_t slotmap_handle_t;
+
+
+/**
+ * @brief A handle that never refers to an element.
+ */
+#define SLOTMAP_NULL ((slotmap_handle_t)0)
+
+
+/**
+ * @brief Allocate a new @struct slot_map with a custom allocator.
+ *
+ * @param type_size The size of the type the struct will hold.
+ *
+ * @return A pointer to the allocated @struct slot_map , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern slotmap_t slotmap_new_with_allocator(size_t        type_size,
+                                            ds_malloc_fn  malloc_fn,
+                                            ds_realloc_fn realloc_fn,
+                                            ds_free_fn    free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct slot_map .
+ *
+ * @param type_size The size of the type the struct will hold.
+ *
+ * @return A pointer to the allocated @struct slot_map , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern slotmap_t slotmap_new(size_t type_size)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct slot_map and its internal buffers.
+ *
+ * @sa ::new
+ */
+extern void slotmap_free(slotmap_t sm) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Inserts an element into a @struct slot_map .
+ *
+ * @param data The data copied into the new element, or `NULL` to zero it.
+ *
+ * @return The handle of the new element, or ::SLOTMAP_NULL on failure.
+ *         Check `errno` for more information.
+ *
+ * @sa ::erase
+ */
+extern slotmap_handle_t slotmap_insert(slotmap_t sm, const void *data)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Erases the element of a handle, moving the last element into its
+ *        place.
+ *
+ * @return 0 on success, or -1 and `errno` set to ENOENT if @param handle
+ *         does not refer to an element.
+ *
+ * @sa ::insert
+ */
+extern int slotmap_erase(slotmap_t sm, slotmap_handle_t handle)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Gets the element of a handle.
+ *
+ * @return A pointer to the element, or `NULL` if @param handle does not
+ *         refer to an element, because it was erased for example.
+ *
+ * @warning The pointer is invalidated by ::insert and ::erase, unlike the
+ *          handle.
+ */
+extern void *slotmap_get(slotmap_t sm, slotmap_handle_t handle)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Checks whether a handle refers to an element.
+ *
+ * @return 1 if it does, 0 otherwise.
+ */
+extern int slotmap_contains(slotmap_t sm, slotmap_handle_t handle)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Erases every element, invalidating every handle.
+ */
+extern void slotmap_clear(slotmap_t sm) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Get the contiguous array of the elements, in no particular order.
+ *
+ * @sa ::handle_at
+ */
+extern void *slotmap_data(slotmap_t sm)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the handle of the element at an index of ::data.
+ *
+ * @return The handle, or ::SLOTMAP_NULL and `errno` set to ERANGE if
+ *         @param index is out of range.
+ */
+extern slotmap_handle_t slotmap_handle_at(slotmap_t sm, size_t index)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of elements inside a @struct slot_map .
+ */
+extern size_t slotmap_size(slotmap_t sm)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_SLOTMAP_H */
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * This file contains the declaration of the struct-of-arrays structure
+ * `soa_array`, alongside with the functions that manipulates it.
+ */
+
+#ifndef _DS_SOA_H
+#define _DS_SOA_H 1
+#define __need_size_t 1
+#include <stddef.h>
+
+#include "ds/__priv/cdefs.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef soa_t
+ * @struct soa_array
+ *
+ * @brief A dynamic array of records whose fields are stored column by
+ *        column, each column being its own contiguous buffer.
+ *
+ * All columns share one size and one capacity, and grow the same way
+ * a @struct dyn_array does.
+ */
+typedef struct soa_array *soa_t;
+
+
+/**
+ * @brief Allocate a new @struct soa_array with a custom allocator.
+ *
+ * @param columns      The amount of columns.
+ * @param column_sizes The size of the type each column will hold.
+ *
+ * @return A pointer to the allocated @struct soa_array , or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @note The function will fail and set `errno` to EINVAL if @param columns
+ *       or any of the column sizes is 0.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern soa_t soa_new_with_allocator(size_t columns, const size_t *column_sizes,
+                                    ds_malloc_fn  malloc_fn,
+                                    ds_realloc_fn realloc_fn,
+                                    ds_free_fn    free_fn) __DS_THROW
+    __DS_ATTR_MALLOC __DS_ATTR_NONNULL(2) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct soa_array .
+ *
+ * @param columns      The amount of columns.
+ * @param column_sizes The size of the type each column will hold.
+ *
+ * @return A pointer to the allocated @struct soa_array , or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern soa_t soa_new(size_t columns, const size_t *column_sizes) __DS_THROW
+    __DS_ATTR_MALLOC __DS_ATTR_NONNULL(2) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct soa_array and all of its columns.
+ *
+ * @sa ::new
+ */
+extern void soa_free(soa_t soa) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Ensures a @struct soa_array has at least the specified capacity.
+ *
+ * @param size The minimum number of rows the @struct soa_array
+ *             should be able to hold.
+ *
+ * @return A pointer to the first column's buffer, or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @note The function do nothing if the capacity is larger than or
+ *       equal to @param size
+ * @note The function will fail and set `errno` to EINVAL if @param size is 0.
+ *
+ * @sa ::resize
+ */
+extern void *soa_reserve(soa_t soa, size_t size) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Ensures a @struct soa_array contains the specified amount of rows.
+ *
+ * @param size The amount of rows. Added rows are zeroed.
+ *
+ * @return A pointer to the first column's buffer, or `NULL` on failure.
+ *         Check `errno` for more information.
+ *
+ * @sa ::reserve
+ */
+extern void *soa_resize(soa_t soa, size_t size) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Removes every row of a @struct soa_array .
+ *
+ * @warning The function does not free the columns' buffers.
+ */
+extern void soa_clear(soa_t soa) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Inserts a row at the back of a @struct soa_array .
+ *
+ * @param row One pointer per column, each pointing to the field's data.
+ *
+ * @return 0 on success, or -1 on failure.
+ *         Check `errno` for more information.
+ *
+ * @sa ::pop_back
+ * @sa ::set
+ */
+extern int soa_push_back(soa_t __DS_RESTRICT soa,
+                         const void *const *__DS_RESTRICT row)
+    __DS_ATTR_NONNULL(1, 2);
+
+
+/**
+ * @brief Removes the row at the back of a @struct soa_array .
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if the
+ *         @struct soa_array is empty.
+ *
+ * @sa ::push_back
+ */
+extern int soa_pop_back(soa_t soa) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Erases the row at the specified position, shifting the rows
+ *        after it in every column.
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if @param pos
+ *         is out of range.
+ */
+extern int soa_erase(soa_t soa, size_t pos) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Copies every field of a row out of a @struct soa_array .
+ *
+ * @param row One pointer per column, each pointing to where the field's
+ *            data is copied to.
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if @param index
+ *         is out of range.
+ *
+ * @sa ::set
+ * @sa ::at
+ */
+extern int soa_get(soa_t __DS_RESTRICT soa, size_t index,
+                   void *const *__DS_RESTRICT row) __DS_ATTR_NONNULL(1, 3);
+
+
+/**
+ * @brief Overwrites every field of a row of a @struct soa_array .
+ *
+ * @param row One pointer per column, each pointing to the field's data.
+ *
+ * @return 0 on success, or -1 and set `errno` to ERANGE if @param index
+ *         is out of range.
+ *
+ * @sa ::get
+ */
+extern int soa_set(soa_t __DS_RESTRICT soa, size_t index,
+                   const void *const *__DS_RESTRICT row)
+    __DS_ATTR_NONNULL(1, 3);
+
+
+/**
+ * @brief Gets a single field of a row.
+ *
+ * @return The pointer to the field, or `NULL` and set `errno` to ERANGE if
+ *         @param column or @param index is out of range.
+ */
+extern void *soa_at(soa_t soa, size_t column, size_t index)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the contiguous buffer holding a column.
+ *
+ * @return The buffer, or `NULL` if @param column is out of range or
+ *         nothing has been allocated yet.
+ *
+ * @warning The buffer moves when the @struct soa_array grows.
+ */
+extern void *soa_column(soa_t soa, size_t column)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the type size of a column.
+ *
+ * @return The type size, or 0 if @param column is out of range.
+ */
+extern size_t soa_column_size(soa_t soa, size_t column)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of columns a @struct soa_array has.
+ */
+extern size_t soa_columns(soa_t soa)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of rows a @struct soa_array holds.
+ */
+extern size_t soa_size(soa_t soa)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of rows a @struct soa_array can hold.
+ */
+extern size_t soa_capacity(soa_t soa)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_SOA_H */
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the declaration of the sparse set `sparse_set`,
+ * alongside with the functions that manipulates it.
+ */
+
+#ifndef _DS_SPARSE_H
+#define _DS_SPARSE_H 1
+#define __need_size_t 1
+#include <stddef.h>
+
+#include "ds/__priv/cdefs.h"
+
+__DS_BEGIN_DECLS
+
+
+/**
+ * @typedef sparse_t
+ * @struct sparse_set
+ *
+ * @brief A set of integer keys, each with an optional fixed-size value.
+ *
+ * A sparse array indexed by key points into a dense array of the keys and
+ * their values. Insertion, removal, lookup and clearing are all O(1), and
+ * the keys and values can be iterated as plain contiguous arrays.
+ *
+ * The sparse array grows to the largest key inserted, so keys should be
+ * small integers such as indices or entity IDs.
+ */
+typedef struct sparse_set *sparse_t;
+
+
+/**
+ * @brief Allocate a new @struct sparse_set with a custom allocator.
+ *
+ * @param value_size The size of the value stored with every key, or 0 to
+ *                   store keys only.
+ *
+ * @return A pointer to the allocated @struct sparse_set , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new
+ * @sa ::free
+ */
+extern sparse_t sparse_new_with_allocator(size_t value_size,
+                                          ds_malloc_fn  malloc_fn,
+                                          ds_realloc_fn realloc_fn,
+                                          ds_free_fn    free_fn)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Allocate a new @struct sparse_set .
+ *
+ * @param value_size The size of the value stored with every key, or 0 to
+ *                   store keys only.
+ *
+ * @return A pointer to the allocated @struct sparse_set , or `NULL` on
+ *         failure. Check `errno` for more information.
+ *
+ * @sa ::new_with_allocator
+ * @sa ::free
+ */
+extern sparse_t sparse_new(size_t value_size)
+    __DS_THROW __DS_ATTR_MALLOC __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Frees up a @struct sparse_set and its internal arrays.
+ *
+ * @sa ::new
+ */
+extern void sparse_free(sparse_t ss) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Inserts a key into a @struct sparse_set .
+ *
+ * @param value The value copied with @param key , or `NULL` to zero it.
+ *
+ * @return A pointer to the stored value, or `NULL` on failure. `errno` is
+ *         set to EEXIST if @param key is already inside the
+ *         @struct sparse_set . With a value size of 0, the pointer points
+ *         to the stored key instead.
+ *
+ * @warning The pointer is invalidated by ::insert and ::erase.
+ *
+ * @sa ::erase
+ */
+extern void *sparse_insert(sparse_t ss, size_t key, const void *value)
+    __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Erases a key from a @struct sparse_set , moving the last key of the
+ *        dense array into its place.
+ *
+ * @return 0 on success, or -1 and `errno` set to ENOENT if @param key is
+ *         not inside the @struct sparse_set .
+ *
+ * @sa ::insert
+ */
+extern int sparse_erase(sparse_t ss, size_t key) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Checks whether a key is inside a @struct sparse_set .
+ *
+ * @return 1 if @param key is inside, 0 otherwise.
+ */
+extern int sparse_contains(sparse_t ss, size_t key)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Gets the value of a key.
+ *
+ * @return A pointer to the stored value, or `NULL` if @param key is not
+ *         inside the @struct sparse_set . With a value size of 0, the
+ *         pointer points to the stored key instead.
+ *
+ * @warning The pointer is invalidated by ::insert and ::erase.
+ */
+extern void *sparse_get(sparse_t ss, size_t key)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Removes every key from a @struct sparse_set in O(1).
+ */
+extern void sparse_clear(sparse_t ss) __DS_ATTR_NONNULL(1);
+
+
+/**
+ * @brief Get the dense array of keys, in no particular order.
+ *
+ * @return A pointer to ::size keys, the value of the key at index `i`
+ *         being at index `i` of ::values.
+ */
+extern const size_t *sparse_keys(sparse_t ss)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the dense array of values, in the order of ::keys.
+ */
+extern void *sparse_values(sparse_t ss)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Get the amount of keys inside a @struct sparse_set .
+ */
+extern size_t sparse_size(sparse_t ss)
+    __DS_ATTR_NONNULL(1) __DS_ATTR_PURE __DS_ATTR_NODISCARD;
+
+
+__DS_END_DECLS
+
+#endif /* _DS_SPARSE_H */
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2025 Kei <RQuarx@protonmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * This file contains the switch of the thread-local cache that libds uses
+ * for its small internal objects, alongside with the functions that
+ * manage it.
+ */
+
+#ifndef _DS_TCACHE_H
+#define _DS_TCACHE_H 1
+
+#include "ds/__priv/cdefs.h"
+
+__DS_BEGIN_DECLS
+
+
+/*
+ * List nodes and darray handles created without a custom allocator are
+ * taken from, and given back to, a per-thread cache when it is enabled.
+ * Each thread keeps two magazines of objects per object size, and trades
+ * whole magazines with a global depot when both run full or empty, so the
+ * system allocator and the depot lock are only reached once every few
+ * dozen operations.
+ *
+ * Objects are not owned by the thread that allocated them: an object freed
+ * by another thread simply joins that thread's magazine. A thread's
+ * magazines are handed to the depot when it exits.
+ *
+ * The cache starts disabled unless libds was configured with
+ * `-Dthread-cache=true`, and can be switched at any time.
+ */
+
+
+/**
+ * @brief Enables or disables the thread-local cache for every thread.
+ *
+ * @param enabled 0 to disable the cache, any other value to enable it.
+ *
+ * @note Objects allocated while the cache was disabled may be freed while
+ *       it is enabled, and the other way around.
+ */
+extern void tcache_set_enabled(int enabled);
+
+
+/**
+ * @brief Checks whether the thread-local cache is enabled.
+ *
+ * @return 1 if the cache is enabled, 0 otherwise.
+ */
+extern int tcache_enabled(void) __DS_ATTR_NODISCARD;
+
+
+/**
+ * @brief Gives every object cached by the calling thread to the depot.
+ *
+ * @sa ::trim
+ */
+extern void tcache_flush(void);
+
+
+/**
+ * @brief Frees every object held by the depot with the system allocator.
+ *
+ * @note Objects still cached by other threads are left untouched, call
+ *       ::flush on them first to release everything.
+ */
+extern void tcache_trim(void);
+
+
+__DS_END_DECLS
+
+#endif /* _DS_TCACHE_H */
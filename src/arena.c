@@ -0,0 +1,348 @@
+#include "ds/arena.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_FREE(arena, ptr) \
+    ELSE_IF_NULL(((arena_t)arena)->free_fn, free, ptr)
+
+#define ARENA_ALIGN         16
+#define ARENA_DEFAULT_CHUNK ((size_t)64 << 10)
+
+#define ARENA_ROUND(size) \
+    (((size) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+/* the room an allocation header takes in front of every allocation */
+#define ARENA_HEADER ARENA_ROUND(sizeof(struct arena_header))
+
+#define ARENA_HEADER_OF(ptr) \
+    ((struct arena_header *)((unsigned char *)(ptr) - ARENA_HEADER))
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ARENA_THREAD __thread
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define ARENA_THREAD _Thread_local
+#else
+#define ARENA_THREAD
+#endif
+
+
+/* the chunks past `current` inside the chain are unused */
+struct arena_chunk
+{
+    struct arena_chunk *next;
+
+    unsigned char *data;
+    size_t         size;
+    size_t         used;
+};
+
+
+/* in front of every allocation, so it can be resized and freed on its own */
+struct arena_header
+{
+    arena_t arena;
+
+    /* the size of the allocation, rounded up to ARENA_ALIGN */
+    size_t size;
+};
+
+
+struct arena
+{
+    struct arena_chunk *first;
+    struct arena_chunk *current;
+
+    size_t chunk_size;
+    size_t size;
+
+    ds_malloc_fn malloc_fn;
+    ds_free_fn   free_fn;
+};
+
+
+static ARENA_THREAD arena_t arena_active;
+
+
+static struct arena_chunk *
+arena_chunk_new(arena_t arena, size_t size)
+{
+    const size_t head = sizeof(struct arena_chunk) + ARENA_ALIGN - 1;
+
+    if (size > SIZE_MAX - head)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    struct arena_chunk *chunk
+        = ELSE_IF_NULL(arena->malloc_fn, malloc, head + size);
+    if (chunk == NULL) return NULL;
+
+    uintptr_t data = ((uintptr_t)(chunk + 1) + ARENA_ALIGN - 1)
+                   & ~(uintptr_t)(ARENA_ALIGN - 1);
+
+    chunk->next = NULL;
+    chunk->data = (unsigned char *)data;
+    chunk->size = size;
+    chunk->used = 0;
+
+    arena->size += size;
+    return chunk;
+}
+
+
+/*
+ * Moves the arena onto a chunk with room for @need bytes, the next unused
+ * one if it is large enough, or a new one linked in front of it.
+ */
+static struct arena_chunk *
+arena_advance(arena_t arena, size_t need)
+{
+    struct arena_chunk *next = arena->current->next;
+
+    if (next == NULL || next->size < need)
+    {
+        struct arena_chunk *chunk = arena_chunk_new(
+            arena, need > arena->chunk_size ? need : arena->chunk_size);
+        if (chunk == NULL) return NULL;
+
+        chunk->next = next;
+        next        = chunk;
+
+        arena->current->next = chunk;
+    }
+
+    next->used     = 0;
+    arena->current = next;
+    return next;
+}
+
+
+/* checks whether @hdr is the most recent allocation of its arena */
+static int
+arena_is_top(const struct arena_header *hdr)
+{
+    const struct arena_chunk *chunk = hdr->arena->current;
+
+    return (const unsigned char *)hdr + ARENA_HEADER + hdr->size
+        == chunk->data + chunk->used;
+}
+
+
+arena_t
+arena_new_with_allocator(size_t chunk_size, ds_malloc_fn malloc_fn,
+                         ds_free_fn free_fn)
+{
+    if (chunk_size == 0) chunk_size = ARENA_DEFAULT_CHUNK;
+
+    arena_t arena = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct arena));
+    if (arena == NULL) return NULL;
+
+    arena->chunk_size = ARENA_ROUND(chunk_size);
+    arena->size       = 0;
+    arena->malloc_fn  = malloc_fn;
+    arena->free_fn    = free_fn;
+
+    if (arena->chunk_size < chunk_size)
+    {
+        ARENA_FREE(arena, arena);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    arena->first = arena_chunk_new(arena, arena->chunk_size);
+    if (arena->first == NULL)
+    {
+        ARENA_FREE(arena, arena);
+        return NULL;
+    }
+
+    arena->current = arena->first;
+    return arena;
+}
+
+
+arena_t
+arena_new(size_t chunk_size)
+{
+    return arena_new_with_allocator(chunk_size, NULL, NULL);
+}
+
+
+void
+arena_free(arena_t arena)
+{
+    struct arena_chunk *chunk = arena->first;
+
+    while (chunk != NULL)
+    {
+        struct arena_chunk *next = chunk->next;
+        ARENA_FREE(arena, chunk);
+        chunk = next;
+    }
+
+    if (arena_active == arena) arena_active = NULL;
+    ARENA_FREE(arena, arena);
+}
+
+
+void *
+arena_alloc(arena_t arena, size_t size)
+{
+    if (size > SIZE_MAX - ARENA_HEADER - ARENA_ALIGN)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    const size_t        rounded = ARENA_ROUND(size);
+    const size_t        need    = ARENA_HEADER + rounded;
+    struct arena_chunk *chunk   = arena->current;
+
+    if (chunk->size - chunk->used < need)
+    {
+        chunk = arena_advance(arena, need);
+        if (chunk == NULL) return NULL;
+    }
+
+    struct arena_header *hdr
+        = (struct arena_header *)(chunk->data + chunk->used);
+    chunk->used += need;
+
+    hdr->arena = arena;
+    hdr->size  = rounded;
+    return (unsigned char *)hdr + ARENA_HEADER;
+}
+
+
+void
+arena_reset(arena_t arena)
+{
+    arena->current       = arena->first;
+    arena->current->used = 0;
+}
+
+
+void
+arena_trim(arena_t arena)
+{
+    struct arena_chunk *chunk = arena->current->next;
+    arena->current->next      = NULL;
+
+    while (chunk != NULL)
+    {
+        struct arena_chunk *next  = chunk->next;
+        arena->size              -= chunk->size;
+        ARENA_FREE(arena, chunk);
+        chunk = next;
+    }
+}
+
+
+arena_mark_t
+arena_mark(arena_t arena)
+{
+    arena_mark_t mark;
+
+    mark.chunk = arena->current;
+    mark.used  = arena->current->used;
+    return mark;
+}
+
+
+void
+arena_rewind(arena_t arena, arena_mark_t mark)
+{
+    arena->current       = mark.chunk;
+    arena->current->used = mark.used;
+}
+
+
+size_t
+arena_size(arena_t arena)
+{
+    return arena->size;
+}
+
+
+arena_t
+arena_use(arena_t arena)
+{
+    arena_t previous = arena_active;
+    arena_active     = arena;
+    return previous;
+}
+
+
+arena_t
+arena_current(void)
+{
+    return arena_active;
+}
+
+
+void *
+arena_malloc(size_t size)
+{
+    if (arena_active == NULL)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    return arena_alloc(arena_active, size);
+}
+
+
+void *
+arena_realloc(void *ptr, size_t size)
+{
+    if (ptr == NULL) return arena_malloc(size);
+
+    if (size > SIZE_MAX - ARENA_HEADER - ARENA_ALIGN)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    struct arena_header *hdr     = ARENA_HEADER_OF(ptr);
+    struct arena_chunk  *chunk   = hdr->arena->current;
+    const size_t         rounded = ARENA_ROUND(size);
+
+    if (arena_is_top(hdr))
+    {
+        if (rounded <= hdr->size)
+        {
+            chunk->used -= hdr->size - rounded;
+            hdr->size    = rounded;
+            return ptr;
+        }
+
+        if (chunk->size - chunk->used >= rounded - hdr->size)
+        {
+            chunk->used += rounded - hdr->size;
+            hdr->size    = rounded;
+            return ptr;
+        }
+    }
+    else if (rounded <= hdr->size)
+        return ptr;
+
+    void *moved = arena_alloc(hdr->arena, size);
+    if (moved != NULL) memcpy(moved, ptr, hdr->size);
+    return moved;
+}
+
+
+void
+arena_dealloc(void *ptr)
+{
+    if (ptr == NULL) return;
+
+    struct arena_header *hdr = ARENA_HEADER_OF(ptr);
+    if (arena_is_top(hdr))
+        hdr->arena->current->used -= ARENA_HEADER + hdr->size;
+}
@@ -0,0 +1,966 @@
+#include "ds/art.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "ds/__priv/bits.h"
+
+#define ART_FREE(art, ptr) \
+    ELSE_IF_NULL(((art_t)art)->free_fn, free, ptr)
+
+#define ART_MALLOC(art, size) \
+    ELSE_IF_NULL(((art_t)art)->malloc_fn, malloc, size)
+
+/* the most prefix bytes stored in a node, the rest is checked at a leaf */
+#define ART_MAX_PREFIX 10
+
+/* children are either nodes or leaves, leaves are tagged by the low bit */
+#define ART_IS_LEAF(ptr) (((uintptr_t)(ptr)) & 1)
+#define ART_LEAF(ptr) \
+    ((struct art_leaf *)(void *)((uintptr_t)(ptr) & ~(uintptr_t)1))
+#define ART_TAG(leaf) ((void *)((uintptr_t)(leaf) | 1))
+
+#define ART_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+
+enum art_type
+{
+    ART_NODE4,
+    ART_NODE16,
+    ART_NODE48,
+    ART_NODE256,
+};
+
+
+struct art_leaf
+{
+    void         *value;
+    size_t        len;
+    unsigned char key[];
+};
+
+
+struct art_node
+{
+    uint8_t  type;
+    uint16_t count;
+
+    /* the bytes every key below this node shares before branching */
+    uint32_t      prefix_len;
+    unsigned char prefix[ART_MAX_PREFIX];
+
+    /* the key that ends right after the prefix, if any */
+    struct art_leaf *term;
+};
+
+
+struct art_node4
+{
+    struct art_node node;
+    unsigned char   keys[4];
+    void           *children[4];
+};
+
+
+struct art_node16
+{
+    struct art_node node;
+    unsigned char   keys[16];
+    void           *children[16];
+};
+
+
+/* `index` maps a byte to its position inside `children` plus one */
+struct art_node48
+{
+    struct art_node node;
+    unsigned char   index[256];
+    void           *children[48];
+};
+
+
+struct art_node256
+{
+    struct art_node node;
+    void           *children[256];
+};
+
+
+struct radix_tree
+{
+    void  *root;
+    size_t size;
+
+    ds_malloc_fn malloc_fn;
+    ds_free_fn   free_fn;
+};
+
+
+static const size_t art_node_sizes[] = {
+    [ART_NODE4]   = sizeof(struct art_node4),
+    [ART_NODE16]  = sizeof(struct art_node16),
+    [ART_NODE48]  = sizeof(struct art_node48),
+    [ART_NODE256] = sizeof(struct art_node256),
+};
+
+
+static struct art_node *
+art_alloc_node(art_t art, enum art_type type)
+{
+    struct art_node *node = ART_MALLOC(art, art_node_sizes[type]);
+    if (node == NULL) return NULL;
+
+    memset(node, 0, art_node_sizes[type]);
+    node->type = (uint8_t)type;
+    return node;
+}
+
+
+static void
+art_copy_header(struct art_node *dest, const struct art_node *src)
+{
+    dest->count      = src->count;
+    dest->prefix_len = src->prefix_len;
+    dest->term       = src->term;
+    memcpy(dest->prefix, src->prefix, ART_MAX_PREFIX);
+}
+
+
+static int
+art_leaf_matches(const struct art_leaf *leaf, const unsigned char *key,
+                 size_t len)
+{
+    return leaf->len == len && memcmp(leaf->key, key, len) == 0;
+}
+
+
+static void **
+art_find_child(struct art_node *node, unsigned char byte)
+{
+    switch (node->type)
+    {
+    case ART_NODE4:
+        {
+            struct art_node4 *n = (struct art_node4 *)node;
+            for (size_t i = 0; i < node->count; i++)
+                if (n->keys[i] == byte) return &n->children[i];
+            return NULL;
+        }
+    case ART_NODE16:
+        {
+            struct art_node16 *n = (struct art_node16 *)node;
+#ifdef __SSE2__
+            /* compare the byte against all 16 keys at once */
+            __m128i keys = _mm_loadu_si128((const __m128i *)n->keys);
+            __m128i cmp  = _mm_cmpeq_epi8(_mm_set1_epi8((char)byte), keys);
+            unsigned mask = (unsigned)_mm_movemask_epi8(cmp)
+                          & ((1U << node->count) - 1);
+
+            return mask != 0 ? &n->children[ds_ctz64(mask)] : NULL;
+#else
+            for (size_t i = 0; i < node->count; i++)
+                if (n->keys[i] == byte) return &n->children[i];
+            return NULL;
+#endif
+        }
+    case ART_NODE48:
+        {
+            struct art_node48 *n = (struct art_node48 *)node;
+            return n->index[byte] != 0 ? &n->children[n->index[byte] - 1]
+                                       : NULL;
+        }
+    default:
+        {
+            struct art_node256 *n = (struct art_node256 *)node;
+            return n->children[byte] != NULL ? &n->children[byte] : NULL;
+        }
+    }
+}
+
+
+/* the leaf with the smallest key below @ptr */
+static struct art_leaf *
+art_minimum(const void *ptr)
+{
+    while (!ART_IS_LEAF(ptr))
+    {
+        const struct art_node *node = ptr;
+        if (node->term != NULL) return node->term;
+
+        switch (node->type)
+        {
+        case ART_NODE4:
+            ptr = ((const struct art_node4 *)node)->children[0];
+            break;
+        case ART_NODE16:
+            ptr = ((const struct art_node16 *)node)->children[0];
+            break;
+        case ART_NODE48:
+            {
+                const struct art_node48 *n = (const struct art_node48 *)node;
+                size_t                   c = 0;
+
+                while (n->index[c] == 0) c++;
+                ptr = n->children[n->index[c] - 1];
+                break;
+            }
+        default:
+            {
+                const struct art_node256 *n
+                    = (const struct art_node256 *)node;
+                size_t c = 0;
+
+                while (n->children[c] == NULL) c++;
+                ptr = n->children[c];
+                break;
+            }
+        }
+    }
+
+    return ART_LEAF(ptr);
+}
+
+
+/* the amount of stored prefix bytes of @node matching the key */
+static size_t
+art_check_prefix(const struct art_node *node, const unsigned char *key,
+                 size_t len, size_t depth)
+{
+    size_t max = ART_MIN(ART_MIN(node->prefix_len, ART_MAX_PREFIX),
+                         len - depth);
+    size_t i   = 0;
+
+    while (i < max && node->prefix[i] == key[depth + i]) i++;
+    return i;
+}
+
+
+/*
+ * Like art_check_prefix, but checks the whole prefix, reading the bytes
+ * that are not stored inside @node from one of its leaves.
+ */
+static size_t
+art_prefix_mismatch(const struct art_node *node, const unsigned char *key,
+                    size_t len, size_t depth)
+{
+    size_t i = art_check_prefix(node, key, len, depth);
+    if (i < ART_MAX_PREFIX || node->prefix_len <= ART_MAX_PREFIX) return i;
+
+    const struct art_leaf *leaf = art_minimum(node);
+    size_t max = ART_MIN(ART_MIN(leaf->len, len) - depth, node->prefix_len);
+
+    while (i < max && leaf->key[depth + i] == key[depth + i]) i++;
+    return i;
+}
+
+
+/* adds a child to a sorted node that has room for it */
+static void
+art_add_sorted(unsigned char *keys, void **children, uint16_t *count,
+               unsigned char byte, void *child)
+{
+    size_t i = 0;
+    while (i < *count && keys[i] < byte) i++;
+
+    memmove(keys + i + 1, keys + i, *count - i);
+    memmove(children + i + 1, children + i, (*count - i) * sizeof(void *));
+
+    keys[i]     = byte;
+    children[i] = child;
+    (*count)++;
+}
+
+
+/*
+ * Adds a child to @node, which lives at @ref. A full node is replaced by a
+ * larger one.
+ */
+static int
+art_add_child(art_t art, void **ref, struct art_node *node,
+              unsigned char byte, void *child)
+{
+    struct art_node *grown;
+
+    switch (node->type)
+    {
+    case ART_NODE4:
+        {
+            struct art_node4 *n = (struct art_node4 *)node;
+            if (node->count < 4)
+            {
+                art_add_sorted(n->keys, n->children, &node->count, byte,
+                               child);
+                return 0;
+            }
+
+            if ((grown = art_alloc_node(art, ART_NODE16)) == NULL) return -1;
+
+            struct art_node16 *g = (struct art_node16 *)grown;
+            memcpy(g->keys, n->keys, sizeof(n->keys));
+            memcpy(g->children, n->children, sizeof(n->children));
+            break;
+        }
+    case ART_NODE16:
+        {
+            struct art_node16 *n = (struct art_node16 *)node;
+            if (node->count < 16)
+            {
+                art_add_sorted(n->keys, n->children, &node->count, byte,
+                               child);
+                return 0;
+            }
+
+            if ((grown = art_alloc_node(art, ART_NODE48)) == NULL) return -1;
+
+            struct art_node48 *g = (struct art_node48 *)grown;
+            memcpy(g->children, n->children, sizeof(n->children));
+            for (size_t i = 0; i < 16; i++)
+                g->index[n->keys[i]] = (unsigned char)(i + 1);
+            break;
+        }
+    case ART_NODE48:
+        {
+            struct art_node48 *n = (struct art_node48 *)node;
+            if (node->count < 48)
+            {
+                size_t pos = 0;
+                while (n->children[pos] != NULL) pos++;
+
+                n->children[pos] = child;
+                n->index[byte]   = (unsigned char)(pos + 1);
+                node->count++;
+                return 0;
+            }
+
+            if ((grown = art_alloc_node(art, ART_NODE256)) == NULL) return -1;
+
+            struct art_node256 *g = (struct art_node256 *)grown;
+            for (size_t c = 0; c < 256; c++)
+                if (n->index[c] != 0)
+                    g->children[c] = n->children[n->index[c] - 1];
+            break;
+        }
+    default:
+        {
+            struct art_node256 *n = (struct art_node256 *)node;
+            n->children[byte]     = child;
+            node->count++;
+            return 0;
+        }
+    }
+
+    art_copy_header(grown, node);
+    ART_FREE(art, node);
+
+    *ref = grown;
+    return art_add_child(art, ref, grown, byte, child);
+}
+
+
+/* puts a leaf into a new node4, as its term if it ends at @depth */
+static void
+art_place(struct art_node *node, struct art_leaf *leaf, size_t depth)
+{
+    struct art_node4 *n = (struct art_node4 *)node;
+
+    if (leaf->len == depth)
+        node->term = leaf;
+    else
+        art_add_sorted(n->keys, n->children, &node->count, leaf->key[depth],
+                       ART_TAG(leaf));
+}
+
+
+static int
+art_insert_at(art_t art, void **ref, size_t depth, struct art_leaf *leaf)
+{
+    const unsigned char *key = leaf->key;
+    const size_t         len = leaf->len;
+
+    if (*ref == NULL)
+    {
+        *ref = ART_TAG(leaf);
+        return 0;
+    }
+
+    /* two leaves become a node4 holding both */
+    if (ART_IS_LEAF(*ref))
+    {
+        struct art_leaf *other = ART_LEAF(*ref);
+        if (art_leaf_matches(other, key, len))
+        {
+            errno = EEXIST;
+            return -1;
+        }
+
+        struct art_node *node = art_alloc_node(art, ART_NODE4);
+        if (node == NULL) return -1;
+
+        size_t limit  = ART_MIN(other->len, len);
+        size_t common = depth;
+        while (common < limit && other->key[common] == key[common]) common++;
+
+        node->prefix_len = (uint32_t)(common - depth);
+        memcpy(node->prefix, key + depth,
+               ART_MIN(node->prefix_len, ART_MAX_PREFIX));
+
+        art_place(node, other, common);
+        art_place(node, leaf, common);
+
+        *ref = node;
+        return 0;
+    }
+
+    struct art_node *node = *ref;
+
+    /* the key leaves the prefix, which is split at the mismatch */
+    if (node->prefix_len != 0)
+    {
+        size_t diff = art_prefix_mismatch(node, key, len, depth);
+        if (diff < node->prefix_len)
+        {
+            struct art_node *parent = art_alloc_node(art, ART_NODE4);
+            if (parent == NULL) return -1;
+
+            parent->prefix_len = (uint32_t)diff;
+            memcpy(parent->prefix, node->prefix, ART_MIN(diff, ART_MAX_PREFIX));
+
+            struct art_node4 *p = (struct art_node4 *)parent;
+            if (node->prefix_len <= ART_MAX_PREFIX)
+            {
+                art_add_sorted(p->keys, p->children, &parent->count,
+                               node->prefix[diff], node);
+
+                node->prefix_len -= (uint32_t)(diff + 1);
+                memmove(node->prefix, node->prefix + diff + 1,
+                        node->prefix_len);
+            }
+            else
+            {
+                const struct art_leaf *min = art_minimum(node);
+                art_add_sorted(p->keys, p->children, &parent->count,
+                               min->key[depth + diff], node);
+
+                node->prefix_len -= (uint32_t)(diff + 1);
+                memcpy(node->prefix, min->key + depth + diff + 1,
+                       ART_MIN(node->prefix_len, ART_MAX_PREFIX));
+            }
+
+            art_place(parent, leaf, depth + diff);
+            *ref = parent;
+            return 0;
+        }
+
+        depth += node->prefix_len;
+    }
+
+    if (depth == len)
+    {
+        if (node->term != NULL)
+        {
+            errno = EEXIST;
+            return -1;
+        }
+
+        node->term = leaf;
+        return 0;
+    }
+
+    void **child = art_find_child(node, key[depth]);
+    if (child != NULL) return art_insert_at(art, child, depth + 1, leaf);
+
+    return art_add_child(art, ref, node, key[depth], ART_TAG(leaf));
+}
+
+
+/*
+ * Replaces a node4 at @ref by what it holds once it holds a single key or
+ * child, merging the prefix of a child node with its own.
+ */
+static void
+art_collapse(art_t art, void **ref)
+{
+    struct art_node *node = *ref;
+    if (node->type != ART_NODE4 || node->count + (node->term != NULL) > 1)
+        return;
+
+    if (node->count == 0)
+    {
+        *ref = node->term != NULL ? ART_TAG(node->term) : NULL;
+        ART_FREE(art, node);
+        return;
+    }
+
+    struct art_node4 *n     = (struct art_node4 *)node;
+    void             *child = n->children[0];
+
+    if (!ART_IS_LEAF(child))
+    {
+        struct art_node *c   = child;
+        size_t           len = node->prefix_len;
+
+        if (len < ART_MAX_PREFIX) node->prefix[len++] = n->keys[0];
+        if (len < ART_MAX_PREFIX)
+        {
+            size_t sub = ART_MIN(c->prefix_len, ART_MAX_PREFIX - len);
+            memcpy(node->prefix + len, c->prefix, sub);
+            len += sub;
+        }
+
+        memcpy(c->prefix, node->prefix, ART_MIN(len, ART_MAX_PREFIX));
+        c->prefix_len += node->prefix_len + 1;
+    }
+
+    *ref = child;
+    ART_FREE(art, node);
+}
+
+
+/*
+ * Removes the child @slot of @node, which lives at @ref, replacing the
+ * node by a smaller one when it gets sparse enough.
+ */
+static void
+art_remove_child(art_t art, void **ref, struct art_node *node,
+                 unsigned char byte, void **slot)
+{
+    struct art_node *shrunk = NULL;
+
+    switch (node->type)
+    {
+    case ART_NODE4:
+    case ART_NODE16:
+        {
+            unsigned char *keys = node->type == ART_NODE4
+                                    ? ((struct art_node4 *)node)->keys
+                                    : ((struct art_node16 *)node)->keys;
+            void **children = node->type == ART_NODE4
+                                ? ((struct art_node4 *)node)->children
+                                : ((struct art_node16 *)node)->children;
+            size_t i = (size_t)(slot - children);
+
+            memmove(keys + i, keys + i + 1, node->count - i - 1);
+            memmove(children + i, children + i + 1,
+                    (node->count - i - 1) * sizeof(void *));
+            node->count--;
+
+            if (node->type == ART_NODE4 || node->count != 3) break;
+            if ((shrunk = art_alloc_node(art, ART_NODE4)) == NULL) break;
+
+            struct art_node4 *s = (struct art_node4 *)shrunk;
+            memcpy(s->keys, keys, 3);
+            memcpy(s->children, children, 3 * sizeof(void *));
+            break;
+        }
+    case ART_NODE48:
+        {
+            struct art_node48 *n = (struct art_node48 *)node;
+
+            *slot          = NULL;
+            n->index[byte] = 0;
+            node->count--;
+
+            if (node->count != 12) break;
+            if ((shrunk = art_alloc_node(art, ART_NODE16)) == NULL) break;
+
+            struct art_node16 *s = (struct art_node16 *)shrunk;
+            for (size_t c = 0, i = 0; c < 256; c++)
+                if (n->index[c] != 0)
+                {
+                    s->keys[i]       = (unsigned char)c;
+                    s->children[i++] = n->children[n->index[c] - 1];
+                }
+            break;
+        }
+    default:
+        {
+            struct art_node256 *n = (struct art_node256 *)node;
+
+            *slot = NULL;
+            node->count--;
+
+            if (node->count != 37) break;
+            if ((shrunk = art_alloc_node(art, ART_NODE48)) == NULL) break;
+
+            struct art_node48 *s = (struct art_node48 *)shrunk;
+            for (size_t c = 0, pos = 0; c < 256; c++)
+                if (n->children[c] != NULL)
+                {
+                    s->index[c]        = (unsigned char)(pos + 1);
+                    s->children[pos++] = n->children[c];
+                }
+            break;
+        }
+    }
+
+    /* a failed shrink only leaves the node larger than it needs to be */
+    if (shrunk != NULL)
+    {
+        art_copy_header(shrunk, node);
+        ART_FREE(art, node);
+        *ref = node = shrunk;
+    }
+
+    art_collapse(art, ref);
+}
+
+
+static int
+art_erase_at(art_t art, void **ref, size_t depth, const unsigned char *key,
+             size_t len)
+{
+    struct art_node *node = *ref;
+
+    if (node->prefix_len != 0)
+    {
+        if (art_check_prefix(node, key, len, depth)
+            != ART_MIN(node->prefix_len, ART_MAX_PREFIX))
+            goto noent;
+        depth += node->prefix_len;
+    }
+
+    if (depth > len) goto noent;
+    if (depth == len)
+    {
+        struct art_leaf *term = node->term;
+        if (term == NULL || !art_leaf_matches(term, key, len)) goto noent;
+
+        node->term = NULL;
+        ART_FREE(art, term);
+        art_collapse(art, ref);
+        return 0;
+    }
+
+    void **child = art_find_child(node, key[depth]);
+    if (child == NULL) goto noent;
+
+    if (!ART_IS_LEAF(*child))
+        return art_erase_at(art, child, depth + 1, key, len);
+
+    struct art_leaf *leaf = ART_LEAF(*child);
+    if (!art_leaf_matches(leaf, key, len)) goto noent;
+
+    art_remove_child(art, ref, node, key[depth], child);
+    ART_FREE(art, leaf);
+    return 0;
+
+noent:
+    errno = ENOENT;
+    return -1;
+}
+
+
+static void
+art_free_ptr(art_t art, void *ptr)
+{
+    if (ART_IS_LEAF(ptr))
+    {
+        ART_FREE(art, ART_LEAF(ptr));
+        return;
+    }
+
+    struct art_node *node = ptr;
+    if (node->term != NULL) ART_FREE(art, node->term);
+
+    switch (node->type)
+    {
+    case ART_NODE4:
+        for (size_t i = 0; i < node->count; i++)
+            art_free_ptr(art, ((struct art_node4 *)node)->children[i]);
+        break;
+    case ART_NODE16:
+        for (size_t i = 0; i < node->count; i++)
+            art_free_ptr(art, ((struct art_node16 *)node)->children[i]);
+        break;
+    case ART_NODE48:
+        for (size_t i = 0; i < 48; i++)
+        {
+            void *child = ((struct art_node48 *)node)->children[i];
+            if (child != NULL) art_free_ptr(art, child);
+        }
+        break;
+    default:
+        for (size_t c = 0; c < 256; c++)
+        {
+            void *child = ((struct art_node256 *)node)->children[c];
+            if (child != NULL) art_free_ptr(art, child);
+        }
+        break;
+    }
+
+    ART_FREE(art, node);
+}
+
+
+/* visits every key below @ptr in order */
+static int
+art_iter(void *ptr, art_iter_fn fn, void *data)
+{
+    if (ART_IS_LEAF(ptr))
+    {
+        struct art_leaf *leaf = ART_LEAF(ptr);
+        return fn(leaf->key, leaf->len, leaf->value, data);
+    }
+
+    struct art_node *node = ptr;
+    int              res  = 0;
+
+    /* the term is a prefix of every other key below the node */
+    if (node->term != NULL)
+    {
+        res = fn(node->term->key, node->term->len, node->term->value, data);
+        if (res != 0) return res;
+    }
+
+    switch (node->type)
+    {
+    case ART_NODE4:
+        for (size_t i = 0; i < node->count && res == 0; i++)
+            res = art_iter(((struct art_node4 *)node)->children[i], fn, data);
+        break;
+    case ART_NODE16:
+        for (size_t i = 0; i < node->count && res == 0; i++)
+            res = art_iter(((struct art_node16 *)node)->children[i], fn, data);
+        break;
+    case ART_NODE48:
+        {
+            struct art_node48 *n = (struct art_node48 *)node;
+            for (size_t c = 0; c < 256 && res == 0; c++)
+                if (n->index[c] != 0)
+                    res = art_iter(n->children[n->index[c] - 1], fn, data);
+            break;
+        }
+    default:
+        {
+            struct art_node256 *n = (struct art_node256 *)node;
+            for (size_t c = 0; c < 256 && res == 0; c++)
+                if (n->children[c] != NULL)
+                    res = art_iter(n->children[c], fn, data);
+            break;
+        }
+    }
+
+    return res;
+}
+
+
+art_t
+art_new_with_allocator(ds_malloc_fn malloc_fn, ds_free_fn free_fn)
+{
+    art_t art = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct radix_tree));
+    if (art == NULL) return NULL;
+
+    art->root      = NULL;
+    art->size      = 0;
+    art->malloc_fn = malloc_fn;
+    art->free_fn   = free_fn;
+
+    return art;
+}
+
+
+art_t
+art_new(void)
+{
+    return art_new_with_allocator(NULL, NULL);
+}
+
+
+void
+art_free(art_t art)
+{
+    if (art->root != NULL) art_free_ptr(art, art->root);
+    ART_FREE(art, art);
+}
+
+
+int
+art_insert(art_t art, const void *key, size_t len, void *value)
+{
+    struct art_leaf *leaf = ART_MALLOC(art, sizeof(struct art_leaf) + len);
+    if (leaf == NULL) return -1;
+
+    leaf->value = value;
+    leaf->len   = len;
+    memcpy(leaf->key, key, len);
+
+    if (art_insert_at(art, &art->root, 0, leaf) == -1)
+    {
+        ART_FREE(art, leaf);
+        return -1;
+    }
+
+    art->size++;
+    return 0;
+}
+
+
+void **
+art_find(art_t art, const void *key, size_t len)
+{
+    const unsigned char *bytes = key;
+    void                *ptr   = art->root;
+    size_t               depth = 0;
+
+    while (ptr != NULL)
+    {
+        if (ART_IS_LEAF(ptr))
+        {
+            struct art_leaf *leaf = ART_LEAF(ptr);
+            return art_leaf_matches(leaf, bytes, len) ? &leaf->value : NULL;
+        }
+
+        struct art_node *node = ptr;
+
+        /* the bytes past the stored prefix are compared at the leaf */
+        if (node->prefix_len != 0)
+        {
+            if (art_check_prefix(node, bytes, len, depth)
+                != ART_MIN(node->prefix_len, ART_MAX_PREFIX))
+                return NULL;
+            depth += node->prefix_len;
+        }
+
+        if (depth > len) return NULL;
+        if (depth == len)
+        {
+            struct art_leaf *term = node->term;
+            return term != NULL && art_leaf_matches(term, bytes, len)
+                     ? &term->value
+                     : NULL;
+        }
+
+        void **child = art_find_child(node, bytes[depth++]);
+        ptr          = child != NULL ? *child : NULL;
+    }
+
+    return NULL;
+}
+
+
+int
+art_erase(art_t art, const void *key, size_t len)
+{
+    void *root = art->root;
+
+    if (root == NULL) goto noent;
+
+    if (ART_IS_LEAF(root))
+    {
+        if (!art_leaf_matches(ART_LEAF(root), key, len)) goto noent;
+
+        ART_FREE(art, ART_LEAF(root));
+        art->root = NULL;
+    }
+    else if (art_erase_at(art, &art->root, 0, key, len) == -1)
+        return -1;
+
+    art->size--;
+    return 0;
+
+noent:
+    errno = ENOENT;
+    return -1;
+}
+
+
+int
+art_foreach_prefix(art_t art, const void *prefix, size_t len, art_iter_fn fn,
+                   void *data)
+{
+    const unsigned char *bytes = prefix;
+    void                *ptr   = art->root;
+    size_t               depth = 0;
+
+    while (ptr != NULL)
+    {
+        if (ART_IS_LEAF(ptr))
+        {
+            struct art_leaf *leaf = ART_LEAF(ptr);
+            if (leaf->len < len || memcmp(leaf->key, bytes, len) != 0)
+                return 0;
+
+            return fn(leaf->key, leaf->len, leaf->value, data);
+        }
+
+        struct art_node *node = ptr;
+        if (depth == len) return art_iter(node, fn, data);
+
+        if (node->prefix_len != 0)
+        {
+            size_t diff = art_prefix_mismatch(node, bytes, len, depth);
+
+            /* the prefix ends inside the node's prefix */
+            if (depth + diff >= len) return art_iter(node, fn, data);
+            if (diff < node->prefix_len) return 0;
+
+            depth += node->prefix_len;
+            if (depth == len) return art_iter(node, fn, data);
+        }
+
+        void **child = art_find_child(node, bytes[depth++]);
+        ptr          = child != NULL ? *child : NULL;
+    }
+
+    return 0;
+}
+
+
+void **
+art_longest_prefix(art_t art, const void *key, size_t len, size_t *match_len)
+{
+    const unsigned char *bytes = key;
+    struct art_leaf     *best  = NULL;
+    void                *ptr   = art->root;
+    size_t               depth = 0;
+
+    while (ptr != NULL)
+    {
+        if (ART_IS_LEAF(ptr))
+        {
+            struct art_leaf *leaf = ART_LEAF(ptr);
+            if (leaf->len <= len && memcmp(leaf->key, bytes, leaf->len) == 0)
+                best = leaf;
+            break;
+        }
+
+        struct art_node *node = ptr;
+
+        if (node->prefix_len != 0)
+        {
+            if (art_check_prefix(node, bytes, len, depth)
+                != ART_MIN(node->prefix_len, ART_MAX_PREFIX))
+                break;
+            depth += node->prefix_len;
+        }
+
+        if (depth > len) break;
+
+        /* the skipped prefix bytes were not compared, so check it all */
+        struct art_leaf *term = node->term;
+        if (term != NULL && memcmp(term->key, bytes, term->len) == 0)
+            best = term;
+
+        if (depth == len) break;
+
+        void **child = art_find_child(node, bytes[depth++]);
+        ptr          = child != NULL ? *child : NULL;
+    }
+
+    if (best == NULL) return NULL;
+    if (match_len != NULL) *match_len = best->len;
+    return &best->value;
+}
+
+
+size_t
+art_size(art_t art)
+{
+    return art->size;
+}
@@ -0,0 +1,275 @@
+#include "ds/bitset.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ds/__priv/bits.h"
+
+#define BITSET_FREE(bs, ptr) \
+    ELSE_IF_NULL(((bitset_t)bs)->free_fn, free, ptr)
+
+#define BITSET_REALLOC(bs, ...) \
+    ELSE_IF_NULL(((bitset_t)bs)->realloc_fn, realloc, __VA_ARGS__)
+
+#define BITSET_WORDS(size) (((size) + 63) / 64)
+
+/* the bits of the last word that lie inside the bitset */
+#define BITSET_TAIL_MASK(size) \
+    ((size) % 64 == 0 ? ~(uint64_t)0 : ((uint64_t)1 << ((size) % 64)) - 1)
+
+#define BITSET_CHECK_RANGE(bs, index, ret) \
+    do {                                   \
+        if ((index) >= (bs)->size)         \
+        {                                  \
+            errno = ERANGE;                \
+            return ret;                    \
+        }                                  \
+    } while (0)
+
+/*
+ * The bulk operations work on 256-bit vectors through the GNU vector
+ * extension, which compiles to whatever SIMD the target has (two SSE2 ops,
+ * one AVX2 op, NEON, ...) without tying libds to an ISA.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+typedef uint64_t bitset_vec __attribute__((vector_size(32)));
+
+#define BITSET_VEC_LOOP(d, s, n, i, op)                \
+    for (; (i) + 4 <= (n); (i) += 4)                   \
+    {                                                  \
+        bitset_vec a, b;                               \
+        memcpy(&a, (d) + (i), sizeof(a));              \
+        memcpy(&b, (s) + (i), sizeof(b));              \
+        a = a op b;                                    \
+        memcpy((d) + (i), &a, sizeof(a));              \
+    }
+#else
+#define BITSET_VEC_LOOP(d, s, n, i, op)
+#endif
+
+#define BITSET_BULK_OP(name, op)                                       \
+    int                                                                \
+    bitset_##name(bitset_t restrict dest, bitset_t restrict src)       \
+    {                                                                  \
+        if (dest->size != src->size)                                   \
+        {                                                              \
+            errno = EINVAL;                                            \
+            return -1;                                                 \
+        }                                                              \
+                                                                       \
+        uint64_t *restrict       d = dest->words;                      \
+        const uint64_t *restrict s = src->words;                       \
+        const size_t             n = BITSET_WORDS(dest->size);         \
+        size_t                   i = 0;                                \
+                                                                       \
+        BITSET_VEC_LOOP(d, s, n, i, op)                                \
+        for (; i < n; i++) d[i] = d[i] op s[i];                        \
+        return 0;                                                      \
+    }
+
+
+struct bit_set
+{
+    uint64_t *words;
+
+    size_t size;
+    size_t alloc_words;
+
+    ds_realloc_fn realloc_fn;
+    ds_free_fn    free_fn;
+};
+
+
+bitset_t
+bitset_new_with_allocator(size_t size, ds_malloc_fn malloc_fn,
+                          ds_realloc_fn realloc_fn, ds_free_fn free_fn)
+{
+    bitset_t bs = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct bit_set));
+    if (bs == NULL) return NULL;
+
+    bs->words       = NULL;
+    bs->size        = 0;
+    bs->alloc_words = 0;
+    bs->realloc_fn  = realloc_fn;
+    bs->free_fn     = free_fn;
+
+    if (size != 0 && bitset_resize(bs, size) == NULL)
+    {
+        BITSET_FREE(bs, bs);
+        return NULL;
+    }
+
+    return bs;
+}
+
+
+bitset_t
+bitset_new(size_t size)
+{
+    return bitset_new_with_allocator(size, NULL, NULL, NULL);
+}
+
+
+void
+bitset_free(bitset_t bs)
+{
+    if (bs->words != NULL) BITSET_FREE(bs, bs->words);
+    BITSET_FREE(bs, bs);
+}
+
+
+uint64_t *
+bitset_resize(bitset_t bs, size_t size)
+{
+    const size_t old_words = BITSET_WORDS(bs->size);
+    const size_t new_words = BITSET_WORDS(size);
+
+    if (new_words > bs->alloc_words)
+    {
+        size_t alloc = bs->alloc_words + (bs->alloc_words >> 1);
+        if (alloc < new_words) alloc = new_words;
+
+        errno = 0;
+        uint64_t *words
+            = BITSET_REALLOC(bs, bs->words, alloc * sizeof(uint64_t));
+        if (words == NULL) return NULL;
+
+        bs->words       = words;
+        bs->alloc_words = alloc;
+    }
+
+    if (new_words > old_words)
+        memset(bs->words + old_words, 0,
+               (new_words - old_words) * sizeof(uint64_t));
+
+    /* keep the bits past the end cleared, every operation relies on it */
+    if (size < bs->size && new_words != 0)
+        bs->words[new_words - 1] &= BITSET_TAIL_MASK(size);
+
+    bs->size = size;
+    return bs->words;
+}
+
+
+int
+bitset_set(bitset_t bs, size_t index)
+{
+    BITSET_CHECK_RANGE(bs, index, -1);
+    bs->words[index / 64] |= (uint64_t)1 << (index % 64);
+    return 0;
+}
+
+
+int
+bitset_clear(bitset_t bs, size_t index)
+{
+    BITSET_CHECK_RANGE(bs, index, -1);
+    bs->words[index / 64] &= ~((uint64_t)1 << (index % 64));
+    return 0;
+}
+
+
+int
+bitset_flip(bitset_t bs, size_t index)
+{
+    BITSET_CHECK_RANGE(bs, index, -1);
+    bs->words[index / 64] ^= (uint64_t)1 << (index % 64);
+    return 0;
+}
+
+
+int
+bitset_test(bitset_t bs, size_t index)
+{
+    BITSET_CHECK_RANGE(bs, index, 0);
+    return (bs->words[index / 64] >> (index % 64)) & 1;
+}
+
+
+void
+bitset_set_all(bitset_t bs)
+{
+    const size_t n = BITSET_WORDS(bs->size);
+    if (n == 0) return;
+
+    memset(bs->words, 0xFF, n * sizeof(uint64_t));
+    bs->words[n - 1] &= BITSET_TAIL_MASK(bs->size);
+}
+
+
+void
+bitset_clear_all(bitset_t bs)
+{
+    if (bs->words != NULL)
+        memset(bs->words, 0, BITSET_WORDS(bs->size) * sizeof(uint64_t));
+}
+
+
+BITSET_BULK_OP(and, &)
+BITSET_BULK_OP(or, |)
+BITSET_BULK_OP(xor, ^)
+BITSET_BULK_OP(andnot, &~)
+
+
+size_t
+bitset_count(bitset_t bs)
+{
+    const uint64_t *restrict w = bs->words;
+    const size_t             n = BITSET_WORDS(bs->size);
+
+    /* independent accumulators keep the popcounts from serializing */
+    size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    size_t i  = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        c0 += ds_popcount64(w[i]);
+        c1 += ds_popcount64(w[i + 1]);
+        c2 += ds_popcount64(w[i + 2]);
+        c3 += ds_popcount64(w[i + 3]);
+    }
+
+    for (; i < n; i++) c0 += ds_popcount64(w[i]);
+    return c0 + c1 + c2 + c3;
+}
+
+
+size_t
+bitset_find_first(bitset_t bs)
+{
+    return bitset_find_next(bs, 0);
+}
+
+
+size_t
+bitset_find_next(bitset_t bs, size_t index)
+{
+    if (index >= bs->size) return bs->size;
+
+    const size_t n    = BITSET_WORDS(bs->size);
+    size_t       i    = index / 64;
+    uint64_t     word = bs->words[i] & (~(uint64_t)0 << (index % 64));
+
+    while (word == 0)
+    {
+        if (++i >= n) return bs->size;
+        word = bs->words[i];
+    }
+
+    return (i * 64) + ds_ctz64(word);
+}
+
+
+size_t
+bitset_size(bitset_t bs)
+{
+    return bs->size;
+}
+
+
+uint64_t *
+bitset_data(bitset_t bs)
+{
+    return bs->words;
+}
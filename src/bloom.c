@@ -0,0 +1,431 @@
+#include "ds/bloom.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ds/__priv/bits.h"
+#include "ds/__priv/hash.h"
+
+#define BLOOM_FREE(bf, ptr) \
+    ELSE_IF_NULL(((bloom_t)bf)->free_fn, free, ptr)
+
+#define BLOOM_BLOCK_SIZE 64
+#define BLOOM_LANES      8
+
+/* the blocks queried ahead of the current one inside a batch */
+#define BLOOM_PREFETCH 8
+
+/*
+ * The serialized header: the magic, the 32-bit version and block size, and
+ * the 64-bit block amount. Every integer is little endian, the blocks too.
+ */
+#define BLOOM_HEADER_SIZE 24
+
+/* the blocks ::write converts to little endian at a time */
+#define BLOOM_WRITE_BLOCKS 64
+
+#define BLOOM_MAGIC   "DSBLOOM"
+#define BLOOM_VERSION 1U
+
+
+struct bloom_filter
+{
+    uint64_t *blocks;
+    size_t    block_amount;
+
+    /* `blocks` aligned up to a cache line from this allocation */
+    void *alloc;
+
+    ds_free_fn free_fn;
+};
+
+
+/* odd multipliers turning one 32-bit hash into a bit of every lane */
+static const uint32_t bloom_salts[BLOOM_LANES] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+};
+
+
+/*
+ * The lane masks are built and applied as one 512-bit GNU vector, which
+ * compiles to whatever SIMD the target has without tying libds to an ISA.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define BLOOM_PREFETCH_BLOCK(ptr, rw) __builtin_prefetch(ptr, rw)
+
+typedef uint64_t bloom_vec __attribute__((vector_size(BLOOM_BLOCK_SIZE)));
+
+
+static void
+bloom_mask(uint64_t hash, bloom_vec *mask)
+{
+    bloom_vec salts;
+    for (size_t i = 0; i < BLOOM_LANES; i++) salts[i] = bloom_salts[i];
+
+    bloom_vec bits = ((uint32_t)hash * salts) & 0xffffffffU;
+    *mask          = (bloom_vec){ 1, 1, 1, 1, 1, 1, 1, 1 } << (bits >> 26);
+}
+
+
+static void
+bloom_set(uint64_t *block, uint64_t hash)
+{
+    bloom_vec vec, mask;
+    memcpy(&vec, block, sizeof(vec));
+    bloom_mask(hash, &mask);
+
+    vec |= mask;
+    memcpy(block, &vec, sizeof(vec));
+}
+
+
+static int
+bloom_test(const uint64_t *block, uint64_t hash)
+{
+    bloom_vec vec, mask;
+    memcpy(&vec, block, sizeof(vec));
+    bloom_mask(hash, &mask);
+
+    bloom_vec miss = mask & ~vec;
+    uint64_t  any  = 0;
+    for (size_t i = 0; i < BLOOM_LANES; i++) any |= miss[i];
+
+    return any == 0;
+}
+#else
+#define BLOOM_PREFETCH_BLOCK(ptr, rw) ((void)(ptr))
+
+
+static void
+bloom_set(uint64_t *block, uint64_t hash)
+{
+    for (size_t i = 0; i < BLOOM_LANES; i++)
+        block[i] |= (uint64_t)1 << (((uint32_t)hash * bloom_salts[i]) >> 26);
+}
+
+
+static int
+bloom_test(const uint64_t *block, uint64_t hash)
+{
+    uint64_t miss = 0;
+
+    for (size_t i = 0; i < BLOOM_LANES; i++)
+        miss |= ((uint64_t)1 << (((uint32_t)hash * bloom_salts[i]) >> 26))
+              & ~block[i];
+
+    return miss == 0;
+}
+#endif
+
+
+/*
+ * Maps the high half of a hash onto a block without a division. Filters
+ * with more blocks than that half can pick from use the whole hash.
+ */
+static uint64_t *
+bloom_block(bloom_t bf, uint64_t hash)
+{
+    const uint64_t amount = bf->block_amount;
+    const size_t   index  = amount <= ((uint64_t)1 << 32)
+                              ? (size_t)(((hash >> 32) * amount) >> 32)
+                              : (size_t)ds_mulhi64(hash, amount);
+
+    return bf->blocks + (index * BLOOM_LANES);
+}
+
+
+static void
+bloom_store64(unsigned char *p, uint64_t value)
+{
+    for (size_t i = 0; i < 8; i++) p[i] = (unsigned char)(value >> (i * 8));
+}
+
+
+static uint64_t
+bloom_load64(const unsigned char *p)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; i++) value |= (uint64_t)p[i] << (i * 8);
+    return value;
+}
+
+
+/*
+ * The false positive rate of a filter holding @load keys per block on
+ * average. The keys of a block follow a Poisson distribution, and a block
+ * holding `j` keys fails a query when all 8 tested bits are set.
+ */
+static double
+bloom_rate(double load)
+{
+    double prob = exp(-load);
+    double rate = 0;
+    size_t max  = (size_t)(load + (10 * sqrt(load)) + 20);
+
+    for (size_t j = 0; j <= max; j++)
+    {
+        double lane = 1 - pow(1 - (1.0 / 64), (double)j);
+        rate       += prob * pow(lane, BLOOM_LANES);
+        prob       *= load / (double)(j + 1);
+    }
+
+    return rate;
+}
+
+
+static bloom_t
+bloom_alloc(size_t block_amount, ds_malloc_fn malloc_fn, ds_free_fn free_fn)
+{
+    bloom_t bf = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct bloom_filter));
+    if (bf == NULL) return NULL;
+
+    bf->free_fn      = free_fn;
+    bf->block_amount = block_amount;
+
+    if (block_amount > (SIZE_MAX - BLOOM_BLOCK_SIZE) / BLOOM_BLOCK_SIZE)
+    {
+        errno = ENOMEM;
+        goto fail;
+    }
+
+    bf->alloc = ELSE_IF_NULL(malloc_fn, malloc,
+                             (block_amount * BLOOM_BLOCK_SIZE)
+                                 + BLOOM_BLOCK_SIZE - 1);
+    if (bf->alloc == NULL) goto fail;
+
+    uintptr_t aligned = ((uintptr_t)bf->alloc + BLOOM_BLOCK_SIZE - 1)
+                      & ~(uintptr_t)(BLOOM_BLOCK_SIZE - 1);
+    bf->blocks = (uint64_t *)aligned;
+    return bf;
+
+fail:
+    BLOOM_FREE(bf, bf);
+    return NULL;
+}
+
+
+bloom_t
+bloom_new_with_allocator(size_t expected, double fpr, ds_malloc_fn malloc_fn,
+                         ds_free_fn free_fn)
+{
+    if (!(fpr > 0 && fpr < 1))
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    /* the highest load per block still meeting the rate */
+    double lo = 0;
+    double hi = BLOOM_BLOCK_SIZE * 8;
+    for (int i = 0; i < 64; i++)
+    {
+        double mid = (lo + hi) / 2;
+        if (bloom_rate(mid) <= fpr)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    double blocks = lo > 0 ? ceil((double)expected / lo) : (double)SIZE_MAX;
+    if (blocks < 1) blocks = 1;
+    if (blocks >= (double)SIZE_MAX)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    bloom_t bf = bloom_alloc((size_t)blocks, malloc_fn, free_fn);
+    if (bf != NULL) bloom_clear(bf);
+    return bf;
+}
+
+
+bloom_t
+bloom_new(size_t expected, double fpr)
+{
+    return bloom_new_with_allocator(expected, fpr, NULL, NULL);
+}
+
+
+void
+bloom_free(bloom_t bf)
+{
+    BLOOM_FREE(bf, bf->alloc);
+    BLOOM_FREE(bf, bf);
+}
+
+
+uint64_t
+bloom_hash(const void *key, size_t len)
+{
+    return ds_hash_bytes(key, len);
+}
+
+
+void
+bloom_insert(bloom_t bf, const void *key, size_t len)
+{
+    bloom_insert_hash(bf, bloom_hash(key, len));
+}
+
+
+int
+bloom_contains(bloom_t bf, const void *key, size_t len)
+{
+    return bloom_contains_hash(bf, bloom_hash(key, len));
+}
+
+
+void
+bloom_insert_hash(bloom_t bf, uint64_t hash)
+{
+    bloom_set(bloom_block(bf, hash), hash);
+}
+
+
+int
+bloom_contains_hash(bloom_t bf, uint64_t hash)
+{
+    return bloom_test(bloom_block(bf, hash), hash);
+}
+
+
+void
+bloom_insert_batch(bloom_t bf, const uint64_t *hashes, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (i + BLOOM_PREFETCH < n)
+            BLOOM_PREFETCH_BLOCK(bloom_block(bf, hashes[i + BLOOM_PREFETCH]),
+                                 1);
+
+        bloom_insert_hash(bf, hashes[i]);
+    }
+}
+
+
+size_t
+bloom_contains_batch(bloom_t bf, const uint64_t *hashes, size_t n,
+                     unsigned char *out)
+{
+    size_t found = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (i + BLOOM_PREFETCH < n)
+            BLOOM_PREFETCH_BLOCK(bloom_block(bf, hashes[i + BLOOM_PREFETCH]),
+                                 0);
+
+        out[i]  = (unsigned char)bloom_contains_hash(bf, hashes[i]);
+        found  += out[i];
+    }
+
+    return found;
+}
+
+
+int
+bloom_merge(bloom_t restrict dest, bloom_t restrict src)
+{
+    if (dest->block_amount != src->block_amount)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    const size_t words = dest->block_amount * BLOOM_LANES;
+    for (size_t i = 0; i < words; i++) dest->blocks[i] |= src->blocks[i];
+
+    return 0;
+}
+
+
+void
+bloom_clear(bloom_t bf)
+{
+    memset(bf->blocks, 0, bf->block_amount * BLOOM_BLOCK_SIZE);
+}
+
+
+size_t
+bloom_size(bloom_t bf)
+{
+    return bf->block_amount * BLOOM_BLOCK_SIZE;
+}
+
+
+int
+bloom_write(bloom_t bf, FILE *stream)
+{
+    unsigned char header[BLOOM_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+
+    memcpy(header, BLOOM_MAGIC, sizeof(BLOOM_MAGIC));
+    bloom_store64(header + 8, BLOOM_VERSION
+                                  | ((uint64_t)BLOOM_BLOCK_SIZE << 32));
+    bloom_store64(header + 16, bf->block_amount);
+
+    if (fwrite(header, sizeof(header), 1, stream) != 1) return -1;
+
+    unsigned char chunk[BLOOM_WRITE_BLOCKS * BLOOM_BLOCK_SIZE];
+    for (size_t block = 0; block < bf->block_amount;
+         block += BLOOM_WRITE_BLOCKS)
+    {
+        size_t amount = bf->block_amount - block;
+        if (amount > BLOOM_WRITE_BLOCKS) amount = BLOOM_WRITE_BLOCKS;
+
+        const uint64_t *words = bf->blocks + (block * BLOOM_LANES);
+        for (size_t i = 0; i < amount * BLOOM_LANES; i++)
+            bloom_store64(chunk + (i * 8), words[i]);
+
+        if (fwrite(chunk, BLOOM_BLOCK_SIZE, amount, stream) != amount)
+            return -1;
+    }
+
+    return 0;
+}
+
+
+bloom_t
+bloom_read(FILE *stream, ds_malloc_fn malloc_fn, ds_free_fn free_fn)
+{
+    unsigned char header[BLOOM_HEADER_SIZE];
+
+    if (fread(header, sizeof(header), 1, stream) != 1)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    const uint64_t sizes        = bloom_load64(header + 8);
+    const uint64_t block_amount = bloom_load64(header + 16);
+
+    if (memcmp(header, BLOOM_MAGIC, sizeof(BLOOM_MAGIC)) != 0
+        || (uint32_t)sizes != BLOOM_VERSION
+        || (sizes >> 32) != BLOOM_BLOCK_SIZE || block_amount == 0
+        || block_amount > SIZE_MAX)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    bloom_t bf = bloom_alloc((size_t)block_amount, malloc_fn, free_fn);
+    if (bf == NULL) return NULL;
+
+    if (fread(bf->blocks, BLOOM_BLOCK_SIZE, bf->block_amount, stream)
+        != bf->block_amount)
+    {
+        bloom_free(bf);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    /* the words are converted in place, each one from its own bytes */
+    for (size_t i = 0; i < bf->block_amount * BLOOM_LANES; i++)
+        bf->blocks[i] = bloom_load64((const unsigned char *)&bf->blocks[i]);
+
+    return bf;
+}
@@ -0,0 +1,821 @@
+#include "ds/btree.h"
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BTREE_FREE(bt, ptr) \
+    ELSE_IF_NULL(((btree_t)bt)->free_fn, free, ptr)
+
+#define BTREE_MALLOC(bt, size) \
+    ELSE_IF_NULL(((btree_t)bt)->malloc_fn, malloc, size)
+
+#define BTREE_CACHE_LINE 64
+
+/* nodes start at this size and grow by a cache line until enough keys fit */
+#define BTREE_NODE_SIZE 512
+#define BTREE_MIN_KEYS  4
+
+#define BTREE_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+#define BTREE_KEY(bt, node, index) \
+    ((node)->slots + ((index) * (bt)->key_size))
+
+#define BTREE_VALUE(bt, node, index) \
+    ((node)->slots + (bt)->value_off + ((index) * (bt)->value_size))
+
+#define BTREE_CHILDREN(bt, node) \
+    ((struct btree_node **)(void *)((node)->slots + (bt)->child_off))
+
+
+enum btree_key_kind
+{
+    BTREE_KEY_CMP,
+    BTREE_KEY_I32,
+    BTREE_KEY_I64,
+};
+
+
+/*
+ * A leaf holds `count` keys followed by as many values, an inner node
+ * holds `count` keys followed by `count + 1` children. The keys inside
+ * the subtree of the child `i` are ordered between the keys `i - 1` and
+ * `i` of its parent.
+ */
+struct btree_node
+{
+    uint32_t count;
+    uint32_t leaf;
+
+    /* the next leaf in key order */
+    struct btree_node *next;
+
+    char slots[];
+};
+
+
+struct bplus_tree
+{
+    struct btree_node *root;
+    size_t             size;
+    size_t             height;
+
+    size_t key_size;
+    size_t value_size;
+
+    size_t node_size;
+    size_t leaf_cap;
+    size_t inner_cap;
+    size_t value_off;
+    size_t child_off;
+
+    btree_cmp_fn        cmp;
+    enum btree_key_kind kind;
+
+    ds_malloc_fn malloc_fn;
+    ds_free_fn   free_fn;
+};
+
+
+static void
+btree_layout(btree_t bt)
+{
+    const size_t header = offsetof(struct btree_node, slots);
+    const size_t ptr    = sizeof(struct btree_node *);
+
+    for (size_t size = BTREE_NODE_SIZE;; size += BTREE_CACHE_LINE)
+    {
+        const size_t room = size - header;
+
+        size_t leaf = room / (bt->key_size + bt->value_size);
+        while (leaf > 0
+               && BTREE_ALIGN(leaf * bt->key_size) + (leaf * bt->value_size)
+                      > room)
+            leaf--;
+
+        size_t inner = (room - ptr) / (bt->key_size + ptr);
+        while (inner > 0
+               && BTREE_ALIGN(inner * bt->key_size) + ((inner + 1) * ptr)
+                      > room)
+            inner--;
+
+        if (leaf < BTREE_MIN_KEYS || inner < BTREE_MIN_KEYS) continue;
+
+        bt->node_size = size;
+        bt->leaf_cap  = leaf;
+        bt->inner_cap = inner;
+        bt->value_off = BTREE_ALIGN(leaf * bt->key_size);
+        bt->child_off = BTREE_ALIGN(inner * bt->key_size);
+        return;
+    }
+}
+
+
+static int
+btree_cmp(btree_t bt, const void *a, const void *b)
+{
+    switch (bt->kind)
+    {
+    case BTREE_KEY_I32:
+        {
+            int32_t x, y;
+            memcpy(&x, a, sizeof(x));
+            memcpy(&y, b, sizeof(y));
+            return (x > y) - (x < y);
+        }
+    case BTREE_KEY_I64:
+        {
+            int64_t x, y;
+            memcpy(&x, a, sizeof(x));
+            memcpy(&y, b, sizeof(y));
+            return (x > y) - (x < y);
+        }
+    default: return bt->cmp(a, b);
+    }
+}
+
+
+#define BTREE_RANK_INT(type)                                          \
+    {                                                                 \
+        type key_val;                                                 \
+        memcpy(&key_val, key, sizeof(key_val));                       \
+        const type *keys = (const type *)(const void *)node->slots;   \
+                                                                      \
+        while (n > 0)                                                 \
+        {                                                             \
+            size_t half = n / 2;                                      \
+            type   mid  = keys[lo + half];                            \
+                                                                      \
+            if (upper ? mid <= key_val : mid < key_val)               \
+            {                                                         \
+                lo += half + 1;                                       \
+                n  -= half + 1;                                       \
+            }                                                         \
+            else                                                      \
+                n = half;                                             \
+        }                                                             \
+        return lo;                                                    \
+    }
+
+
+/*
+ * The amount of keys inside @node ordered before @key, counting the keys
+ * equal to it as well if @upper is set.
+ */
+static size_t
+btree_rank(btree_t bt, const struct btree_node *node, const void *key,
+           int upper)
+{
+    size_t lo = 0;
+    size_t n  = node->count;
+
+    /*
+     * fetch every cache line holding keys at once, so the search below
+     * waits for memory about once per node instead of once per probe
+     */
+    const char *lines = (const char *)node;
+    const char *end   = BTREE_KEY(bt, node, n);
+    for (; lines < end; lines += BTREE_CACHE_LINE) __builtin_prefetch(lines);
+
+    switch (bt->kind)
+    {
+    case BTREE_KEY_I32: BTREE_RANK_INT(int32_t)
+    case BTREE_KEY_I64: BTREE_RANK_INT(int64_t)
+    default:            break;
+    }
+
+    while (n > 0)
+    {
+        size_t half = n / 2;
+        int    res  = bt->cmp(BTREE_KEY(bt, node, lo + half), key);
+
+        if (upper ? res <= 0 : res < 0)
+        {
+            lo += half + 1;
+            n  -= half + 1;
+        }
+        else
+            n = half;
+    }
+
+    return lo;
+}
+
+
+static struct btree_node *
+btree_alloc_node(btree_t bt, int leaf)
+{
+    struct btree_node *node = BTREE_MALLOC(bt, bt->node_size);
+    if (node == NULL) return NULL;
+
+    node->count = 0;
+    node->leaf  = (uint32_t)leaf;
+    node->next  = NULL;
+    return node;
+}
+
+
+static void
+btree_free_node(btree_t bt, struct btree_node *node)
+{
+    if (!node->leaf)
+        for (size_t i = 0; i <= node->count; i++)
+            btree_free_node(bt, BTREE_CHILDREN(bt, node)[i]);
+
+    BTREE_FREE(bt, node);
+}
+
+
+static size_t
+btree_min(btree_t bt, const struct btree_node *node)
+{
+    return node->leaf ? bt->leaf_cap / 2 : (bt->inner_cap - 1) / 2;
+}
+
+
+static int
+btree_full(btree_t bt, const struct btree_node *node)
+{
+    return node->count == (node->leaf ? bt->leaf_cap : bt->inner_cap);
+}
+
+
+/* moves @n keys, and values if the nodes are leaves */
+static void
+btree_move(btree_t bt, struct btree_node *dest, size_t dest_index,
+           struct btree_node *src, size_t src_index, size_t n)
+{
+    memmove(BTREE_KEY(bt, dest, dest_index), BTREE_KEY(bt, src, src_index),
+            n * bt->key_size);
+
+    if (dest->leaf && bt->value_size != 0)
+        memmove(BTREE_VALUE(bt, dest, dest_index),
+                BTREE_VALUE(bt, src, src_index), n * bt->value_size);
+}
+
+
+static void
+btree_move_children(btree_t bt, struct btree_node *dest, size_t dest_index,
+                    struct btree_node *src, size_t src_index, size_t n)
+{
+    memmove(&BTREE_CHILDREN(bt, dest)[dest_index],
+            &BTREE_CHILDREN(bt, src)[src_index],
+            n * sizeof(struct btree_node *));
+}
+
+
+static const void *
+btree_low_key(btree_t bt, const struct btree_node *node)
+{
+    while (!node->leaf) node = BTREE_CHILDREN(bt, node)[0];
+    return BTREE_KEY(bt, node, 0);
+}
+
+
+/* splits the full child @index of @parent, which must not be full */
+static int
+btree_split(btree_t bt, struct btree_node *parent, size_t index)
+{
+    struct btree_node *child = BTREE_CHILDREN(bt, parent)[index];
+    struct btree_node *right = btree_alloc_node(bt, child->leaf);
+    if (right == NULL) return -1;
+
+    const size_t mid = child->count / 2;
+    const void  *separator;
+
+    if (child->leaf)
+    {
+        right->count = child->count - mid;
+        btree_move(bt, right, 0, child, mid, right->count);
+
+        right->next = child->next;
+        child->next = right;
+        separator   = BTREE_KEY(bt, right, 0);
+    }
+    else
+    {
+        right->count = child->count - mid - 1;
+        btree_move(bt, right, 0, child, mid + 1, right->count);
+        btree_move_children(bt, right, 0, child, mid + 1, right->count + 1);
+
+        separator = BTREE_KEY(bt, child, mid);
+    }
+
+    child->count = (uint32_t)mid;
+
+    btree_move(bt, parent, index + 1, parent, index, parent->count - index);
+    btree_move_children(bt, parent, index + 2, parent, index + 1,
+                        parent->count - index);
+
+    memcpy(BTREE_KEY(bt, parent, index), separator, bt->key_size);
+    BTREE_CHILDREN(bt, parent)[index + 1] = right;
+    parent->count++;
+    return 0;
+}
+
+
+/* merges the child @index + 1 of @parent into the child @index */
+static void
+btree_merge(btree_t bt, struct btree_node *parent, size_t index)
+{
+    struct btree_node *left  = BTREE_CHILDREN(bt, parent)[index];
+    struct btree_node *right = BTREE_CHILDREN(bt, parent)[index + 1];
+
+    if (left->leaf)
+    {
+        btree_move(bt, left, left->count, right, 0, right->count);
+        left->count += right->count;
+        left->next   = right->next;
+    }
+    else
+    {
+        memcpy(BTREE_KEY(bt, left, left->count), BTREE_KEY(bt, parent, index),
+               bt->key_size);
+        btree_move(bt, left, left->count + 1, right, 0, right->count);
+        btree_move_children(bt, left, left->count + 1, right, 0,
+                            right->count + 1);
+        left->count += right->count + 1;
+    }
+
+    btree_move(bt, parent, index, parent, index + 1,
+               parent->count - index - 1);
+    btree_move_children(bt, parent, index + 1, parent, index + 2,
+                        parent->count - index - 1);
+    parent->count--;
+
+    BTREE_FREE(bt, right);
+}
+
+
+static void
+btree_borrow_left(btree_t bt, struct btree_node *parent, size_t index)
+{
+    struct btree_node *child = BTREE_CHILDREN(bt, parent)[index];
+    struct btree_node *left  = BTREE_CHILDREN(bt, parent)[index - 1];
+
+    btree_move(bt, child, 1, child, 0, child->count);
+
+    if (child->leaf)
+    {
+        btree_move(bt, child, 0, left, left->count - 1, 1);
+        memcpy(BTREE_KEY(bt, parent, index - 1), BTREE_KEY(bt, child, 0),
+               bt->key_size);
+    }
+    else
+    {
+        btree_move_children(bt, child, 1, child, 0, child->count + 1);
+
+        memcpy(BTREE_KEY(bt, child, 0), BTREE_KEY(bt, parent, index - 1),
+               bt->key_size);
+        BTREE_CHILDREN(bt, child)[0] = BTREE_CHILDREN(bt, left)[left->count];
+        memcpy(BTREE_KEY(bt, parent, index - 1),
+               BTREE_KEY(bt, left, left->count - 1), bt->key_size);
+    }
+
+    left->count--;
+    child->count++;
+}
+
+
+static void
+btree_borrow_right(btree_t bt, struct btree_node *parent, size_t index)
+{
+    struct btree_node *child = BTREE_CHILDREN(bt, parent)[index];
+    struct btree_node *right = BTREE_CHILDREN(bt, parent)[index + 1];
+
+    if (child->leaf)
+    {
+        btree_move(bt, child, child->count, right, 0, 1);
+        btree_move(bt, right, 0, right, 1, right->count - 1);
+        memcpy(BTREE_KEY(bt, parent, index), BTREE_KEY(bt, right, 0),
+               bt->key_size);
+    }
+    else
+    {
+        memcpy(BTREE_KEY(bt, child, child->count),
+               BTREE_KEY(bt, parent, index), bt->key_size);
+        BTREE_CHILDREN(bt, child)[child->count + 1]
+            = BTREE_CHILDREN(bt, right)[0];
+        memcpy(BTREE_KEY(bt, parent, index), BTREE_KEY(bt, right, 0),
+               bt->key_size);
+
+        btree_move(bt, right, 0, right, 1, right->count - 1);
+        btree_move_children(bt, right, 0, right, 1, right->count);
+    }
+
+    right->count--;
+    child->count++;
+}
+
+
+/* refills the child @index of @parent after it went below its minimum */
+static void
+btree_rebalance(btree_t bt, struct btree_node *parent, size_t index)
+{
+    struct btree_node **children = BTREE_CHILDREN(bt, parent);
+    struct btree_node  *left     = index > 0 ? children[index - 1] : NULL;
+    struct btree_node  *right
+        = index < parent->count ? children[index + 1] : NULL;
+
+    if (left != NULL && left->count > btree_min(bt, left))
+        btree_borrow_left(bt, parent, index);
+    else if (right != NULL && right->count > btree_min(bt, right))
+        btree_borrow_right(bt, parent, index);
+    else if (left != NULL)
+        btree_merge(bt, parent, index - 1);
+    else
+        btree_merge(bt, parent, index);
+}
+
+
+static int
+btree_erase_from(btree_t bt, struct btree_node *node, const void *key)
+{
+    if (node->leaf)
+    {
+        size_t index = btree_rank(bt, node, key, 0);
+        if (index >= node->count
+            || btree_cmp(bt, BTREE_KEY(bt, node, index), key) != 0)
+        {
+            errno = ENOENT;
+            return -1;
+        }
+
+        btree_move(bt, node, index, node, index + 1, node->count - index - 1);
+        node->count--;
+        return 0;
+    }
+
+    size_t             index = btree_rank(bt, node, key, 1);
+    struct btree_node *child = BTREE_CHILDREN(bt, node)[index];
+
+    if (btree_erase_from(bt, child, key) == -1) return -1;
+    if (child->count < btree_min(bt, child)) btree_rebalance(bt, node, index);
+    return 0;
+}
+
+
+btree_t
+btree_new_with_allocator(size_t key_size, size_t value_size, btree_cmp_fn cmp,
+                         ds_malloc_fn malloc_fn, ds_free_fn free_fn)
+{
+    enum btree_key_kind kind = BTREE_KEY_CMP;
+
+    if (cmp == NULL && key_size == sizeof(int32_t)) kind = BTREE_KEY_I32;
+    if (cmp == NULL && key_size == sizeof(int64_t)) kind = BTREE_KEY_I64;
+
+    if (key_size == 0 || (cmp == NULL && kind == BTREE_KEY_CMP))
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    btree_t bt = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct bplus_tree));
+    if (bt == NULL) return NULL;
+
+    bt->root       = NULL;
+    bt->size       = 0;
+    bt->height     = 0;
+    bt->key_size   = key_size;
+    bt->value_size = value_size;
+    bt->cmp        = cmp;
+    bt->kind       = kind;
+    bt->malloc_fn  = malloc_fn;
+    bt->free_fn    = free_fn;
+
+    btree_layout(bt);
+    return bt;
+}
+
+
+btree_t
+btree_new(size_t key_size, size_t value_size, btree_cmp_fn cmp)
+{
+    return btree_new_with_allocator(key_size, value_size, cmp, NULL, NULL);
+}
+
+
+void
+btree_free(btree_t bt)
+{
+    if (bt->root != NULL) btree_free_node(bt, bt->root);
+    BTREE_FREE(bt, bt);
+}
+
+
+int
+btree_insert(btree_t bt, const void *key, const void *value)
+{
+    if (bt->root == NULL)
+    {
+        bt->root = btree_alloc_node(bt, 1);
+        if (bt->root == NULL) return -1;
+        bt->height = 1;
+    }
+
+    /* full nodes are split on the way down, so a split never propagates */
+    if (btree_full(bt, bt->root))
+    {
+        struct btree_node *root = btree_alloc_node(bt, 0);
+        if (root == NULL) return -1;
+
+        BTREE_CHILDREN(bt, root)[0] = bt->root;
+        if (btree_split(bt, root, 0) == -1)
+        {
+            BTREE_FREE(bt, root);
+            return -1;
+        }
+
+        bt->root = root;
+        bt->height++;
+    }
+
+    struct btree_node *node = bt->root;
+    while (!node->leaf)
+    {
+        size_t index = btree_rank(bt, node, key, 1);
+
+        if (btree_full(bt, BTREE_CHILDREN(bt, node)[index]))
+        {
+            if (btree_split(bt, node, index) == -1) return -1;
+            if (btree_cmp(bt, key, BTREE_KEY(bt, node, index)) >= 0) index++;
+        }
+
+        node = BTREE_CHILDREN(bt, node)[index];
+    }
+
+    size_t index = btree_rank(bt, node, key, 0);
+    if (index < node->count
+        && btree_cmp(bt, BTREE_KEY(bt, node, index), key) == 0)
+    {
+        errno = EEXIST;
+        return -1;
+    }
+
+    btree_move(bt, node, index + 1, node, index, node->count - index);
+    memcpy(BTREE_KEY(bt, node, index), key, bt->key_size);
+    if (bt->value_size != 0)
+        memcpy(BTREE_VALUE(bt, node, index), value, bt->value_size);
+
+    node->count++;
+    bt->size++;
+    return 0;
+}
+
+
+/*
+ * Get the amount of entries the next node of a level takes out of the
+ * @remaining ones. The last two nodes split what is left evenly if the
+ * last one would otherwise end up below @min.
+ */
+static size_t
+btree_bulk_take(size_t remaining, size_t cap, size_t min)
+{
+    if (remaining > cap && remaining < cap + min)
+        return remaining - (remaining / 2);
+
+    return remaining < cap ? remaining : cap;
+}
+
+
+int
+btree_bulk_load(btree_t bt, darray_t keys, darray_t values)
+{
+    const size_t n = darray_size(keys);
+
+    if (bt->size != 0 || darray_type_size(keys) != bt->key_size
+        || (values == NULL && bt->value_size != 0)
+        || (values != NULL
+            && (darray_type_size(values) != bt->value_size
+                || darray_size(values) != n)))
+        goto inval;
+
+    const char *key_data   = darray_data(keys);
+    const char *value_data = values != NULL ? darray_data(values) : NULL;
+
+    for (size_t i = 1; i < n; i++)
+        if (btree_cmp(bt, key_data + ((i - 1) * bt->key_size),
+                      key_data + (i * bt->key_size))
+            >= 0)
+            goto inval;
+
+    if (n == 0) return 0;
+
+    size_t              amount = (n + bt->leaf_cap - 1) / bt->leaf_cap;
+    struct btree_node **level  = BTREE_MALLOC(bt, amount * sizeof(*level));
+    if (level == NULL) return -1;
+
+    /* the leaves */
+    struct btree_node *prev = NULL;
+    size_t             made = 0;
+
+    for (size_t pos = 0; pos < n; made++)
+    {
+        size_t take = btree_bulk_take(n - pos, bt->leaf_cap, bt->leaf_cap / 2);
+
+        struct btree_node *leaf = btree_alloc_node(bt, 1);
+        if (leaf == NULL) goto fail_leaves;
+
+        memcpy(BTREE_KEY(bt, leaf, 0), key_data + (pos * bt->key_size),
+               take * bt->key_size);
+        if (bt->value_size != 0)
+            memcpy(BTREE_VALUE(bt, leaf, 0),
+                   value_data + (pos * bt->value_size),
+                   take * bt->value_size);
+
+        leaf->count = (uint32_t)take;
+        if (prev != NULL) prev->next = leaf;
+
+        level[made] = prev = leaf;
+        pos += take;
+    }
+
+    /* the inner levels, each built over the one below it */
+    size_t height = 1;
+    amount        = made;
+
+    while (amount > 1)
+    {
+        size_t parents = 0;
+
+        for (size_t pos = 0; pos < amount; parents++)
+        {
+            size_t take = btree_bulk_take(amount - pos, bt->inner_cap + 1,
+                                          ((bt->inner_cap - 1) / 2) + 1);
+
+            struct btree_node *node = btree_alloc_node(bt, 0);
+            if (node == NULL)
+            {
+                for (size_t i = 0; i < parents; i++)
+                    btree_free_node(bt, level[i]);
+                for (size_t i = pos; i < amount; i++)
+                    btree_free_node(bt, level[i]);
+                goto fail;
+            }
+
+            for (size_t i = 0; i < take; i++)
+            {
+                BTREE_CHILDREN(bt, node)[i] = level[pos + i];
+                if (i > 0)
+                    memcpy(BTREE_KEY(bt, node, i - 1),
+                           btree_low_key(bt, level[pos + i]), bt->key_size);
+            }
+
+            node->count    = (uint32_t)(take - 1);
+            level[parents] = node;
+            pos           += take;
+        }
+
+        amount = parents;
+        height++;
+    }
+
+    if (bt->root != NULL) btree_free_node(bt, bt->root);
+
+    bt->root   = level[0];
+    bt->height = height;
+    bt->size   = n;
+
+    BTREE_FREE(bt, level);
+    return 0;
+
+fail_leaves:
+    for (size_t i = 0; i < made; i++) BTREE_FREE(bt, level[i]);
+fail:
+    BTREE_FREE(bt, level);
+    return -1;
+
+inval:
+    errno = EINVAL;
+    return -1;
+}
+
+
+int
+btree_erase(btree_t bt, const void *key)
+{
+    if (bt->root == NULL)
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
+    if (btree_erase_from(bt, bt->root, key) == -1) return -1;
+    bt->size--;
+
+    struct btree_node *root = bt->root;
+    if (root->count > 0) return 0;
+
+    bt->root = root->leaf ? NULL : BTREE_CHILDREN(bt, root)[0];
+    bt->height--;
+    BTREE_FREE(bt, root);
+    return 0;
+}
+
+
+void *
+btree_find(btree_t bt, const void *key)
+{
+    struct btree_node *node = bt->root;
+    if (node == NULL) return NULL;
+
+    while (!node->leaf)
+        node = BTREE_CHILDREN(bt, node)[btree_rank(bt, node, key, 1)];
+
+    size_t index = btree_rank(bt, node, key, 0);
+    if (index >= node->count
+        || btree_cmp(bt, BTREE_KEY(bt, node, index), key) != 0)
+        return NULL;
+
+    return BTREE_VALUE(bt, node, index);
+}
+
+
+int
+btree_contains(btree_t bt, const void *key)
+{
+    return btree_find(bt, key) != NULL;
+}
+
+
+/* moves an iterator past the end of its leaf to the next non-empty one */
+static void
+btree_iter_settle(struct btree_iter *iter)
+{
+    while (iter->node != NULL && iter->index >= iter->node->count)
+    {
+        iter->node  = iter->node->next;
+        iter->index = 0;
+    }
+}
+
+
+void
+btree_seek(btree_t bt, const void *key, struct btree_iter *iter)
+{
+    struct btree_node *node = bt->root;
+
+    iter->tree  = bt;
+    iter->node  = NULL;
+    iter->index = 0;
+    if (node == NULL) return;
+
+    while (!node->leaf)
+        node = BTREE_CHILDREN(bt, node)[key == NULL
+                                            ? 0
+                                            : btree_rank(bt, node, key, 1)];
+
+    iter->node  = node;
+    iter->index = key == NULL ? 0 : btree_rank(bt, node, key, 0);
+    btree_iter_settle(iter);
+}
+
+
+int
+btree_iter_next(struct btree_iter *iter)
+{
+    if (iter->node == NULL) return 0;
+
+    iter->index++;
+    btree_iter_settle(iter);
+    return iter->node != NULL;
+}
+
+
+void *
+btree_iter_key(const struct btree_iter *iter)
+{
+    if (iter->node == NULL) return NULL;
+    return BTREE_KEY(iter->tree, iter->node, iter->index);
+}
+
+
+void *
+btree_iter_value(const struct btree_iter *iter)
+{
+    if (iter->node == NULL) return NULL;
+    return BTREE_VALUE(iter->tree, iter->node, iter->index);
+}
+
+
+size_t
+btree_size(btree_t bt)
+{
+    return bt->size;
+}
+
+
+size_t
+btree_height(btree_t bt)
+{
+    return bt->height;
+}
+
+
+size_t
+btree_node_size(btree_t bt)
+{
+    return bt->node_size;
+}
@@ -0,0 +1,251 @@
+#include "ds/buffer.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/uio.h>
+
+#define BUFFER_FREE(buf, ptr) \
+    ELSE_IF_NULL(((buffer_t)buf)->free_fn, free, ptr)
+
+#define BUFFER_REALLOC(buf, ...) \
+    ELSE_IF_NULL(((buffer_t)buf)->realloc_fn, realloc, __VA_ARGS__)
+
+#define BUFFER_INITIAL_SIZE 64
+
+/* the spare capacity ::readv_fd tries to have before reading */
+#define BUFFER_READ_AHEAD 65536
+
+/* the most buffers ::writev_fd hands to a single writev */
+#define BUFFER_IOV_MAX 64
+
+
+struct byte_buffer
+{
+    char *data;
+
+    size_t alloc_size;
+    size_t read_pos;
+    size_t write_pos;
+
+    ds_realloc_fn realloc_fn;
+    ds_free_fn    free_fn;
+};
+
+
+static int
+buffer_make_room(buffer_t buf, size_t min)
+{
+    if (buf->alloc_size - buf->write_pos >= min) return 0;
+
+    /* drop the consumed bytes first, which may already be enough */
+    const size_t readable = buf->write_pos - buf->read_pos;
+    if (buf->read_pos != 0)
+    {
+        memmove(buf->data, buf->data + buf->read_pos, readable);
+        buf->read_pos  = 0;
+        buf->write_pos = readable;
+
+        if (buf->alloc_size - readable >= min) return 0;
+    }
+
+    if (min > SIZE_MAX - readable)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    size_t size = buf->alloc_size == 0 ? BUFFER_INITIAL_SIZE : buf->alloc_size;
+    while (size - readable < min)
+        size = size > SIZE_MAX - (size >> 1) ? readable + min
+                                             : size + (size >> 1);
+
+    errno          = 0;
+    char *new_data = BUFFER_REALLOC(buf, buf->data, size);
+    if (new_data == NULL) return -1;
+
+    buf->data       = new_data;
+    buf->alloc_size = size;
+    return 0;
+}
+
+
+buffer_t
+buffer_new_with_allocator(ds_malloc_fn malloc_fn, ds_realloc_fn realloc_fn,
+                          ds_free_fn free_fn)
+{
+    buffer_t buf = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct byte_buffer));
+    if (buf == NULL) return NULL;
+
+    buf->data       = NULL;
+    buf->alloc_size = 0;
+    buf->read_pos   = 0;
+    buf->write_pos  = 0;
+    buf->realloc_fn = realloc_fn;
+    buf->free_fn    = free_fn;
+
+    return buf;
+}
+
+
+buffer_t
+buffer_new(void)
+{
+    return buffer_new_with_allocator(NULL, NULL, NULL);
+}
+
+
+void
+buffer_free(buffer_t buf)
+{
+    if (buf->data != NULL) BUFFER_FREE(buf, buf->data);
+    BUFFER_FREE(buf, buf);
+}
+
+
+void *
+buffer_spare(buffer_t buf, size_t min)
+{
+    if (buffer_make_room(buf, min) == -1) return NULL;
+    return buf->data + buf->write_pos;
+}
+
+
+size_t
+buffer_spare_size(buffer_t buf)
+{
+    return buf->alloc_size - buf->write_pos;
+}
+
+
+int
+buffer_commit(buffer_t buf, size_t size)
+{
+    if (size > buf->alloc_size - buf->write_pos)
+    {
+        errno = ERANGE;
+        return -1;
+    }
+
+    buf->write_pos += size;
+    return 0;
+}
+
+
+int
+buffer_append(buffer_t restrict buf, const void *restrict data, size_t size)
+{
+    if (size == 0) return 0;
+    if (buffer_make_room(buf, size) == -1) return -1;
+
+    memcpy(buf->data + buf->write_pos, data, size);
+    buf->write_pos += size;
+    return 0;
+}
+
+
+int
+buffer_consume(buffer_t buf, size_t size)
+{
+    if (size > buf->write_pos - buf->read_pos)
+    {
+        errno = ERANGE;
+        return -1;
+    }
+
+    buf->read_pos += size;
+
+    /* an emptied buffer starts over at the front for free */
+    if (buf->read_pos == buf->write_pos) buf->read_pos = buf->write_pos = 0;
+    return 0;
+}
+
+
+void
+buffer_clear(buffer_t buf)
+{
+    buf->read_pos  = 0;
+    buf->write_pos = 0;
+}
+
+
+ssize_t
+buffer_readv_fd(buffer_t buf, int fd, size_t min)
+{
+    if (buffer_make_room(buf, min) == -1) return -1;
+
+    /*
+     * Bytes taken off the fd can not be put back, so the room for a large
+     * read is made before reading. Without it only the spare capacity is
+     * read into.
+     */
+    const int saved_errno = errno;
+    if (buffer_make_room(buf, BUFFER_READ_AHEAD) == -1) errno = saved_errno;
+
+    /* an empty read would look like the end of file */
+    if (buf->alloc_size == buf->write_pos)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    struct iovec iov;
+    iov.iov_base = buf->data + buf->write_pos;
+    iov.iov_len  = buf->alloc_size - buf->write_pos;
+
+    ssize_t res = readv(fd, &iov, 1);
+    if (res > 0) buf->write_pos += (size_t)res;
+    return res;
+}
+
+
+ssize_t
+buffer_writev_fd(buffer_t const *bufs, size_t count, int fd)
+{
+    struct iovec iov[BUFFER_IOV_MAX];
+    if (count == 0) return 0;
+    if (count > BUFFER_IOV_MAX) count = BUFFER_IOV_MAX;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        iov[i].iov_base = buffer_data(bufs[i]);
+        iov[i].iov_len  = buffer_size(bufs[i]);
+    }
+
+    ssize_t res = writev(fd, iov, (int)count);
+    if (res <= 0) return res;
+
+    size_t left = (size_t)res;
+    for (size_t i = 0; i < count && left != 0; i++)
+    {
+        size_t size = iov[i].iov_len < left ? iov[i].iov_len : left;
+
+        buffer_consume(bufs[i], size);
+        left -= size;
+    }
+
+    return res;
+}
+
+
+void *
+buffer_data(buffer_t buf)
+{
+    return buf->data == NULL ? NULL : buf->data + buf->read_pos;
+}
+
+
+size_t
+buffer_size(buffer_t buf)
+{
+    return buf->write_pos - buf->read_pos;
+}
+
+
+size_t
+buffer_capacity(buffer_t buf)
+{
+    return buf->alloc_size;
+}
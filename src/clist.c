@@ -0,0 +1,289 @@
+#include "ds/clist.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define CLIST_FREE(cl, ptr) \
+    ELSE_IF_NULL(((clist_t)cl)->free_fn, free, ptr)
+
+#define CLIST_MALLOC(cl, size) \
+    ELSE_IF_NULL(((clist_t)cl)->malloc_fn, malloc, size)
+
+#define CLIST_LOAD(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define CLIST_CAS(ptr, expected, desired)                      \
+    __atomic_compare_exchange_n(ptr, expected, desired, 0,     \
+                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+/* a set lowest bit on a node's `next` marks the node itself as removed */
+#define CLIST_MARK            ((uintptr_t)1)
+#define CLIST_NODE(link)      ((struct clist_node *)((link) & ~CLIST_MARK))
+#define CLIST_IS_MARKED(link) (((link) & CLIST_MARK) != 0)
+
+
+struct clist_node
+{
+    uintptr_t next;
+
+    void *key;
+    void *data;
+
+    struct epoch_node retire;
+};
+
+
+struct concurrent_list
+{
+    uintptr_t head;
+    size_t    size;
+
+    clist_cmp_fn cmp;
+    epoch_t      epoch;
+
+    ds_malloc_fn malloc_fn;
+    ds_free_fn   free_fn;
+};
+
+
+static int
+clist_compare(clist_t cl, const void *a, const void *b)
+{
+    if (cl->cmp != NULL) return cl->cmp(a, b);
+    return ((uintptr_t)a > (uintptr_t)b) - ((uintptr_t)a < (uintptr_t)b);
+}
+
+
+/*
+ * Finds the first node whose key is not ordered before @key, alongside the
+ * link pointing to it. Marked nodes found on the way are unlinked and
+ * retired. Returns whether the found node holds @key.
+ */
+static int
+clist_search(clist_t cl, const void *key, uintptr_t **prev_out,
+             struct clist_node **curr_out)
+{
+    for (;;)
+    {
+        uintptr_t         *prev = &cl->head;
+        struct clist_node *curr = CLIST_NODE(CLIST_LOAD(prev));
+
+        while (curr != NULL)
+        {
+            uintptr_t next = CLIST_LOAD(&curr->next);
+
+            if (CLIST_IS_MARKED(next))
+            {
+                uintptr_t expected = (uintptr_t)curr;
+                if (!CLIST_CAS(prev, &expected, next & ~CLIST_MARK)) break;
+
+                epoch_retire(cl->epoch, &curr->retire, curr);
+                curr = CLIST_NODE(next);
+                continue;
+            }
+
+            int order = clist_compare(cl, curr->key, key);
+            if (order >= 0)
+            {
+                *prev_out = prev;
+                *curr_out = curr;
+                return order == 0;
+            }
+
+            prev = &curr->next;
+            curr = CLIST_NODE(next);
+        }
+
+        /* the loop only ends early when unlinking lost a race, retry */
+        if (curr != NULL) continue;
+
+        *prev_out = prev;
+        *curr_out = NULL;
+        return 0;
+    }
+}
+
+
+clist_t
+clist_new_with_allocator(clist_cmp_fn cmp, ds_malloc_fn malloc_fn,
+                         ds_free_fn free_fn)
+{
+    clist_t cl
+        = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct concurrent_list));
+    if (cl == NULL) return NULL;
+
+    cl->head      = 0;
+    cl->size      = 0;
+    cl->cmp       = cmp;
+    cl->malloc_fn = malloc_fn;
+    cl->free_fn   = free_fn;
+
+    cl->epoch = epoch_new_with_allocator(malloc_fn, free_fn);
+    if (cl->epoch == NULL)
+    {
+        CLIST_FREE(cl, cl);
+        return NULL;
+    }
+
+    return cl;
+}
+
+
+clist_t
+clist_new(clist_cmp_fn cmp)
+{
+    return clist_new_with_allocator(cmp, NULL, NULL);
+}
+
+
+void
+clist_free(clist_t cl)
+{
+    struct clist_node *node = CLIST_NODE(cl->head);
+
+    while (node != NULL)
+    {
+        struct clist_node *next = CLIST_NODE(node->next);
+        CLIST_FREE(cl, node);
+        node = next;
+    }
+
+    epoch_free(cl->epoch);
+    CLIST_FREE(cl, cl);
+}
+
+
+int
+clist_insert(clist_t cl, void *key, void *data)
+{
+    struct clist_node *node = CLIST_MALLOC(cl, sizeof(struct clist_node));
+    if (node == NULL) return -1;
+
+    node->key  = key;
+    node->data = data;
+
+    if (epoch_enter(cl->epoch) != 0)
+    {
+        CLIST_FREE(cl, node);
+        return -1;
+    }
+
+    for (;;)
+    {
+        uintptr_t         *prev;
+        struct clist_node *curr;
+
+        if (clist_search(cl, key, &prev, &curr))
+        {
+            epoch_leave(cl->epoch);
+            CLIST_FREE(cl, node);
+            errno = EEXIST;
+            return -1;
+        }
+
+        node->next         = (uintptr_t)curr;
+        uintptr_t expected = (uintptr_t)curr;
+        if (CLIST_CAS(prev, &expected, (uintptr_t)node)) break;
+    }
+
+    __atomic_fetch_add(&cl->size, 1, __ATOMIC_RELAXED);
+    epoch_leave(cl->epoch);
+    return 0;
+}
+
+
+int
+clist_remove(clist_t cl, const void *key)
+{
+    uintptr_t         *prev;
+    struct clist_node *curr;
+    uintptr_t          next;
+
+    if (epoch_enter(cl->epoch) != 0) return -1;
+
+    for (;;)
+    {
+        if (!clist_search(cl, key, &prev, &curr))
+        {
+            epoch_leave(cl->epoch);
+            errno = ENOENT;
+            return -1;
+        }
+
+        /* logically remove the node by marking it, then try to unlink it */
+        next = CLIST_LOAD(&curr->next);
+        if (CLIST_IS_MARKED(next)) continue;
+        if (CLIST_CAS(&curr->next, &next, next | CLIST_MARK)) break;
+    }
+
+    __atomic_fetch_sub(&cl->size, 1, __ATOMIC_RELAXED);
+
+    uintptr_t expected = (uintptr_t)curr;
+    if (CLIST_CAS(prev, &expected, next))
+        epoch_retire(cl->epoch, &curr->retire, curr);
+    else /* let the search unlink it */
+        clist_search(cl, key, &prev, &curr);
+
+    epoch_leave(cl->epoch);
+    return 0;
+}
+
+
+/*
+ * Searches for @key without helping to unlink removed nodes, so readers
+ * never write to shared memory. Returns whether @key was found.
+ */
+static int
+clist_lookup(clist_t cl, const void *key, void **data)
+{
+    struct clist_node *curr = CLIST_NODE(CLIST_LOAD(&cl->head));
+    while (curr != NULL && clist_compare(cl, curr->key, key) < 0)
+        curr = CLIST_NODE(CLIST_LOAD(&curr->next));
+
+    if (curr == NULL || clist_compare(cl, curr->key, key) != 0
+        || CLIST_IS_MARKED(CLIST_LOAD(&curr->next)))
+        return 0;
+
+    *data = curr->data;
+    return 1;
+}
+
+
+void *
+clist_find(clist_t cl, const void *key)
+{
+    void *data = NULL;
+
+    if (epoch_enter(cl->epoch) != 0) return NULL;
+    int found = clist_lookup(cl, key, &data);
+    epoch_leave(cl->epoch);
+
+    if (!found) errno = ENOENT;
+    return data;
+}
+
+
+int
+clist_contains(clist_t cl, const void *key)
+{
+    void *data;
+
+    if (epoch_enter(cl->epoch) != 0) return 0;
+    int found = clist_lookup(cl, key, &data);
+    epoch_leave(cl->epoch);
+
+    return found;
+}
+
+
+size_t
+clist_size(clist_t cl)
+{
+    return __atomic_load_n(&cl->size, __ATOMIC_RELAXED);
+}
+
+
+epoch_t
+clist_epoch(clist_t cl)
+{
+    return cl->epoch;
+}
@@ -0,0 +1,548 @@
+#include "ds/cmap.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ds/__priv/hash.h"
+
+#define CMAP_FREE(map, ptr) \
+    ELSE_IF_NULL(((cmap_t)map)->free_fn, free, ptr)
+
+#define CMAP_MALLOC(map, size) \
+    ELSE_IF_NULL(((cmap_t)map)->malloc_fn, malloc, size)
+
+#define CMAP_LOAD(ptr)         __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define CMAP_STORE(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+
+#define CMAP_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+/*
+ * The amount of writer locks, and the smallest table. A key picks its
+ * stripe by the low bits of its hash, which also start its bucket index,
+ * so a bucket stays under one stripe whatever the table size.
+ */
+#define CMAP_STRIPES 64
+
+/* the average chain length that makes the table grow */
+#define CMAP_LOAD_FACTOR 1
+
+/* the buckets a write moves to the next table on top of its own */
+#define CMAP_MIGRATE_BATCH 16
+
+/* stored in a bucket of a table whose entries moved to the next table */
+#define CMAP_MOVED ((struct cmap_node *)(uintptr_t)1)
+
+#define CMAP_KEY(node)        ((node)->data)
+#define CMAP_VALUE(map, node) ((node)->data + (map)->value_offset)
+#define CMAP_RETIRE(map, node) \
+    ((struct epoch_node *)((node)->data + (map)->retire_offset))
+
+
+/*
+ * Never changed once published, writers replace nodes instead. Followed by
+ * the key, the value and then the retirement bookkeeping, which lookups
+ * never touch, so it stays off their cache lines.
+ */
+struct cmap_node
+{
+    struct cmap_node *next;
+    uint64_t          hash;
+
+    unsigned char data[];
+};
+
+
+struct cmap_table
+{
+    /* the table the entries move to while growing, or `NULL` */
+    struct cmap_table *next;
+
+    size_t mask;
+
+    /* the next bucket to claim for moving, and the amount already moved */
+    size_t cursor;
+    size_t moved;
+
+    struct epoch_node retire;
+
+    struct cmap_node *buckets[];
+};
+
+
+/* padded, so writers on different stripes do not share a cache line */
+union cmap_stripe
+{
+    struct
+    {
+        pthread_mutex_t lock;
+        size_t          count;
+    } s;
+
+    unsigned char pad[128];
+};
+
+
+struct concurrent_map
+{
+    struct cmap_table *table;
+
+    size_t key_size;
+    size_t value_size;
+    size_t value_offset;
+    size_t retire_offset;
+    size_t node_size;
+
+    epoch_t epoch;
+
+    ds_malloc_fn malloc_fn;
+    ds_free_fn   free_fn;
+
+    union cmap_stripe stripes[CMAP_STRIPES];
+};
+
+
+enum cmap_mode
+{
+    CMAP_INSERT,
+    CMAP_PUT,
+    CMAP_ERASE,
+};
+
+
+static struct cmap_table *
+cmap_table_new(cmap_t map, size_t size)
+{
+    if (size > (SIZE_MAX - sizeof(struct cmap_table))
+                   / sizeof(struct cmap_node *))
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    struct cmap_table *table = CMAP_MALLOC(
+        map, sizeof(struct cmap_table) + (size * sizeof(struct cmap_node *)));
+    if (table == NULL) return NULL;
+
+    table->next   = NULL;
+    table->mask   = size - 1;
+    table->cursor = 0;
+    table->moved  = 0;
+
+    for (size_t i = 0; i < size; i++) table->buckets[i] = NULL;
+    return table;
+}
+
+
+static void
+cmap_chain_free(cmap_t map, struct cmap_node *node)
+{
+    while (node != NULL)
+    {
+        struct cmap_node *next = node->next;
+        CMAP_FREE(map, node);
+        node = next;
+    }
+}
+
+
+/*
+ * Moves the bucket @index of @table to the next table, unless it already
+ * moved. The caller holds the stripe of the bucket. The nodes are copied,
+ * since readers may still be walking the old chain.
+ */
+static int
+cmap_migrate(cmap_t map, struct cmap_table *table, size_t index)
+{
+    struct cmap_node *head = CMAP_LOAD(&table->buckets[index]);
+    if (head == CMAP_MOVED) return 0;
+
+    struct cmap_table *next  = CMAP_LOAD(&table->next);
+    struct cmap_node  *low   = NULL;
+    struct cmap_node  *high  = NULL;
+    const size_t       split = table->mask + 1;
+
+    for (struct cmap_node *node = head; node != NULL; node = node->next)
+    {
+        struct cmap_node *copy = CMAP_MALLOC(map, map->node_size);
+        if (copy == NULL)
+        {
+            cmap_chain_free(map, low);
+            cmap_chain_free(map, high);
+            return -1;
+        }
+
+        memcpy(copy, node, map->node_size);
+
+        if ((node->hash & split) == 0)
+        {
+            copy->next = low;
+            low        = copy;
+        }
+        else
+        {
+            copy->next = high;
+            high       = copy;
+        }
+    }
+
+    CMAP_STORE(&next->buckets[index], low);
+    CMAP_STORE(&next->buckets[index + split], high);
+    CMAP_STORE(&table->buckets[index], CMAP_MOVED);
+
+    while (head != NULL)
+    {
+        struct cmap_node *following = head->next;
+        epoch_retire(map->epoch, CMAP_RETIRE(map, head), head);
+        head = following;
+    }
+
+    /* the last bucket to move makes the next table the current one */
+    if (__atomic_add_fetch(&table->moved, 1, __ATOMIC_ACQ_REL) == split)
+    {
+        CMAP_STORE(&map->table, next);
+        epoch_retire(map->epoch, &table->retire, table);
+    }
+
+    return 0;
+}
+
+
+/*
+ * Starts growing @table , unless it already is. Failing to allocate the
+ * next table is not an error, the chains only get longer until a later
+ * write manages to.
+ */
+static void
+cmap_grow(cmap_t map, struct cmap_table *table)
+{
+    if (CMAP_LOAD(&table->next) != NULL) return;
+
+    struct cmap_table *next = cmap_table_new(map, (table->mask + 1) * 2);
+    if (next == NULL) return;
+
+    struct cmap_table *expected = NULL;
+    if (!__atomic_compare_exchange_n(&table->next, &expected, next, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        CMAP_FREE(map, next);
+}
+
+
+/*
+ * Moves a batch of buckets of the current table if it is growing. A bucket
+ * that fails to move is left to the next write on it.
+ */
+static void
+cmap_help(cmap_t map)
+{
+    struct cmap_table *table = CMAP_LOAD(&map->table);
+    if (CMAP_LOAD(&table->next) == NULL) return;
+
+    const size_t size = table->mask + 1;
+    size_t       from = __atomic_fetch_add(&table->cursor, CMAP_MIGRATE_BATCH,
+                                           __ATOMIC_RELAXED);
+
+    for (size_t i = from; i < from + CMAP_MIGRATE_BATCH && i < size; i++)
+    {
+        union cmap_stripe *stripe = &map->stripes[i & (CMAP_STRIPES - 1)];
+
+        pthread_mutex_lock(&stripe->s.lock);
+        cmap_migrate(map, table, i);
+        pthread_mutex_unlock(&stripe->s.lock);
+    }
+}
+
+
+static int
+cmap_write(cmap_t map, const void *key, const void *value,
+           enum cmap_mode mode)
+{
+    const uint64_t     hash   = ds_hash_bytes(key, map->key_size);
+    union cmap_stripe *stripe = &map->stripes[hash & (CMAP_STRIPES - 1)];
+    struct cmap_node  *node   = NULL;
+
+    if (mode != CMAP_ERASE)
+    {
+        node = CMAP_MALLOC(map, map->node_size);
+        if (node == NULL) return -1;
+
+        node->hash = hash;
+        memcpy(CMAP_KEY(node), key, map->key_size);
+
+        if (value != NULL)
+            memcpy(CMAP_VALUE(map, node), value, map->value_size);
+        else
+            memset(CMAP_VALUE(map, node), 0, map->value_size);
+    }
+
+    if (epoch_enter(map->epoch) != 0)
+    {
+        if (node != NULL) CMAP_FREE(map, node);
+        return -1;
+    }
+
+    pthread_mutex_lock(&stripe->s.lock);
+
+    /* the entries of the key only live in the newest table once moved */
+    struct cmap_table *table = CMAP_LOAD(&map->table);
+    struct cmap_table *next;
+    int                result = 0;
+
+    while ((next = CMAP_LOAD(&table->next)) != NULL)
+    {
+        if (cmap_migrate(map, table, hash & table->mask) != 0)
+        {
+            result = -1;
+            goto unlock;
+        }
+
+        table = next;
+    }
+
+    struct cmap_node **link = &table->buckets[hash & table->mask];
+    struct cmap_node  *curr;
+
+    for (curr = *link; curr != NULL; curr = curr->next)
+    {
+        if (curr->hash == hash
+            && memcmp(CMAP_KEY(curr), key, map->key_size) == 0)
+            break;
+
+        link = &curr->next;
+    }
+
+    if (curr == NULL && mode == CMAP_ERASE)
+    {
+        errno  = ENOENT;
+        result = -1;
+    }
+    else if (curr != NULL && mode == CMAP_INSERT)
+    {
+        errno  = EEXIST;
+        result = -1;
+    }
+    else if (curr == NULL)
+    {
+        node->next = table->buckets[hash & table->mask];
+        CMAP_STORE(&table->buckets[hash & table->mask], node);
+        node = NULL;
+
+        size_t count = __atomic_add_fetch(&stripe->s.count, 1,
+                                          __ATOMIC_RELAXED);
+        /* only the current table grows, so at most two tables hold entries */
+        if (count * CMAP_STRIPES > (table->mask + 1) * CMAP_LOAD_FACTOR
+            && table == CMAP_LOAD(&map->table))
+            cmap_grow(map, table);
+    }
+    else
+    {
+        if (mode == CMAP_PUT)
+        {
+            node->next = curr->next;
+            CMAP_STORE(link, node);
+            node = NULL;
+        }
+        else
+        {
+            CMAP_STORE(link, curr->next);
+            __atomic_sub_fetch(&stripe->s.count, 1, __ATOMIC_RELAXED);
+        }
+
+        epoch_retire(map->epoch, CMAP_RETIRE(map, curr), curr);
+    }
+
+unlock:
+    pthread_mutex_unlock(&stripe->s.lock);
+
+    if (node != NULL) CMAP_FREE(map, node);
+
+    /* helping only after unlocking, so stripes are never held in pairs */
+    cmap_help(map);
+    epoch_leave(map->epoch);
+    return result;
+}
+
+
+/* searches for @key without writing to shared memory */
+static struct cmap_node *
+cmap_lookup(cmap_t map, const void *key)
+{
+    const uint64_t     hash  = ds_hash_bytes(key, map->key_size);
+    struct cmap_table *table = CMAP_LOAD(&map->table);
+    struct cmap_node  *curr;
+
+    while ((curr = CMAP_LOAD(&table->buckets[hash & table->mask]))
+           == CMAP_MOVED)
+        table = CMAP_LOAD(&table->next);
+
+    for (; curr != NULL; curr = CMAP_LOAD(&curr->next))
+        if (curr->hash == hash
+            && memcmp(CMAP_KEY(curr), key, map->key_size) == 0)
+            return curr;
+
+    return NULL;
+}
+
+
+cmap_t
+cmap_new_with_allocator(size_t key_size, size_t value_size,
+                        ds_malloc_fn malloc_fn, ds_free_fn free_fn)
+{
+    if (key_size == 0)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    size_t value_offset  = CMAP_ALIGN(key_size);
+    size_t retire_offset = CMAP_ALIGN(value_offset + value_size);
+    if (value_offset < key_size || retire_offset < value_size
+        || retire_offset > SIZE_MAX - sizeof(struct cmap_node)
+                               - sizeof(struct epoch_node))
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    cmap_t map = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct concurrent_map));
+    if (map == NULL) return NULL;
+
+    map->key_size      = key_size;
+    map->value_size    = value_size;
+    map->value_offset  = value_offset;
+    map->retire_offset = retire_offset;
+    map->node_size     = sizeof(struct cmap_node) + retire_offset
+                       + sizeof(struct epoch_node);
+    map->malloc_fn     = malloc_fn;
+    map->free_fn       = free_fn;
+
+    map->table = cmap_table_new(map, CMAP_STRIPES);
+    if (map->table == NULL)
+    {
+        CMAP_FREE(map, map);
+        return NULL;
+    }
+
+    map->epoch = epoch_new_with_allocator(malloc_fn, free_fn);
+    if (map->epoch == NULL)
+    {
+        CMAP_FREE(map, map->table);
+        CMAP_FREE(map, map);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < CMAP_STRIPES; i++)
+    {
+        pthread_mutex_init(&map->stripes[i].s.lock, NULL);
+        map->stripes[i].s.count = 0;
+    }
+
+    return map;
+}
+
+
+cmap_t
+cmap_new(size_t key_size, size_t value_size)
+{
+    return cmap_new_with_allocator(key_size, value_size, NULL, NULL);
+}
+
+
+void
+cmap_free(cmap_t map)
+{
+    struct cmap_table *table = map->table;
+
+    /* a growing map has entries in both tables */
+    while (table != NULL)
+    {
+        struct cmap_table *next = table->next;
+
+        for (size_t i = 0; i <= table->mask; i++)
+            if (table->buckets[i] != CMAP_MOVED)
+                cmap_chain_free(map, table->buckets[i]);
+
+        CMAP_FREE(map, table);
+        table = next;
+    }
+
+    for (size_t i = 0; i < CMAP_STRIPES; i++)
+        pthread_mutex_destroy(&map->stripes[i].s.lock);
+
+    epoch_free(map->epoch);
+    CMAP_FREE(map, map);
+}
+
+
+int
+cmap_insert(cmap_t map, const void *key, const void *value)
+{
+    return cmap_write(map, key, value, CMAP_INSERT);
+}
+
+
+int
+cmap_put(cmap_t map, const void *key, const void *value)
+{
+    return cmap_write(map, key, value, CMAP_PUT);
+}
+
+
+int
+cmap_erase(cmap_t map, const void *key)
+{
+    return cmap_write(map, key, NULL, CMAP_ERASE);
+}
+
+
+int
+cmap_get(cmap_t restrict map, const void *restrict key, void *restrict value)
+{
+    if (epoch_enter(map->epoch) != 0) return -1;
+
+    struct cmap_node *node = cmap_lookup(map, key);
+    if (node != NULL && value != NULL)
+        memcpy(value, CMAP_VALUE(map, node), map->value_size);
+
+    epoch_leave(map->epoch);
+
+    if (node == NULL)
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+int
+cmap_contains(cmap_t map, const void *key)
+{
+    if (epoch_enter(map->epoch) != 0) return 0;
+    int found = cmap_lookup(map, key) != NULL;
+    epoch_leave(map->epoch);
+
+    return found;
+}
+
+
+size_t
+cmap_size(cmap_t map)
+{
+    size_t size = 0;
+
+    for (size_t i = 0; i < CMAP_STRIPES; i++)
+        size += __atomic_load_n(&map->stripes[i].s.count, __ATOMIC_RELAXED);
+
+    return size;
+}
+
+
+epoch_t
+cmap_epoch(cmap_t map)
+{
+    return map->epoch;
+}
@@ -0,0 +1,364 @@
+#define _POSIX_C_SOURCE 200809L
+#include "ds/csr.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ds/__priv/parallel.h"
+
+#define CSR_FREE(g, ptr) \
+    ELSE_IF_NULL(((csr_t)g)->free_fn, free, ptr)
+
+/* the fewest edges worth a thread of their own */
+#define CSR_CHUNK_MIN ((size_t)1 << 16)
+
+
+struct csr_graph
+{
+    /* `vertex_amount + 1` offsets into `targets`, the last one is the end */
+    size_t   *offsets;
+    uint32_t *targets;
+
+    unsigned char *payloads;
+    size_t         payload_size;
+
+    size_t vertex_amount;
+    size_t edge_amount;
+
+    ds_malloc_fn malloc_fn;
+    ds_free_fn   free_fn;
+};
+
+
+/*
+ * A chunk of the edge list, counted into its own row of the histogram and
+ * then scattered from the cursors that row is turned into.
+ */
+struct csr_job
+{
+    csr_t g;
+
+    const struct csr_edge *edges;
+    const unsigned char   *payloads;
+    size_t                 amount;
+
+    size_t *counts;
+    int     out_of_range;
+};
+
+
+static size_t csr_thread_amount = 1;
+
+
+static void *
+csr_count(void *arg)
+{
+    struct csr_job *job = arg;
+
+    for (size_t i = 0; i < job->amount; i++)
+    {
+        const struct csr_edge *edge = &job->edges[i];
+
+        if (edge->from >= job->g->vertex_amount
+            || edge->to >= job->g->vertex_amount)
+        {
+            job->out_of_range = 1;
+            return NULL;
+        }
+
+        job->counts[edge->from]++;
+    }
+
+    return NULL;
+}
+
+
+static void *
+csr_scatter(void *arg)
+{
+    struct csr_job *job  = arg;
+    const size_t    size = job->g->payload_size;
+
+    for (size_t i = 0; i < job->amount; i++)
+    {
+        size_t at = job->counts[job->edges[i].from]++;
+
+        job->g->targets[at] = job->edges[i].to;
+        if (size > 0)
+            memcpy(job->g->payloads + (at * size), job->payloads + (i * size),
+                   size);
+    }
+
+    return NULL;
+}
+
+
+void
+csr_set_threads(size_t threads)
+{
+    if (threads == 0) threads = 1;
+    if (threads > DS_PARALLEL_MAX) threads = DS_PARALLEL_MAX;
+
+    __atomic_store_n(&csr_thread_amount, threads, __ATOMIC_RELAXED);
+}
+
+
+size_t
+csr_threads(void)
+{
+    return __atomic_load_n(&csr_thread_amount, __ATOMIC_RELAXED);
+}
+
+
+/* allocates the buffers of @g , or frees everything on failure */
+static int
+csr_alloc(csr_t g, size_t chunks, size_t **counts)
+{
+    const size_t vertices = g->vertex_amount;
+    const size_t edges    = g->edge_amount;
+
+    if (vertices >= SIZE_MAX / sizeof(size_t) / DS_PARALLEL_MAX
+        || edges > SIZE_MAX / sizeof(uint32_t)
+        || (g->payload_size > 0 && edges > SIZE_MAX / g->payload_size))
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    g->offsets  = ELSE_IF_NULL(g->malloc_fn, malloc,
+                               (vertices + 1) * sizeof(size_t));
+    g->targets  = ELSE_IF_NULL(g->malloc_fn, malloc,
+                               edges > 0 ? edges * sizeof(uint32_t) : 1);
+    g->payloads = g->payload_size == 0
+                    ? NULL
+                    : ELSE_IF_NULL(g->malloc_fn, malloc,
+                                   edges > 0 ? edges * g->payload_size : 1);
+    *counts     = ELSE_IF_NULL(g->malloc_fn, malloc,
+                               vertices > 0 ? chunks * vertices * sizeof(size_t)
+                                            : 1);
+
+    if (g->offsets == NULL || g->targets == NULL || *counts == NULL
+        || (g->payload_size > 0 && g->payloads == NULL))
+    {
+        if (g->offsets != NULL) CSR_FREE(g, g->offsets);
+        if (g->targets != NULL) CSR_FREE(g, g->targets);
+        if (g->payloads != NULL) CSR_FREE(g, g->payloads);
+        if (*counts != NULL) CSR_FREE(g, *counts);
+        return -1;
+    }
+
+    memset(*counts, 0, chunks * vertices * sizeof(size_t));
+    return 0;
+}
+
+
+csr_t
+csr_new_with_allocator(size_t vertex_amount, darray_t edges,
+                       darray_t payloads, ds_malloc_fn malloc_fn,
+                       ds_free_fn free_fn)
+{
+    if (vertex_amount > UINT32_MAX
+        || darray_type_size(edges) != sizeof(struct csr_edge)
+        || (payloads != NULL && darray_size(payloads) != darray_size(edges)))
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    csr_t g = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct csr_graph));
+    if (g == NULL) return NULL;
+
+    g->vertex_amount = vertex_amount;
+    g->edge_amount   = darray_size(edges);
+    g->payload_size  = payloads != NULL ? darray_type_size(payloads) : 0;
+    g->malloc_fn     = malloc_fn;
+    g->free_fn       = free_fn;
+
+    /* a histogram row per chunk, so the rows never outweigh the edges */
+    size_t chunks = g->edge_amount / CSR_CHUNK_MIN;
+    size_t limit  = vertex_amount > 0 ? g->edge_amount / vertex_amount : 1;
+    size_t wanted = __atomic_load_n(&csr_thread_amount, __ATOMIC_RELAXED);
+    if (chunks > wanted) chunks = wanted;
+    if (chunks > limit) chunks = limit;
+    if (chunks == 0) chunks = 1;
+
+    size_t *counts;
+    if (csr_alloc(g, chunks, &counts) != 0)
+    {
+        CSR_FREE(g, g);
+        return NULL;
+    }
+
+    const struct csr_edge *list = darray_data(edges);
+    const unsigned char   *data = payloads != NULL ? darray_data(payloads)
+                                                   : NULL;
+    struct csr_job         jobs[DS_PARALLEL_MAX];
+
+    for (size_t c = 0; c < chunks; c++)
+    {
+        size_t n    = g->edge_amount;
+        size_t from = (c * (n / chunks)) + (c < n % chunks ? c : n % chunks);
+
+        jobs[c].g            = g;
+        jobs[c].edges        = list + from;
+        jobs[c].payloads     = data != NULL ? data + (from * g->payload_size)
+                                            : NULL;
+        jobs[c].amount       = (n / chunks) + (c < n % chunks ? 1 : 0);
+        jobs[c].counts       = counts + (c * vertex_amount);
+        jobs[c].out_of_range = 0;
+    }
+
+    ds_parallel_run(csr_count, jobs, sizeof(struct csr_job), chunks);
+
+    for (size_t c = 0; c < chunks; c++)
+    {
+        if (jobs[c].out_of_range)
+        {
+            CSR_FREE(g, counts);
+            csr_free(g);
+            errno = ERANGE;
+            return NULL;
+        }
+    }
+
+    /*
+     * Every vertex starts where the previous one ends, and inside it every
+     * chunk writes after the chunks before it, keeping the edge order.
+     */
+    size_t offset = 0;
+    for (size_t v = 0; v < vertex_amount; v++)
+    {
+        g->offsets[v] = offset;
+        for (size_t c = 0; c < chunks; c++)
+        {
+            size_t count = jobs[c].counts[v];
+
+            jobs[c].counts[v]  = offset;
+            offset            += count;
+        }
+    }
+    g->offsets[vertex_amount] = offset;
+
+    ds_parallel_run(csr_scatter, jobs, sizeof(struct csr_job), chunks);
+
+    CSR_FREE(g, counts);
+    return g;
+}
+
+
+csr_t
+csr_new(size_t vertex_amount, darray_t edges, darray_t payloads)
+{
+    return csr_new_with_allocator(vertex_amount, edges, payloads, NULL, NULL);
+}
+
+
+void
+csr_free(csr_t g)
+{
+    CSR_FREE(g, g->offsets);
+    CSR_FREE(g, g->targets);
+    if (g->payloads != NULL) CSR_FREE(g, g->payloads);
+    CSR_FREE(g, g);
+}
+
+
+const uint32_t *
+csr_neighbors(csr_t g, uint32_t vertex, size_t *amount)
+{
+    if (vertex >= g->vertex_amount)
+    {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    if (amount != NULL)
+        *amount = g->offsets[vertex + 1] - g->offsets[vertex];
+    return g->targets + g->offsets[vertex];
+}
+
+
+void *
+csr_payloads(csr_t g, uint32_t vertex)
+{
+    if (g->payloads == NULL || vertex >= g->vertex_amount) return NULL;
+    return g->payloads + (g->offsets[vertex] * g->payload_size);
+}
+
+
+size_t
+csr_degree(csr_t g, uint32_t vertex)
+{
+    if (vertex >= g->vertex_amount) return 0;
+    return g->offsets[vertex + 1] - g->offsets[vertex];
+}
+
+
+void
+csr_in_degrees(csr_t g, size_t *degrees)
+{
+    memset(degrees, 0, g->vertex_amount * sizeof(size_t));
+    for (size_t i = 0; i < g->edge_amount; i++) degrees[g->targets[i]]++;
+}
+
+
+size_t
+csr_bfs(csr_t g, uint32_t source, uint32_t *distances, uint32_t *order)
+{
+    if (source >= g->vertex_amount)
+    {
+        errno = ERANGE;
+        return 0;
+    }
+
+    /* the visit order doubles as the queue */
+    uint32_t *queue = order;
+    if (queue == NULL)
+    {
+        queue = ELSE_IF_NULL(g->malloc_fn, malloc,
+                             g->vertex_amount * sizeof(uint32_t));
+        if (queue == NULL) return 0;
+    }
+
+    for (size_t v = 0; v < g->vertex_amount; v++) distances[v] = CSR_UNREACHED;
+
+    size_t head = 0;
+    size_t tail = 0;
+
+    distances[source] = 0;
+    queue[tail++]     = source;
+
+    while (head < tail)
+    {
+        const uint32_t vertex = queue[head++];
+        const uint32_t next   = distances[vertex] + 1;
+        const size_t   end    = g->offsets[vertex + 1];
+
+        for (size_t i = g->offsets[vertex]; i < end; i++)
+        {
+            const uint32_t target = g->targets[i];
+            if (distances[target] != CSR_UNREACHED) continue;
+
+            distances[target] = next;
+            queue[tail++]     = target;
+        }
+    }
+
+    if (order == NULL) CSR_FREE(g, queue);
+    return tail;
+}
+
+
+size_t
+csr_vertex_amount(csr_t g)
+{
+    return g->vertex_amount;
+}
+
+
+size_t
+csr_edge_amount(csr_t g)
+{
+    return g->edge_amount;
+}
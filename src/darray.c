@@ -1,9 +1,20 @@
 #include "ds/darray.h"
 
 #include <errno.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "ds/__priv/bits.h"
+#include "ds/__priv/cpu.h"
+#include "ds/__priv/darray.h"
+#include "ds/__priv/tcache.h"
+
+#if defined(DS_CPU_X86) && defined(__SSE2__)
+#define DARRAY_SIMD 1
+#include <immintrin.h>
+#endif
+
 #define DARRAY_FREE(da, ptr) \
     ELSE_IF_NULL(((darray_t)da)->free_fn, free, ptr)
 
@@ -15,20 +26,126 @@
 #define DARRAY_GROWTH_FACTOR 1.5F
 #define DARRAY_INITIAL_SIZE 5
 
+/* the index a scan returns when no element matched */
+#define DARRAY_NONE SIZE_MAX
+
+/* how many elements ahead a gather or scatter prefetches by default */
+#define DARRAY_PREFETCH_DEFAULT 16
+
+#if defined(__GNUC__) || defined(__clang__)
+#define DARRAY_INLINE inline __attribute__((always_inline))
+#else
+#define DARRAY_INLINE inline
+#endif
+
+
+/* the buffer a dyn_array shares with its snapshots */
+struct darray_buffer
+{
+    size_t refs;
+    void  *data;
+
+    ds_free_fn free_fn;
+};
+
 
-struct dyn_array
+/* what a scan over the elements looks for */
+enum darray_scan
 {
-    void *data;
+    DARRAY_SCAN_FIRST,
+    DARRAY_SCAN_LAST,
+    DARRAY_SCAN_COUNT,
+};
+
+
+/* the equality mask of one vector of elements, a bit per byte */
+typedef uint32_t (*darray_mask_fn)(const unsigned char *block,
+                                   const unsigned char *lanes, size_t width);
+
+typedef size_t (*darray_scan_fn)(const unsigned char *data, size_t n,
+                                 const unsigned char *key, size_t width,
+                                 enum darray_scan scan);
+
+
+struct darray_snapshot
+{
+    size_t                refs;
+    struct darray_buffer *buf;
+
+    /* the references as a whole, plus one while ::publish may expose it */
+    size_t holders;
 
     size_t tp_size;
-    size_t alloc_size;
     size_t elem_amount;
 
-    ds_realloc_fn realloc_fn;
-    ds_free_fn    free_fn;
+    /* links the snapshots that were unpublished but not yet released */
+    struct darray_snapshot *next;
+    ds_free_fn              free_fn;
 };
 
 
+static void
+darray_buffer_release(struct darray_buffer *buf)
+{
+    if (__atomic_fetch_sub(&buf->refs, 1, __ATOMIC_ACQ_REL) != 1) return;
+
+    if (buf->data != NULL) ELSE_IF_NULL(buf->free_fn, free, buf->data);
+    ELSE_IF_NULL(buf->free_fn, free, buf);
+}
+
+
+/*
+ * Called before writing to the elements from @from onwards. If a snapshot
+ * may see them, the buffer is copied, unless no snapshot is left to see it.
+ */
+static int
+darray_unshare(darray_t da, size_t from)
+{
+    struct darray_buffer *buf = da->shared;
+    if (buf == NULL || from >= da->shared_size) return 0;
+
+    if (__atomic_load_n(&buf->refs, __ATOMIC_ACQUIRE) > 1)
+    {
+        errno      = 0;
+        void *copy = DARRAY_REALLOC(da, NULL, da->alloc_size * da->tp_size);
+        if (copy == NULL) return -1;
+
+        if (da->elem_amount > 0)
+            memcpy(copy, da->data, da->elem_amount * da->tp_size);
+        da->data = copy;
+        darray_buffer_release(buf);
+    }
+    else
+        DARRAY_FREE(da, buf);
+
+    da->shared      = NULL;
+    da->shared_size = 0;
+    return 0;
+}
+
+
+static void
+darray_snapshot_drop(struct darray_snapshot *snap)
+{
+    if (__atomic_fetch_sub(&snap->holders, 1, __ATOMIC_ACQ_REL) == 1)
+        ELSE_IF_NULL(snap->free_fn, free, snap);
+}
+
+
+static void
+darray_drain_retired(darray_t da, size_t phase)
+{
+    struct darray_snapshot **retired = &da->retired[phase & 1];
+
+    while (*retired != NULL)
+    {
+        struct darray_snapshot *next = (*retired)->next;
+        darray_snapshot_drop(*retired);
+        *retired = next;
+    }
+}
+
+
 struct dyn_array *
 darray_new_with_allocator(size_t type_size, ds_malloc_fn malloc_func,
                           ds_realloc_fn realloc_fn, ds_free_fn free_fn)
@@ -39,8 +156,9 @@ darray_new_with_allocator(size_t type_size, ds_malloc_fn malloc_func,
         return NULL;
     }
 
+    /* handles without a custom allocator go through the thread-local cache */
     struct dyn_array *da = malloc_func == NULL
-                             ? malloc(sizeof(struct dyn_array))
+                             ? ds_tcache_malloc(sizeof(struct dyn_array))
                              : malloc_func(sizeof(struct dyn_array));
     if (da == NULL) return NULL;
 
@@ -51,6 +169,18 @@ darray_new_with_allocator(size_t type_size, ds_malloc_fn malloc_func,
     da->data       = NULL;
     da->realloc_fn = realloc_fn;
     da->free_fn    = free_fn;
+
+    da->shared      = NULL;
+    da->shared_size = 0;
+    da->published   = NULL;
+    da->phase       = 0;
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        da->retired[i]   = NULL;
+        da->acquiring[i] = 0;
+    }
+
     return da;
 }
 
@@ -65,14 +195,42 @@ darray_new(size_t type_size)
 void
 darray_free(darray_t da)
 {
-    DARRAY_FREE(da, da);
+    if (da->published != NULL)
+    {
+        darray_snapshot_release(da->published);
+        darray_snapshot_drop(da->published);
+    }
+
+    darray_drain_retired(da, 0);
+    darray_drain_retired(da, 1);
+
+    /* the last snapshot sharing the buffer frees it */
+    if (da->shared != NULL)
+    {
+        if (__atomic_load_n(&da->shared->refs, __ATOMIC_ACQUIRE) == 1)
+            DARRAY_FREE(da, da->shared);
+        else
+            darray_buffer_release(da->shared);
+    }
+
+    if (da->free_fn == NULL)
+        ds_tcache_free(da, sizeof(struct dyn_array));
+    else
+        da->free_fn(da);
 }
 
 
 void
 darray_free_full(darray_t da)
 {
-    if (da->data != NULL) DARRAY_FREE(da, da->data);
+    if (da->shared != NULL)
+    {
+        darray_buffer_release(da->shared);
+        da->shared = NULL;
+    }
+    else if (da->data != NULL)
+        DARRAY_FREE(da, da->data);
+
     darray_free(da);
 }
 
@@ -87,7 +245,25 @@ darray_reserve(darray_t da, size_t size)
         return NULL;
     }
 
-    errno          = 0;
+    errno = 0;
+
+    /* a buffer shared with snapshots must not move under them */
+    if (da->shared != NULL)
+    {
+        void *new_data = DARRAY_REALLOC(da, NULL, size * da->tp_size);
+        if (new_data == NULL) return NULL;
+
+        if (da->elem_amount > 0)
+            memcpy(new_data, da->data, da->elem_amount * da->tp_size);
+        darray_buffer_release(da->shared);
+
+        da->data        = new_data;
+        da->shared      = NULL;
+        da->shared_size = 0;
+        da->alloc_size  = size;
+        return da->data;
+    }
+
     void *new_data = DARRAY_REALLOC(da, da->data, size * da->tp_size);
     if (new_data == NULL) return NULL;
 
@@ -107,20 +283,25 @@ darray_resize(darray_t da, size_t size)
 
     if (size > old_size)
     {
+        if (darray_unshare(da, old_size) != 0) return NULL;
+
         size_t diff  = size - old_size;
         void  *start = (char *)da->data + (old_size * da->tp_size);
         memset(start, 0, diff * da->tp_size);
     }
 
     da->elem_amount = size;
-    return res;
+    return da->data;
 }
 
 
 void
 darray_clear(darray_t da)
 {
-    if (da->data != NULL) memset(da->data, 0, da->elem_amount * da->tp_size);
+    /* zeroing a buffer that snapshots still read would corrupt them */
+    if (da->shared == NULL && da->data != NULL)
+        memset(da->data, 0, da->elem_amount * da->tp_size);
+
     da->elem_amount = 0;
 }
 
@@ -157,6 +338,8 @@ darray_insert(const darray_t restrict da, void *restrict data, size_t pos)
         if (darray_reserve(da, size) == NULL) return NULL;
     }
 
+    if (darray_unshare(da, pos) != 0) return NULL;
+
     if (pos == da->elem_amount)
     {
         da->elem_amount++;
@@ -201,10 +384,12 @@ darray_erase(darray_t da, size_t pos)
         return da->data;
     }
 
+    if (darray_unshare(da, pos) != 0) return NULL;
+
     if (pos < da->elem_amount - 1)
     {
         char  *base          = (char *)da->data;
-        size_t bytes_to_move = (da->elem_amount - pos) * da->tp_size;
+        size_t bytes_to_move = (da->elem_amount - pos - 1) * da->tp_size;
 
         void *dest = base + (pos * da->tp_size);
         void *src  = base + ((pos + 1) * da->tp_size);
@@ -271,3 +456,568 @@ darray_pop_front(const darray_t da)
 {
     return darray_erase(da, 0);
 }
+
+
+/*
+ * Scans the elements from @from to @to one at a time. Returns the index of
+ * the element found, or DARRAY_NONE, or the amount of equal elements for
+ * DARRAY_SCAN_COUNT. Inlined with a constant @width , the `memcmp` becomes
+ * a single compare.
+ */
+static DARRAY_INLINE size_t
+darray_scan_range(const unsigned char *data, size_t from, size_t to,
+                  const unsigned char *key, size_t width,
+                  enum darray_scan scan)
+{
+    size_t count = 0;
+
+    for (size_t i = from; i < to; i++)
+    {
+        size_t index = scan == DARRAY_SCAN_LAST ? to - 1 - (i - from) : i;
+        if (memcmp(data + (index * width), key, width) != 0) continue;
+
+        if (scan != DARRAY_SCAN_COUNT) return index;
+        count++;
+    }
+
+    return scan == DARRAY_SCAN_COUNT ? count : DARRAY_NONE;
+}
+
+
+/* elements of other sizes, the larger ones filtered by their first word */
+static size_t
+darray_scan_wide(const unsigned char *data, size_t n, const unsigned char *key,
+                 size_t width, enum darray_scan scan)
+{
+    if (width < sizeof(uint64_t))
+        return darray_scan_range(data, 0, n, key, width, scan);
+
+    uint64_t head;
+    memcpy(&head, key, sizeof(head));
+
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t               index = scan == DARRAY_SCAN_LAST ? n - 1 - i : i;
+        const unsigned char *elem  = data + (index * width);
+
+        uint64_t word;
+        memcpy(&word, elem, sizeof(word));
+
+        if (word != head
+            || memcmp(elem + sizeof(word), key + sizeof(word),
+                      width - sizeof(word))
+                   != 0)
+            continue;
+
+        if (scan != DARRAY_SCAN_COUNT) return index;
+        count++;
+    }
+
+    return scan == DARRAY_SCAN_COUNT ? count : DARRAY_NONE;
+}
+
+
+#ifdef DARRAY_SIMD
+/*
+ * Scans @n elements of 1, 2, 4 or 8 bytes a vector of @bytes at a time.
+ * Inlined into a kernel, @mask_fn is a direct call and @width a constant.
+ */
+static DARRAY_INLINE size_t
+darray_scan_blocks(const unsigned char *data, size_t n,
+                   const unsigned char *key, size_t width,
+                   enum darray_scan scan, size_t bytes, darray_mask_fn mask_fn)
+{
+    unsigned char lanes[32];
+    for (size_t i = 0; i < bytes; i += width) memcpy(lanes + i, key, width);
+
+    const size_t per    = bytes / width;
+    const size_t blocks = n / per;
+
+    if (scan == DARRAY_SCAN_LAST)
+    {
+        size_t found = darray_scan_range(data, blocks * per, n, key, width,
+                                         scan);
+        if (found != DARRAY_NONE) return found;
+
+        for (size_t b = blocks; b-- > 0;)
+        {
+            uint32_t mask = mask_fn(data + (b * bytes), lanes, width);
+            if (mask != 0) return (b * per) + ((63 - ds_clz64(mask)) / width);
+        }
+
+        return DARRAY_NONE;
+    }
+
+    size_t count = 0;
+    for (size_t b = 0; b < blocks; b++)
+    {
+        uint32_t mask = mask_fn(data + (b * bytes), lanes, width);
+
+        if (scan == DARRAY_SCAN_COUNT)
+            count += ds_popcount64(mask);
+        else if (mask != 0)
+            return (b * per) + (ds_ctz64(mask) / width);
+    }
+
+    size_t rest = darray_scan_range(data, blocks * per, n, key, width, scan);
+    return scan == DARRAY_SCAN_COUNT ? (count / width) + rest : rest;
+}
+
+
+static DARRAY_INLINE uint32_t
+darray_mask_sse2(const unsigned char *block, const unsigned char *lanes,
+                 size_t width)
+{
+    __m128i vec = _mm_loadu_si128((const __m128i *)block);
+    __m128i key = _mm_loadu_si128((const __m128i *)lanes);
+    __m128i eq;
+
+    switch (width)
+    {
+    case 1:  eq = _mm_cmpeq_epi8(vec, key); break;
+    case 2:  eq = _mm_cmpeq_epi16(vec, key); break;
+    case 4:  eq = _mm_cmpeq_epi32(vec, key); break;
+    default:
+        /* SSE2 has no 64-bit compare, so both halves have to be equal */
+        eq = _mm_cmpeq_epi32(vec, key);
+        eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        break;
+    }
+
+    return (uint32_t)_mm_movemask_epi8(eq);
+}
+
+
+__attribute__((target("avx2"))) static DARRAY_INLINE uint32_t
+darray_mask_avx2(const unsigned char *block, const unsigned char *lanes,
+                 size_t width)
+{
+    __m256i vec = _mm256_loadu_si256((const __m256i *)block);
+    __m256i key = _mm256_loadu_si256((const __m256i *)lanes);
+    __m256i eq;
+
+    switch (width)
+    {
+    case 1:  eq = _mm256_cmpeq_epi8(vec, key); break;
+    case 2:  eq = _mm256_cmpeq_epi16(vec, key); break;
+    case 4:  eq = _mm256_cmpeq_epi32(vec, key); break;
+    default: eq = _mm256_cmpeq_epi64(vec, key); break;
+    }
+
+    return (uint32_t)_mm256_movemask_epi8(eq);
+}
+
+
+static size_t
+darray_scan_sse2(const unsigned char *data, size_t n, const unsigned char *key,
+                 size_t width, enum darray_scan scan)
+{
+    switch (width)
+    {
+    case 1:
+        return darray_scan_blocks(data, n, key, 1, scan, 16, darray_mask_sse2);
+    case 2:
+        return darray_scan_blocks(data, n, key, 2, scan, 16, darray_mask_sse2);
+    case 4:
+        return darray_scan_blocks(data, n, key, 4, scan, 16, darray_mask_sse2);
+    default:
+        return darray_scan_blocks(data, n, key, 8, scan, 16, darray_mask_sse2);
+    }
+}
+
+
+__attribute__((target("avx2,popcnt"))) static size_t
+darray_scan_avx2(const unsigned char *data, size_t n, const unsigned char *key,
+                 size_t width, enum darray_scan scan)
+{
+    switch (width)
+    {
+    case 1:
+        return darray_scan_blocks(data, n, key, 1, scan, 32, darray_mask_avx2);
+    case 2:
+        return darray_scan_blocks(data, n, key, 2, scan, 32, darray_mask_avx2);
+    case 4:
+        return darray_scan_blocks(data, n, key, 4, scan, 32, darray_mask_avx2);
+    default:
+        return darray_scan_blocks(data, n, key, 8, scan, 32, darray_mask_avx2);
+    }
+}
+
+
+static darray_scan_fn darray_scan_kernel;
+
+
+/* picks the widest kernel the CPU runs, once */
+static darray_scan_fn
+darray_scan_select(void)
+{
+    darray_scan_fn fn = __atomic_load_n(&darray_scan_kernel, __ATOMIC_RELAXED);
+    if (fn != NULL) return fn;
+
+    fn = ds_cpu_avx2() ? darray_scan_avx2 : darray_scan_sse2;
+
+    __atomic_store_n(&darray_scan_kernel, fn, __ATOMIC_RELAXED);
+    return fn;
+}
+#endif
+
+
+static size_t
+darray_scan(const darray_t da, const void *key, enum darray_scan scan)
+{
+    const unsigned char *data = da->data;
+    const size_t         n    = da->elem_amount;
+
+    if (n == 0) return scan == DARRAY_SCAN_COUNT ? 0 : DARRAY_NONE;
+
+#ifdef DARRAY_SIMD
+    if (da->tp_size == 1 || da->tp_size == 2 || da->tp_size == 4
+        || da->tp_size == 8)
+        return darray_scan_select()(data, n, key, da->tp_size, scan);
+#else
+    switch (da->tp_size)
+    {
+    case 1:  return darray_scan_range(data, 0, n, key, 1, scan);
+    case 2:  return darray_scan_range(data, 0, n, key, 2, scan);
+    case 4:  return darray_scan_range(data, 0, n, key, 4, scan);
+    case 8:  return darray_scan_range(data, 0, n, key, 8, scan);
+    default: break;
+    }
+#endif
+
+    return darray_scan_wide(data, n, key, da->tp_size, scan);
+}
+
+
+void *
+darray_find(const darray_t da, const void *key)
+{
+    size_t index = darray_scan(da, key, DARRAY_SCAN_FIRST);
+    return index != DARRAY_NONE ? (char *)da->data + (index * da->tp_size)
+                                : NULL;
+}
+
+
+void *
+darray_find_last(const darray_t da, const void *key)
+{
+    size_t index = darray_scan(da, key, DARRAY_SCAN_LAST);
+    return index != DARRAY_NONE ? (char *)da->data + (index * da->tp_size)
+                                : NULL;
+}
+
+
+size_t
+darray_count(const darray_t da, const void *key)
+{
+    return darray_scan(da, key, DARRAY_SCAN_COUNT);
+}
+
+
+static size_t darray_prefetch = DARRAY_PREFETCH_DEFAULT;
+
+
+/*
+ * Copies the element @indices[i] of @in to the element i of @out ,
+ * prefetching the element @distance indices ahead. Inlined with a constant
+ * @width , the `memcpy` becomes a single move.
+ */
+static DARRAY_INLINE void
+darray_gather_range(unsigned char *restrict out,
+                    const unsigned char *restrict in,
+                    const size_t *restrict indices, size_t n, size_t width,
+                    size_t distance)
+{
+    size_t i = 0;
+
+    if (distance > 0 && n > distance)
+        for (; i < n - distance; i++)
+        {
+            __builtin_prefetch(in + (indices[i + distance] * width));
+            memcpy(out + (i * width), in + (indices[i] * width), width);
+        }
+
+    for (; i < n; i++)
+        memcpy(out + (i * width), in + (indices[i] * width), width);
+}
+
+
+/* the same as darray_gather_range, the other way around */
+static DARRAY_INLINE void
+darray_scatter_range(unsigned char *restrict out,
+                     const unsigned char *restrict in,
+                     const size_t *restrict indices, size_t n, size_t width,
+                     size_t distance)
+{
+    size_t i = 0;
+
+    if (distance > 0 && n > distance)
+        for (; i < n - distance; i++)
+        {
+            __builtin_prefetch(out + (indices[i + distance] * width), 1);
+            memcpy(out + (indices[i] * width), in + (i * width), width);
+        }
+
+    for (; i < n; i++)
+        memcpy(out + (indices[i] * width), in + (i * width), width);
+}
+
+
+/*
+ * AVX2 gathers were measured no faster than these loops, on random indices
+ * both in and out of the cache, so every CPU runs them.
+ */
+static void
+darray_gather_scalar(unsigned char *restrict out,
+                     const unsigned char *restrict in,
+                     const size_t *restrict indices, size_t n, size_t width,
+                     size_t distance)
+{
+    switch (width)
+    {
+    case 1:  darray_gather_range(out, in, indices, n, 1, distance); break;
+    case 2:  darray_gather_range(out, in, indices, n, 2, distance); break;
+    case 4:  darray_gather_range(out, in, indices, n, 4, distance); break;
+    case 8:  darray_gather_range(out, in, indices, n, 8, distance); break;
+    case 16: darray_gather_range(out, in, indices, n, 16, distance); break;
+    default: darray_gather_range(out, in, indices, n, width, distance); break;
+    }
+}
+
+
+static void
+darray_scatter_scalar(unsigned char *restrict out,
+                      const unsigned char *restrict in,
+                      const size_t *restrict indices, size_t n, size_t width,
+                      size_t distance)
+{
+    switch (width)
+    {
+    case 1:  darray_scatter_range(out, in, indices, n, 1, distance); break;
+    case 2:  darray_scatter_range(out, in, indices, n, 2, distance); break;
+    case 4:  darray_scatter_range(out, in, indices, n, 4, distance); break;
+    case 8:  darray_scatter_range(out, in, indices, n, 8, distance); break;
+    case 16: darray_scatter_range(out, in, indices, n, 16, distance); break;
+    default: darray_scatter_range(out, in, indices, n, width, distance); break;
+    }
+}
+
+
+/* checks every index in one branchless pass before anything is written */
+static int
+darray_check_indices(const size_t *indices, size_t n, size_t size)
+{
+    int out_of_range = 0;
+    for (size_t i = 0; i < n; i++) out_of_range |= indices[i] >= size;
+
+    if (out_of_range) errno = ERANGE;
+    return out_of_range ? -1 : 0;
+}
+
+
+void
+darray_set_prefetch_distance(size_t distance)
+{
+    __atomic_store_n(&darray_prefetch, distance, __ATOMIC_RELAXED);
+}
+
+
+size_t
+darray_prefetch_distance(void)
+{
+    return __atomic_load_n(&darray_prefetch, __ATOMIC_RELAXED);
+}
+
+
+int
+darray_gather(darray_t dst, darray_t src, const size_t *restrict indices,
+              size_t n)
+{
+    if (dst == src || dst->tp_size != src->tp_size)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (darray_check_indices(indices, n, src->elem_amount) != 0) return -1;
+
+    if (n > dst->alloc_size && darray_reserve(dst, n) == NULL) return -1;
+    if (darray_unshare(dst, 0) != 0) return -1;
+
+    darray_gather_scalar(dst->data, src->data, indices, n, src->tp_size,
+                         darray_prefetch_distance());
+
+    dst->elem_amount = n;
+    return 0;
+}
+
+
+int
+darray_scatter(darray_t dst, const size_t *restrict indices, darray_t src,
+               size_t n)
+{
+    if (dst == src || dst->tp_size != src->tp_size)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (n > src->elem_amount)
+    {
+        errno = ERANGE;
+        return -1;
+    }
+
+    if (darray_check_indices(indices, n, dst->elem_amount) != 0) return -1;
+    if (darray_unshare(dst, 0) != 0) return -1;
+
+    darray_scatter_scalar(dst->data, src->data, indices, n, src->tp_size,
+                          darray_prefetch_distance());
+    return 0;
+}
+
+
+darray_snapshot_t
+darray_snapshot(darray_t da)
+{
+    errno = 0;
+    if (da->shared == NULL)
+    {
+        struct darray_buffer *buf
+            = DARRAY_REALLOC(da, NULL, sizeof(struct darray_buffer));
+        if (buf == NULL) return NULL;
+
+        buf->refs    = 1;
+        buf->data    = da->data;
+        buf->free_fn = da->free_fn;
+        da->shared   = buf;
+    }
+
+    struct darray_snapshot *snap
+        = DARRAY_REALLOC(da, NULL, sizeof(struct darray_snapshot));
+    if (snap == NULL) return NULL;
+
+    snap->refs        = 1;
+    snap->holders     = 1;
+    snap->buf         = da->shared;
+    snap->tp_size     = da->tp_size;
+    snap->elem_amount = da->elem_amount;
+    snap->next        = NULL;
+    snap->free_fn     = da->free_fn;
+
+    __atomic_fetch_add(&da->shared->refs, 1, __ATOMIC_RELAXED);
+    if (da->elem_amount > da->shared_size) da->shared_size = da->elem_amount;
+
+    return snap;
+}
+
+
+void
+darray_snapshot_release(darray_snapshot_t snap)
+{
+    if (__atomic_fetch_sub(&snap->refs, 1, __ATOMIC_ACQ_REL) != 1) return;
+
+    darray_buffer_release(snap->buf);
+    darray_snapshot_drop(snap);
+}
+
+
+size_t
+darray_snapshot_size(darray_snapshot_t snap)
+{
+    return snap->elem_amount;
+}
+
+
+const void *
+darray_snapshot_data(darray_snapshot_t snap)
+{
+    return snap->buf->data;
+}
+
+
+const void *
+darray_snapshot_at(darray_snapshot_t snap, size_t index)
+{
+    if (index >= snap->elem_amount)
+    {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    return (const char *)snap->buf->data + (index * snap->tp_size);
+}
+
+
+int
+darray_publish(darray_t da)
+{
+    darray_snapshot_t snap = darray_snapshot(da);
+    if (snap == NULL) return -1;
+
+    snap->holders = 2;
+
+    darray_snapshot_t old
+        = __atomic_exchange_n(&da->published, snap, __ATOMIC_SEQ_CST);
+    if (old == NULL) return 0;
+
+    /* the elements go with the last reference, readers can not revive it */
+    darray_snapshot_release(old);
+
+    const size_t phase = da->phase;
+    old->next              = da->retired[phase & 1];
+    da->retired[phase & 1] = old;
+
+    /*
+     * What stays is the struct itself, which an ::acquire may still be
+     * looking at. Such a reader entered in this phase or in the previous
+     * one. Once no reader of the previous phase is left, what was retired
+     * during it can go, and the phase moves on.
+     */
+    if (__atomic_load_n(&da->acquiring[(phase + 1) & 1], __ATOMIC_SEQ_CST)
+        == 0)
+    {
+        darray_drain_retired(da, phase + 1);
+        __atomic_store_n(&da->phase, phase + 1, __ATOMIC_SEQ_CST);
+    }
+
+    return 0;
+}
+
+
+darray_snapshot_t
+darray_acquire(darray_t da)
+{
+    size_t phase = __atomic_load_n(&da->phase, __ATOMIC_SEQ_CST);
+
+    /* the phase must not have moved on before the reader was counted */
+    for (;;)
+    {
+        __atomic_fetch_add(&da->acquiring[phase & 1], 1, __ATOMIC_SEQ_CST);
+
+        const size_t now = __atomic_load_n(&da->phase, __ATOMIC_SEQ_CST);
+        if (now == phase) break;
+
+        __atomic_fetch_sub(&da->acquiring[phase & 1], 1, __ATOMIC_RELEASE);
+        phase = now;
+    }
+
+    /* a snapshot without references was replaced, load its successor */
+    darray_snapshot_t snap;
+    size_t            refs = 0;
+    while ((snap = __atomic_load_n(&da->published, __ATOMIC_SEQ_CST)) != NULL)
+    {
+        refs = __atomic_load_n(&snap->refs, __ATOMIC_RELAXED);
+        while (refs != 0
+               && !__atomic_compare_exchange_n(&snap->refs, &refs, refs + 1,
+                                               1, __ATOMIC_ACQUIRE,
+                                               __ATOMIC_RELAXED));
+        if (refs != 0) break;
+    }
+
+    __atomic_fetch_sub(&da->acquiring[phase & 1], 1, __ATOMIC_RELEASE);
+
+    if (snap == NULL) errno = ENOENT;
+    return snap;
+}
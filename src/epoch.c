@@ -0,0 +1,370 @@
+#define _POSIX_C_SOURCE 200809L
+#include "ds/epoch.h"
+
+#include <errno.h>
+#include <stdlib.h>
+
+#include <pthread.h>
+
+#define EPOCH_FREE(ep, ptr) \
+    ELSE_IF_NULL(((epoch_t)ep)->free_fn, free, ptr)
+
+#define EPOCH_MALLOC(ep, size) \
+    ELSE_IF_NULL(((epoch_t)ep)->malloc_fn, malloc, size)
+
+#define EPOCH_LOAD(ptr, order)   __atomic_load_n(ptr, __ATOMIC_##order)
+#define EPOCH_STORE(ptr, val, order) \
+    __atomic_store_n(ptr, val, __ATOMIC_##order)
+#define EPOCH_CAS(ptr, expected, desired)                          \
+    __atomic_compare_exchange_n(ptr, expected, desired, 0,         \
+                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+/* the amount of retirements a thread makes before trying to reclaim */
+#define EPOCH_COLLECT_INTERVAL 64
+
+/* a record is freed by whichever side clears the last of these flags */
+#define EPOCH_LIVE     1 /* the domain has not been freed yet */
+#define EPOCH_ATTACHED 2 /* a thread uses the record */
+
+
+/*
+ * Each thread that has entered a domain owns one record. `state` holds the
+ * epoch the thread observed on entry shifted left by one, with the lowest
+ * bit set while the thread is inside the domain.
+ *
+ * The records of a thread are chained through `thread_next`, and the head of
+ * that chain is the value of the one process-wide key, so the amount of
+ * domains is not bound by `PTHREAD_KEYS_MAX`.
+ */
+struct epoch_record
+{
+    struct epoch_record *next;
+    struct epoch_record *thread_next;
+
+    epoch_t    domain;
+    ds_free_fn free_fn;
+    int        flags;
+
+    uint64_t state;
+    size_t   nesting;
+
+    struct epoch_node *limbo;
+    size_t             pending;
+};
+
+
+struct epoch_domain
+{
+    uint64_t             epoch;
+    struct epoch_record *records;
+
+    /* retirements of threads that could not get a record */
+    pthread_mutex_t    orphans_lock;
+    struct epoch_node *orphans;
+
+    ds_malloc_fn malloc_fn;
+    ds_free_fn   free_fn;
+};
+
+
+static pthread_key_t  epoch_key;
+static pthread_once_t epoch_key_once = PTHREAD_ONCE_INIT;
+static int            epoch_key_error;
+
+
+static void
+epoch_record_drop(struct epoch_record *rec, int flag)
+{
+    if (__atomic_fetch_and(&rec->flags, ~flag, __ATOMIC_ACQ_REL) == flag)
+        ELSE_IF_NULL(rec->free_fn, free, rec);
+}
+
+
+static void
+epoch_thread_exit(void *ptr)
+{
+    struct epoch_record *rec = ptr;
+
+    while (rec != NULL)
+    {
+        struct epoch_record *next = rec->thread_next;
+
+        rec->nesting = 0;
+        EPOCH_STORE(&rec->state, 0, RELEASE);
+        epoch_record_drop(rec, EPOCH_ATTACHED);
+
+        rec = next;
+    }
+}
+
+
+static void
+epoch_key_create(void)
+{
+    epoch_key_error = pthread_key_create(&epoch_key, epoch_thread_exit);
+}
+
+
+/*
+ * Finds the record of the calling thread for @ep and moves it to the front of
+ * the chain. Records of freed domains met on the way are freed, which is why
+ * the domain pointer is only compared once the record is known to be live.
+ */
+static struct epoch_record *
+epoch_record_find(epoch_t ep)
+{
+    struct epoch_record  *head = pthread_getspecific(epoch_key);
+    struct epoch_record **link = &head;
+    struct epoch_record  *rec;
+
+    if (head != NULL && head->domain == ep
+        && (EPOCH_LOAD(&head->flags, ACQUIRE) & EPOCH_LIVE))
+        return head;
+
+    while ((rec = *link) != NULL)
+    {
+        if (!(EPOCH_LOAD(&rec->flags, ACQUIRE) & EPOCH_LIVE))
+        {
+            *link = rec->thread_next;
+            epoch_record_drop(rec, EPOCH_ATTACHED);
+            continue;
+        }
+
+        if (rec->domain == ep)
+        {
+            *link            = rec->thread_next;
+            rec->thread_next = head;
+            head             = rec;
+            break;
+        }
+
+        link = &rec->thread_next;
+    }
+
+    pthread_setspecific(epoch_key, head);
+    return rec;
+}
+
+
+static struct epoch_record *
+epoch_record(epoch_t ep)
+{
+    struct epoch_record *rec = epoch_record_find(ep);
+    if (rec != NULL) return rec;
+
+    /* adopt a record left behind by an exited thread, limbo included */
+    for (rec = EPOCH_LOAD(&ep->records, ACQUIRE); rec != NULL; rec = rec->next)
+    {
+        int unused = EPOCH_LIVE;
+        if (EPOCH_CAS(&rec->flags, &unused, EPOCH_LIVE | EPOCH_ATTACHED))
+            goto found;
+    }
+
+    rec = EPOCH_MALLOC(ep, sizeof(struct epoch_record));
+    if (rec == NULL) return NULL;
+
+    rec->domain  = ep;
+    rec->free_fn = ep->free_fn;
+    rec->flags   = EPOCH_LIVE | EPOCH_ATTACHED;
+    rec->state   = 0;
+    rec->nesting = 0;
+    rec->limbo   = NULL;
+    rec->pending = 0;
+
+    rec->next = EPOCH_LOAD(&ep->records, RELAXED);
+    while (!EPOCH_CAS(&ep->records, &rec->next, rec));
+
+found:
+    rec->thread_next = pthread_getspecific(epoch_key);
+    errno            = pthread_setspecific(epoch_key, rec);
+    if (errno != 0)
+    {
+        epoch_record_drop(rec, EPOCH_ATTACHED);
+        return NULL;
+    }
+
+    return rec;
+}
+
+
+static void
+epoch_try_advance(epoch_t ep)
+{
+    uint64_t epoch = EPOCH_LOAD(&ep->epoch, SEQ_CST);
+
+    for (struct epoch_record *rec = EPOCH_LOAD(&ep->records, ACQUIRE);
+         rec != NULL; rec = rec->next)
+    {
+        uint64_t state = EPOCH_LOAD(&rec->state, ACQUIRE);
+        if ((state & 1) && (state >> 1) != epoch) return;
+    }
+
+    EPOCH_CAS(&ep->epoch, &epoch, epoch + 1);
+}
+
+
+static void
+epoch_free_nodes(epoch_t ep, struct epoch_node *node)
+{
+    while (node != NULL)
+    {
+        struct epoch_node *next = node->next;
+        EPOCH_FREE(ep, node->ptr);
+        node = next;
+    }
+}
+
+
+static void
+epoch_reclaim(epoch_t ep, struct epoch_node **limbo)
+{
+    uint64_t epoch = EPOCH_LOAD(&ep->epoch, ACQUIRE);
+
+    /* a limbo list is ordered from the newest to the oldest retirement */
+    struct epoch_node **link = limbo;
+    while (*link != NULL && (*link)->epoch + 2 > epoch) link = &(*link)->next;
+
+    struct epoch_node *node = *link;
+    *link                   = NULL;
+
+    epoch_free_nodes(ep, node);
+}
+
+
+epoch_t
+epoch_new_with_allocator(ds_malloc_fn malloc_fn, ds_free_fn free_fn)
+{
+    errno = pthread_once(&epoch_key_once, epoch_key_create);
+    if (errno == 0) errno = epoch_key_error;
+    if (errno != 0) return NULL;
+
+    epoch_t ep = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct epoch_domain));
+    if (ep == NULL) return NULL;
+
+    ep->epoch     = 0;
+    ep->records   = NULL;
+    ep->orphans   = NULL;
+    ep->malloc_fn = malloc_fn;
+    ep->free_fn   = free_fn;
+
+    errno = pthread_mutex_init(&ep->orphans_lock, NULL);
+    if (errno != 0)
+    {
+        EPOCH_FREE(ep, ep);
+        return NULL;
+    }
+
+    return ep;
+}
+
+
+epoch_t
+epoch_new(void)
+{
+    return epoch_new_with_allocator(NULL, NULL);
+}
+
+
+void
+epoch_free(epoch_t ep)
+{
+    /* the calling thread lets go of its record right away */
+    struct epoch_record *rec = epoch_record_find(ep);
+    if (rec != NULL)
+    {
+        pthread_setspecific(epoch_key, rec->thread_next);
+        epoch_record_drop(rec, EPOCH_ATTACHED);
+    }
+
+    /*
+     * Records still attached to other threads are freed by them, once they
+     * exit or next look for a record.
+     */
+    rec = ep->records;
+    while (rec != NULL)
+    {
+        struct epoch_record *next = rec->next;
+
+        epoch_free_nodes(ep, rec->limbo);
+        rec->limbo = NULL;
+        epoch_record_drop(rec, EPOCH_LIVE);
+        rec = next;
+    }
+
+    epoch_free_nodes(ep, ep->orphans);
+    pthread_mutex_destroy(&ep->orphans_lock);
+    EPOCH_FREE(ep, ep);
+}
+
+
+int
+epoch_enter(epoch_t ep)
+{
+    struct epoch_record *rec = epoch_record(ep);
+    if (rec == NULL) return -1;
+
+    if (rec->nesting++ == 0)
+    {
+        uint64_t epoch = EPOCH_LOAD(&ep->epoch, ACQUIRE);
+        EPOCH_STORE(&rec->state, (epoch << 1) | 1, SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+
+    return 0;
+}
+
+
+void
+epoch_leave(epoch_t ep)
+{
+    struct epoch_record *rec = epoch_record_find(ep);
+    if (rec == NULL || rec->nesting == 0) return;
+
+    if (--rec->nesting == 0) EPOCH_STORE(&rec->state, 0, RELEASE);
+}
+
+
+void
+epoch_retire(epoch_t ep, struct epoch_node *node, void *ptr)
+{
+    struct epoch_record *rec = epoch_record(ep);
+
+    node->ptr = ptr;
+
+    /* without a record of its own, the thread shares the orphan list */
+    if (rec == NULL)
+    {
+        pthread_mutex_lock(&ep->orphans_lock);
+        node->epoch = EPOCH_LOAD(&ep->epoch, ACQUIRE);
+        node->next  = ep->orphans;
+        ep->orphans = node;
+        pthread_mutex_unlock(&ep->orphans_lock);
+        return;
+    }
+
+    node->epoch = EPOCH_LOAD(&ep->epoch, ACQUIRE);
+    node->next  = rec->limbo;
+    rec->limbo  = node;
+
+    if (++rec->pending >= EPOCH_COLLECT_INTERVAL)
+    {
+        rec->pending = 0;
+        epoch_collect(ep);
+    }
+}
+
+
+void
+epoch_collect(epoch_t ep)
+{
+    epoch_try_advance(ep);
+
+    struct epoch_record *rec = epoch_record_find(ep);
+    if (rec != NULL) epoch_reclaim(ep, &rec->limbo);
+
+    if (pthread_mutex_trylock(&ep->orphans_lock) == 0)
+    {
+        epoch_reclaim(ep, &ep->orphans);
+        pthread_mutex_unlock(&ep->orphans_lock);
+    }
+}
@@ -0,0 +1,264 @@
+#include "ds/fenwick.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FENWICK_FREE(ft, ptr) \
+    ELSE_IF_NULL(((fenwick_t)ft)->free_fn, free, ptr)
+
+/* the entry covering a run of numbers ending at the 1-based @node */
+#define FENWICK_LOW(node) ((node) & (~(node) + 1))
+
+
+struct fenwick_tree
+{
+    /* `ints` for FENWICK_I64, so sums wrap around instead of overflowing */
+    union
+    {
+        uint64_t *ints;
+        double   *floats;
+    } tree;
+
+    size_t            size;
+    enum fenwick_type type;
+
+    ds_free_fn free_fn;
+};
+
+
+static int
+fenwick_check(fenwick_t ft, enum fenwick_type type, size_t from, size_t to)
+{
+    if (ft->type != type)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (from > to || to > ft->size)
+    {
+        errno = ERANGE;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*
+ * Both sums walk down from the two 1-based ends of the range, always
+ * moving the larger one, until they meet. The entries below that point
+ * would be added by one walk and subtracted by the other, so they are
+ * skipped instead, and doubles do not lose precision to them.
+ */
+static uint64_t
+fenwick_range_ints(fenwick_t ft, size_t from, size_t to)
+{
+    uint64_t sum = 0;
+
+    while (to != from)
+    {
+        if (to > from)
+        {
+            sum += ft->tree.ints[to - 1];
+            to  &= to - 1;
+        }
+        else
+        {
+            sum  -= ft->tree.ints[from - 1];
+            from &= from - 1;
+        }
+    }
+
+    return sum;
+}
+
+
+static double
+fenwick_range_floats(fenwick_t ft, size_t from, size_t to)
+{
+    double sum = 0;
+
+    while (to != from)
+    {
+        if (to > from)
+        {
+            sum += ft->tree.floats[to - 1];
+            to  &= to - 1;
+        }
+        else
+        {
+            sum  -= ft->tree.floats[from - 1];
+            from &= from - 1;
+        }
+    }
+
+    return sum;
+}
+
+
+fenwick_t
+fenwick_new_with_allocator(size_t size, enum fenwick_type type,
+                           ds_malloc_fn malloc_fn, ds_free_fn free_fn)
+{
+    if (type != FENWICK_I64 && type != FENWICK_F64)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if (size > SIZE_MAX / sizeof(uint64_t))
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    fenwick_t ft = ELSE_IF_NULL(malloc_fn, malloc,
+                                sizeof(struct fenwick_tree));
+    if (ft == NULL) return NULL;
+
+    ft->free_fn   = free_fn;
+    ft->size      = size;
+    ft->type      = type;
+    ft->tree.ints = ELSE_IF_NULL(malloc_fn, malloc,
+                                 size > 0 ? size * sizeof(uint64_t) : 1);
+
+    if (ft->tree.ints == NULL)
+    {
+        FENWICK_FREE(ft, ft);
+        return NULL;
+    }
+
+    fenwick_clear(ft);
+    return ft;
+}
+
+
+fenwick_t
+fenwick_new(size_t size, enum fenwick_type type)
+{
+    return fenwick_new_with_allocator(size, type, NULL, NULL);
+}
+
+
+fenwick_t
+fenwick_from_darray(darray_t da, enum fenwick_type type)
+{
+    if (darray_type_size(da) != sizeof(uint64_t))
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    const size_t size = darray_size(da);
+
+    fenwick_t ft = fenwick_new(size, type);
+    if (ft == NULL) return NULL;
+    if (size == 0) return ft;
+
+    memcpy(ft->tree.ints, darray_data(da), size * sizeof(uint64_t));
+
+    /* every entry hands its run on to the entry covering it next */
+    for (size_t node = 1; node <= size; node++)
+    {
+        size_t parent = node + FENWICK_LOW(node);
+        if (parent > size) continue;
+
+        if (type == FENWICK_I64)
+            ft->tree.ints[parent - 1] += ft->tree.ints[node - 1];
+        else
+            ft->tree.floats[parent - 1] += ft->tree.floats[node - 1];
+    }
+
+    return ft;
+}
+
+
+void
+fenwick_free(fenwick_t ft)
+{
+    FENWICK_FREE(ft, ft->tree.ints);
+    FENWICK_FREE(ft, ft);
+}
+
+
+int
+fenwick_add_i64(fenwick_t ft, size_t index, int64_t delta)
+{
+    if (fenwick_check(ft, FENWICK_I64, index, index + 1) != 0) return -1;
+
+    for (size_t node = index + 1; node <= ft->size; node += FENWICK_LOW(node))
+        ft->tree.ints[node - 1] += (uint64_t)delta;
+
+    return 0;
+}
+
+
+int
+fenwick_add_f64(fenwick_t ft, size_t index, double delta)
+{
+    if (fenwick_check(ft, FENWICK_F64, index, index + 1) != 0) return -1;
+
+    for (size_t node = index + 1; node <= ft->size; node += FENWICK_LOW(node))
+        ft->tree.floats[node - 1] += delta;
+
+    return 0;
+}
+
+
+int
+fenwick_set_i64(fenwick_t ft, size_t index, int64_t value)
+{
+    if (fenwick_check(ft, FENWICK_I64, index, index + 1) != 0) return -1;
+
+    uint64_t old = fenwick_range_ints(ft, index, index + 1);
+    return fenwick_add_i64(ft, index, (int64_t)((uint64_t)value - old));
+}
+
+
+int
+fenwick_set_f64(fenwick_t ft, size_t index, double value)
+{
+    if (fenwick_check(ft, FENWICK_F64, index, index + 1) != 0) return -1;
+
+    double old = fenwick_range_floats(ft, index, index + 1);
+    return fenwick_add_f64(ft, index, value - old);
+}
+
+
+int
+fenwick_sum_i64(fenwick_t ft, size_t from, size_t to, int64_t *out)
+{
+    if (fenwick_check(ft, FENWICK_I64, from, to) != 0) return -1;
+
+    *out = (int64_t)fenwick_range_ints(ft, from, to);
+    return 0;
+}
+
+
+int
+fenwick_sum_f64(fenwick_t ft, size_t from, size_t to, double *out)
+{
+    if (fenwick_check(ft, FENWICK_F64, from, to) != 0) return -1;
+
+    *out = fenwick_range_floats(ft, from, to);
+    return 0;
+}
+
+
+void
+fenwick_clear(fenwick_t ft)
+{
+    if (ft->type == FENWICK_I64)
+        memset(ft->tree.ints, 0, ft->size * sizeof(uint64_t));
+    else
+        for (size_t i = 0; i < ft->size; i++) ft->tree.floats[i] = 0;
+}
+
+
+size_t
+fenwick_size(fenwick_t ft)
+{
+    return ft->size;
+}
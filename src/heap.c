@@ -0,0 +1,333 @@
+#include "ds/heap.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HEAP_FREE(heap, ptr) \
+    ELSE_IF_NULL(((heap_t)heap)->free_fn, free, ptr)
+
+#define HEAP_MALLOC(heap, size) \
+    ELSE_IF_NULL(((heap_t)heap)->malloc_fn, malloc, size)
+
+#define HEAP_ARITY 4
+
+#define HEAP_AT(heap, index) \
+    ((char *)darray_data((heap)->da) + ((index) * (heap)->tp_size))
+
+
+struct dary_heap
+{
+    darray_t da;
+    size_t   tp_size;
+
+    /* holds the element being sifted, so moves never need a swap */
+    void *hole;
+
+    heap_cmp_fn   cmp;
+    heap_index_fn index_fn;
+
+    ds_malloc_fn malloc_fn;
+    ds_free_fn   free_fn;
+};
+
+
+static void
+heap_move(heap_t heap, size_t dest, const void *src)
+{
+    void *elem = HEAP_AT(heap, dest);
+    memcpy(elem, src, heap->tp_size);
+    if (heap->index_fn != NULL) heap->index_fn(elem, dest);
+}
+
+
+/*
+ * Places the element held in `hole` at position @index, or further up,
+ * moving the parents that should be below it down.
+ */
+static size_t
+heap_sift_up(heap_t heap, size_t index)
+{
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / HEAP_ARITY;
+        if (heap->cmp(heap->hole, HEAP_AT(heap, parent)) >= 0) break;
+
+        heap_move(heap, index, HEAP_AT(heap, parent));
+        index = parent;
+    }
+
+    heap_move(heap, index, heap->hole);
+    return index;
+}
+
+
+/*
+ * Places the element held in `hole` at position @index, or further down,
+ * moving the best child up until none should be above it.
+ */
+static size_t
+heap_sift_down(heap_t heap, size_t index)
+{
+    const size_t size = darray_size(heap->da);
+
+    for (;;)
+    {
+        size_t first = (index * HEAP_ARITY) + 1;
+        if (first >= size) break;
+
+        size_t last = first + HEAP_ARITY < size ? first + HEAP_ARITY : size;
+        size_t best = first;
+
+        for (size_t child = first + 1; child < last; child++)
+            if (heap->cmp(HEAP_AT(heap, child), HEAP_AT(heap, best)) < 0)
+                best = child;
+
+        if (heap->cmp(HEAP_AT(heap, best), heap->hole) >= 0) break;
+
+        heap_move(heap, index, HEAP_AT(heap, best));
+        index = best;
+    }
+
+    heap_move(heap, index, heap->hole);
+    return index;
+}
+
+
+/*
+ * Places the element held in `hole` at position @index of a valid heap,
+ * in whichever direction it belongs.
+ */
+static size_t
+heap_place(heap_t heap, size_t index)
+{
+    if (index > 0
+        && heap->cmp(heap->hole, HEAP_AT(heap, (index - 1) / HEAP_ARITY)) < 0)
+        return heap_sift_up(heap, index);
+
+    return heap_sift_down(heap, index);
+}
+
+
+static void
+heap_heapify(heap_t heap)
+{
+    const size_t size = darray_size(heap->da);
+    if (size < 2) goto notify;
+
+    for (size_t i = ((size - 2) / HEAP_ARITY) + 1; i-- > 0;)
+    {
+        memcpy(heap->hole, HEAP_AT(heap, i), heap->tp_size);
+        heap_sift_down(heap, i);
+    }
+
+notify:
+    /* elements that never moved have not been reported yet */
+    if (heap->index_fn != NULL)
+        for (size_t i = 0; i < size; i++)
+            heap->index_fn(HEAP_AT(heap, i), i);
+}
+
+
+static heap_t
+heap_init(heap_t heap, darray_t da, heap_cmp_fn cmp, ds_malloc_fn malloc_fn,
+          ds_free_fn free_fn)
+{
+    heap->da        = da;
+    heap->tp_size   = darray_type_size(da);
+    heap->cmp       = cmp;
+    heap->index_fn  = NULL;
+    heap->malloc_fn = malloc_fn;
+    heap->free_fn   = free_fn;
+
+    heap->hole = HEAP_MALLOC(heap, heap->tp_size);
+    if (heap->hole == NULL)
+    {
+        HEAP_FREE(heap, heap);
+        return NULL;
+    }
+
+    return heap;
+}
+
+
+heap_t
+heap_new_with_allocator(size_t type_size, heap_cmp_fn cmp,
+                        ds_malloc_fn malloc_fn, ds_realloc_fn realloc_fn,
+                        ds_free_fn free_fn)
+{
+    darray_t da = darray_new_with_allocator(type_size, malloc_fn, realloc_fn,
+                                            free_fn);
+    if (da == NULL) return NULL;
+
+    heap_t heap = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct dary_heap));
+    if (heap == NULL) goto err;
+
+    heap = heap_init(heap, da, cmp, malloc_fn, free_fn);
+    if (heap == NULL) goto err;
+
+    return heap;
+
+err:
+    darray_free(da);
+    return NULL;
+}
+
+
+heap_t
+heap_new(size_t type_size, heap_cmp_fn cmp)
+{
+    return heap_new_with_allocator(type_size, cmp, NULL, NULL, NULL);
+}
+
+
+heap_t
+heap_from_darray(darray_t da, heap_cmp_fn cmp)
+{
+    heap_t heap = malloc(sizeof(struct dary_heap));
+    if (heap == NULL) return NULL;
+
+    heap = heap_init(heap, da, cmp, NULL, NULL);
+    if (heap == NULL) return NULL;
+
+    heap_heapify(heap);
+    return heap;
+}
+
+
+void
+heap_free(heap_t heap)
+{
+    darray_free_full(heap->da);
+    HEAP_FREE(heap, heap->hole);
+    HEAP_FREE(heap, heap);
+}
+
+
+void
+heap_set_index_fn(heap_t heap, heap_index_fn index_fn)
+{
+    heap->index_fn = index_fn;
+    if (index_fn == NULL) return;
+
+    for (size_t i = 0; i < darray_size(heap->da); i++)
+        index_fn(HEAP_AT(heap, i), i);
+}
+
+
+void *
+heap_push(heap_t heap, const void *data)
+{
+    if (darray_push_back(heap->da, (void *)data) == NULL) return NULL;
+
+    memcpy(heap->hole, data, heap->tp_size);
+    return HEAP_AT(heap, heap_sift_up(heap, darray_size(heap->da) - 1));
+}
+
+
+void *
+heap_push_bulk(heap_t heap, const void *data, size_t amount)
+{
+    const size_t old_size = darray_size(heap->da);
+    if (amount == 0) return darray_data(heap->da);
+
+    /* keep the geometric growth of ::darray_push_back for repeated calls */
+    size_t capacity = darray_capacity(heap->da);
+    if (old_size + amount > capacity)
+    {
+        capacity += capacity >> 1;
+        if (capacity < old_size + amount) capacity = old_size + amount;
+        if (darray_reserve(heap->da, capacity) == NULL) return NULL;
+    }
+
+    darray_resize(heap->da, old_size + amount);
+    memcpy(HEAP_AT(heap, old_size), data, amount * heap->tp_size);
+
+    if (amount >= old_size)
+    {
+        heap_heapify(heap);
+        return darray_data(heap->da);
+    }
+
+    for (size_t i = old_size; i < old_size + amount; i++)
+    {
+        memcpy(heap->hole, HEAP_AT(heap, i), heap->tp_size);
+        heap_sift_up(heap, i);
+    }
+
+    return darray_data(heap->da);
+}
+
+
+void *
+heap_top(heap_t heap)
+{
+    if (darray_size(heap->da) == 0)
+    {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    return darray_data(heap->da);
+}
+
+
+void *
+heap_pop(heap_t heap, void *out)
+{
+    if (darray_size(heap->da) == 0)
+    {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    if (out != NULL) memcpy(out, darray_data(heap->da), heap->tp_size);
+    return heap_erase(heap, 0);
+}
+
+
+void *
+heap_update(heap_t heap, size_t index, const void *data)
+{
+    if (index >= darray_size(heap->da))
+    {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    memcpy(heap->hole, data, heap->tp_size);
+    return HEAP_AT(heap, heap_place(heap, index));
+}
+
+
+void *
+heap_erase(heap_t heap, size_t index)
+{
+    const size_t size = darray_size(heap->da);
+    if (index >= size)
+    {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    /* the last element fills the gap, then finds its place from there */
+    memcpy(heap->hole, HEAP_AT(heap, size - 1), heap->tp_size);
+    darray_pop_back(heap->da);
+
+    if (index < size - 1) heap_place(heap, index);
+    return darray_data(heap->da);
+}
+
+
+size_t
+heap_size(heap_t heap)
+{
+    return darray_size(heap->da);
+}
+
+
+darray_t
+heap_darray(heap_t heap)
+{
+    return heap->da;
+}
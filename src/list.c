@@ -1,37 +1,48 @@
 #include "ds/list.h"
 
 #include <errno.h>
+#include <stdint.h>
 #include <stdlib.h>
 
+#include "ds/__priv/list.h"
+#include "ds/__priv/tcache.h"
+
 #define LIST_TO_HEAD(head) \
     do { while (head->prev != NULL) head = head->prev; } while (0)
 
 #define LIST_TO_TAIL(tail) \
     do { while (tail->next != NULL) tail = tail->next; } while (0)
 
-#define LIST_FREE(list, ptr) \
-    ELSE_IF_NULL(((list_t)list)->free_fn, free, ptr)
-
 #define LIST_MALLOC(list, size) \
     ELSE_IF_NULL(((list_t)list)->malloc_fn, malloc, size)
 
 
-struct linked_list
+/*
+ * Frees a node on its own, or drops its reference on the block it was
+ * compacted into. Nodes without a custom allocator go through the
+ * thread-local cache.
+ */
+static void
+list_release(list_t node)
 {
-    list_t prev;
-    list_t next;
+    struct list_block *block = node->block;
 
-    void *data;
-
-    ds_malloc_fn malloc_fn;
-    ds_free_fn   free_fn;
-};
+    if (block != NULL)
+    {
+        if (--block->refs == 0) ELSE_IF_NULL(block->free_fn, free, block);
+    }
+    else if (node->free_fn == NULL)
+        ds_tcache_free(node, sizeof(struct linked_list));
+    else
+        node->free_fn(node);
+}
 
 
 list_t
 list_new_with_allocator(ds_malloc_fn malloc_fn, ds_free_fn free_fn)
 {
-    list_t list = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct linked_list));
+    list_t list = ELSE_IF_NULL(malloc_fn, ds_tcache_malloc,
+                               sizeof(struct linked_list));
     if (list == NULL) return list;
 
     list->data = NULL;
@@ -40,6 +51,7 @@ list_new_with_allocator(ds_malloc_fn malloc_fn, ds_free_fn free_fn)
 
     list->malloc_fn = malloc_fn;
     list->free_fn   = free_fn;
+    list->block     = NULL;
 
     return list;
 }
@@ -55,12 +67,9 @@ list_new(void)
 void
 list_free_node(list_t list)
 {
-    list_t head = list;
-    LIST_TO_HEAD(head);
-
     /* connect prev with next */
     if (list->prev != NULL) list->prev->next = list->next;
-    LIST_FREE(head, list);
+    list_release(list);
 }
 
 
@@ -72,7 +81,7 @@ list_free(list_t list)
     while (list != NULL)
     {
         list_t next = list->next;
-        LIST_FREE(list, list);
+        list_release(list);
         list = next;
     }
 }
@@ -163,3 +172,186 @@ err:
     errno = ERANGE;
     return NULL;
 }
+
+
+list_t
+list_concat(list_t list, list_t other)
+{
+    LIST_TO_TAIL(list);
+    LIST_TO_HEAD(other);
+
+    list->next  = other;
+    other->prev = list;
+
+    return other;
+}
+
+
+list_t
+list_splice(list_t pos, list_t first, list_t last)
+{
+    /* close the gap left behind */
+    if (first->prev != NULL) first->prev->next = last->next;
+    if (last->next != NULL) last->next->prev = first->prev;
+
+    last->next  = pos->next;
+    first->prev = pos;
+
+    if (pos->next != NULL) pos->next->prev = last;
+    pos->next = first;
+
+    return first;
+}
+
+
+list_t
+list_split_at(list_t list)
+{
+    list_t tail = list->prev;
+    if (tail == NULL) return NULL;
+
+    tail->next = NULL;
+    list->prev = NULL;
+
+    return tail;
+}
+
+
+/* merges two sorted runs linked through `next`, preferring @a on ties */
+static list_t
+list_merge(list_t a, list_t b, list_cmp_fn cmp)
+{
+    struct linked_list head;
+    list_t             tail = &head;
+
+    while (a != NULL && b != NULL)
+    {
+        if (cmp(b->data, a->data) < 0)
+        {
+            tail->next = b;
+            b          = b->next;
+        }
+        else
+        {
+            tail->next = a;
+            a          = a->next;
+        }
+
+        tail = tail->next;
+    }
+
+    tail->next = a != NULL ? a : b;
+    return head.next;
+}
+
+
+list_t
+list_sort(list_t list, list_cmp_fn cmp)
+{
+    /* runs[i] is a sorted run of 2^i nodes, older than the runs below it */
+    list_t runs[64] = { NULL };
+
+    LIST_TO_HEAD(list);
+
+    while (list != NULL)
+    {
+        list_t run = list;
+        list       = list->next;
+        run->next  = NULL;
+
+        size_t i = 0;
+        for (; i < 63 && runs[i] != NULL; i++)
+        {
+            run     = list_merge(runs[i], run, cmp);
+            runs[i] = NULL;
+        }
+
+        runs[i] = run;
+    }
+
+    list_t head = NULL;
+    for (size_t i = 0; i < 64; i++)
+        if (runs[i] != NULL) head = list_merge(runs[i], head, cmp);
+
+    /* only `next` was maintained while merging */
+    list_t prev = NULL;
+    for (list = head; list != NULL; list = list->next)
+    {
+        list->prev = prev;
+        prev       = list;
+    }
+
+    return head;
+}
+
+
+list_t
+list_compact(list_t list)
+{
+    LIST_TO_HEAD(list);
+
+    size_t amount = 0;
+    for (list_t node = list; node != NULL; node = node->next) amount++;
+
+    if (amount > (SIZE_MAX - sizeof(struct list_block))
+                     / sizeof(struct linked_list))
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    struct list_block *block
+        = LIST_MALLOC(list, sizeof(struct list_block)
+                                + (amount * sizeof(struct linked_list)));
+    if (block == NULL) return NULL;
+
+    block->refs    = amount;
+    block->free_fn = list->free_fn;
+
+    list_t nodes = (list_t)(block + 1);
+    size_t i     = 0;
+
+    while (list != NULL)
+    {
+        list_t next = list->next;
+
+        nodes[i]       = *list;
+        nodes[i].prev  = i > 0 ? &nodes[i - 1] : NULL;
+        nodes[i].next  = next != NULL ? &nodes[i + 1] : NULL;
+        nodes[i].block = block;
+
+        list_release(list);
+        list = next;
+        i++;
+    }
+
+    return nodes;
+}
+
+
+int
+list_foreach(list_t list, size_t lookahead, list_iter_fn fn, void *data)
+{
+    /* runs @lookahead nodes in front, so its misses overlap with @fn */
+    list_t ahead = list;
+    for (size_t i = 0; i < lookahead && ahead != NULL; i++)
+    {
+        __builtin_prefetch(ahead->data);
+        ahead = ahead->next;
+    }
+
+    for (; list != NULL; list = list->next)
+    {
+        if (ahead != NULL)
+        {
+            __builtin_prefetch(ahead->next);
+            __builtin_prefetch(ahead->data);
+            ahead = ahead->next;
+        }
+
+        int res = fn(list->data, data);
+        if (res != 0) return res;
+    }
+
+    return 0;
+}
@@ -0,0 +1,384 @@
+#include "ds/lru.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ds/__priv/hash.h"
+
+#define LRU_FREE(lru, ptr) \
+    ELSE_IF_NULL(((lru_t)lru)->free_fn, free, ptr)
+
+#define LRU_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+/* the end of a chain or list */
+#define LRU_NONE UINT32_MAX
+
+#define LRU_ENTRY(lru, index) \
+    ((struct lru_entry *)((lru)->slab + ((size_t)(index) * (lru)->stride)))
+
+#define LRU_KEY(lru, entry)   ((unsigned char *)(entry) + (lru)->key_offset)
+#define LRU_VALUE(lru, entry) ((unsigned char *)(entry) + (lru)->value_offset)
+
+
+/* followed by the key and the value inside the slab */
+struct lru_entry
+{
+    /* the recency list for LRU_EXACT, `next` also links the free entries */
+    uint32_t prev;
+    uint32_t next;
+
+    uint32_t chain;
+    uint32_t tag;
+
+    unsigned char referenced;
+};
+
+
+struct lru_cache
+{
+    unsigned char *slab;
+    size_t         stride;
+    size_t         key_offset;
+    size_t         value_offset;
+
+    uint32_t *buckets;
+    size_t    mask;
+
+    size_t capacity;
+    size_t size;
+    size_t key_size;
+    size_t value_size;
+
+    /* the most and least recently used entries of LRU_EXACT */
+    uint32_t head;
+    uint32_t tail;
+
+    uint32_t free_head;
+    uint32_t hand;
+
+    enum lru_policy policy;
+    lru_evict_fn    evict_fn;
+    void           *evict_data;
+
+    ds_free_fn free_fn;
+};
+
+
+static void
+lru_unlink(lru_t lru, uint32_t index)
+{
+    struct lru_entry *entry = LRU_ENTRY(lru, index);
+
+    if (entry->prev != LRU_NONE)
+        LRU_ENTRY(lru, entry->prev)->next = entry->next;
+    else
+        lru->head = entry->next;
+
+    if (entry->next != LRU_NONE)
+        LRU_ENTRY(lru, entry->next)->prev = entry->prev;
+    else
+        lru->tail = entry->prev;
+}
+
+
+static void
+lru_push_front(lru_t lru, uint32_t index)
+{
+    struct lru_entry *entry = LRU_ENTRY(lru, index);
+
+    entry->prev = LRU_NONE;
+    entry->next = lru->head;
+
+    if (lru->head != LRU_NONE)
+        LRU_ENTRY(lru, lru->head)->prev = index;
+    else
+        lru->tail = index;
+
+    lru->head = index;
+}
+
+
+/*
+ * Finds the entry of @key , and the link pointing to it inside its bucket
+ * chain if @link is not `NULL`.
+ */
+static uint32_t
+lru_find(lru_t lru, const void *key, uint64_t hash, uint32_t **link)
+{
+    uint32_t *at  = &lru->buckets[hash & lru->mask];
+    uint32_t  tag = (uint32_t)(hash >> 32);
+
+    while (*at != LRU_NONE)
+    {
+        struct lru_entry *entry = LRU_ENTRY(lru, *at);
+
+        if (entry->tag == tag
+            && memcmp(LRU_KEY(lru, entry), key, lru->key_size) == 0)
+            break;
+
+        at = &entry->chain;
+    }
+
+    if (link != NULL) *link = at;
+    return *at;
+}
+
+
+/* unlinks an entry from its bucket chain */
+static void
+lru_unchain(lru_t lru, uint32_t index)
+{
+    struct lru_entry *entry = LRU_ENTRY(lru, index);
+    const void       *key   = LRU_KEY(lru, entry);
+    uint32_t         *link;
+
+    lru_find(lru, key, ds_hash_bytes(key, lru->key_size), &link);
+    *link = entry->chain;
+}
+
+
+static uint32_t
+lru_victim(lru_t lru)
+{
+    if (lru->policy == LRU_EXACT) return lru->tail;
+
+    /* at most one sweep clearing flags before an unflagged entry shows up */
+    for (;;)
+    {
+        uint32_t          index = lru->hand;
+        struct lru_entry *entry = LRU_ENTRY(lru, index);
+
+        lru->hand = index + 1 == lru->capacity ? 0 : index + 1;
+
+        if (!__atomic_load_n(&entry->referenced, __ATOMIC_RELAXED))
+            return index;
+
+        __atomic_store_n(&entry->referenced, 0, __ATOMIC_RELAXED);
+    }
+}
+
+
+static void
+lru_touch(lru_t lru, uint32_t index)
+{
+    if (lru->policy == LRU_CLOCK)
+    {
+        struct lru_entry *entry = LRU_ENTRY(lru, index);
+
+        /* skip the store, so hits on hot entries do not bounce the line */
+        if (!__atomic_load_n(&entry->referenced, __ATOMIC_RELAXED))
+            __atomic_store_n(&entry->referenced, 1, __ATOMIC_RELAXED);
+    }
+    else if (lru->head != index)
+    {
+        lru_unlink(lru, index);
+        lru_push_front(lru, index);
+    }
+}
+
+
+lru_t
+lru_new_with_allocator(size_t capacity, size_t key_size, size_t value_size,
+                       enum lru_policy policy, ds_malloc_fn malloc_fn,
+                       ds_free_fn free_fn)
+{
+    if (capacity == 0 || key_size == 0
+        || (policy != LRU_EXACT && policy != LRU_CLOCK))
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    size_t key_offset   = LRU_ALIGN(sizeof(struct lru_entry));
+    size_t value_offset = key_offset + LRU_ALIGN(key_size);
+    size_t stride       = LRU_ALIGN(value_offset + value_size);
+
+    if (capacity >= LRU_NONE || value_offset < key_size
+        || stride < value_size || capacity > SIZE_MAX / stride)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    size_t buckets = 1;
+    while (buckets < capacity) buckets <<= 1;
+
+    lru_t lru = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct lru_cache));
+    if (lru == NULL) return NULL;
+
+    lru->free_fn = free_fn;
+    lru->slab    = ELSE_IF_NULL(malloc_fn, malloc, capacity * stride);
+    lru->buckets = ELSE_IF_NULL(malloc_fn, malloc, buckets * sizeof(uint32_t));
+
+    if (lru->slab == NULL || lru->buckets == NULL)
+    {
+        if (lru->slab != NULL) LRU_FREE(lru, lru->slab);
+        if (lru->buckets != NULL) LRU_FREE(lru, lru->buckets);
+        LRU_FREE(lru, lru);
+        return NULL;
+    }
+
+    lru->stride       = stride;
+    lru->key_offset   = key_offset;
+    lru->value_offset = value_offset;
+    lru->mask         = buckets - 1;
+    lru->capacity     = capacity;
+    lru->key_size     = key_size;
+    lru->value_size   = value_size;
+    lru->policy       = policy;
+    lru->evict_fn     = NULL;
+    lru->evict_data   = NULL;
+
+    lru_clear(lru);
+    return lru;
+}
+
+
+lru_t
+lru_new(size_t capacity, size_t key_size, size_t value_size,
+        enum lru_policy policy)
+{
+    return lru_new_with_allocator(capacity, key_size, value_size, policy, NULL,
+                                  NULL);
+}
+
+
+void
+lru_free(lru_t lru)
+{
+    LRU_FREE(lru, lru->slab);
+    LRU_FREE(lru, lru->buckets);
+    LRU_FREE(lru, lru);
+}
+
+
+void
+lru_set_evict(lru_t lru, lru_evict_fn fn, void *data)
+{
+    lru->evict_fn   = fn;
+    lru->evict_data = data;
+}
+
+
+void *
+lru_get(lru_t lru, const void *key)
+{
+    uint32_t index
+        = lru_find(lru, key, ds_hash_bytes(key, lru->key_size), NULL);
+    if (index == LRU_NONE) return NULL;
+
+    lru_touch(lru, index);
+    return LRU_VALUE(lru, LRU_ENTRY(lru, index));
+}
+
+
+void *
+lru_put(lru_t lru, const void *key, const void *value)
+{
+    uint64_t  hash = ds_hash_bytes(key, lru->key_size);
+    uint32_t *link;
+    uint32_t  index = lru_find(lru, key, hash, &link);
+
+    if (index != LRU_NONE)
+        lru_touch(lru, index);
+    else
+    {
+        if (lru->free_head != LRU_NONE)
+        {
+            index          = lru->free_head;
+            lru->free_head = LRU_ENTRY(lru, index)->next;
+            lru->size++;
+        }
+        else
+        {
+            index                   = lru_victim(lru);
+            struct lru_entry *entry = LRU_ENTRY(lru, index);
+
+            if (lru->evict_fn != NULL)
+                lru->evict_fn(LRU_KEY(lru, entry), LRU_VALUE(lru, entry),
+                              lru->evict_data);
+
+            lru_unchain(lru, index);
+            if (lru->policy == LRU_EXACT) lru_unlink(lru, index);
+
+            /* the victim may have been the chain link found above */
+            lru_find(lru, key, hash, &link);
+        }
+
+        struct lru_entry *entry = LRU_ENTRY(lru, index);
+
+        memcpy(LRU_KEY(lru, entry), key, lru->key_size);
+        entry->tag        = (uint32_t)(hash >> 32);
+        entry->referenced = 0;
+        entry->chain      = LRU_NONE;
+        *link             = index;
+
+        if (lru->policy == LRU_EXACT) lru_push_front(lru, index);
+    }
+
+    void *slot = LRU_VALUE(lru, LRU_ENTRY(lru, index));
+    if (value != NULL)
+        memcpy(slot, value, lru->value_size);
+    else
+        memset(slot, 0, lru->value_size);
+
+    return slot;
+}
+
+
+int
+lru_erase(lru_t lru, const void *key)
+{
+    uint32_t *link;
+    uint32_t  index
+        = lru_find(lru, key, ds_hash_bytes(key, lru->key_size), &link);
+
+    if (index == LRU_NONE)
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
+    struct lru_entry *entry = LRU_ENTRY(lru, index);
+    *link                   = entry->chain;
+
+    if (lru->policy == LRU_EXACT) lru_unlink(lru, index);
+
+    entry->next    = lru->free_head;
+    lru->free_head = index;
+    lru->size--;
+    return 0;
+}
+
+
+void
+lru_clear(lru_t lru)
+{
+    memset(lru->buckets, 0xff, (lru->mask + 1) * sizeof(uint32_t));
+
+    for (size_t i = 0; i < lru->capacity; i++)
+        LRU_ENTRY(lru, i)->next = i + 1 < lru->capacity ? (uint32_t)(i + 1)
+                                                        : LRU_NONE;
+
+    lru->free_head = 0;
+    lru->head      = LRU_NONE;
+    lru->tail      = LRU_NONE;
+    lru->hand      = 0;
+    lru->size      = 0;
+}
+
+
+size_t
+lru_size(lru_t lru)
+{
+    return lru->size;
+}
+
+
+size_t
+lru_capacity(lru_t lru)
+{
+    return lru->capacity;
+}
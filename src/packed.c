@@ -0,0 +1,591 @@
+#include "ds/packed.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ds/__priv/bits.h"
+#include "ds/__priv/cpu.h"
+
+#define PACKED_FREE(pa, ptr) \
+    ELSE_IF_NULL(((packed_t)pa)->free_fn, free, ptr)
+
+#define PACKED_REALLOC(pa, ...) \
+    ELSE_IF_NULL(((packed_t)pa)->realloc_fn, realloc, __VA_ARGS__)
+
+/* the integers of a PACKED_DELTA block, and its control bytes */
+#define PACKED_BLOCK    128
+#define PACKED_CONTROLS (PACKED_BLOCK / 4)
+
+/* the largest encoded block, 8 bytes per difference */
+#define PACKED_BLOCK_MAX (PACKED_CONTROLS + (PACKED_BLOCK * 8))
+
+/* a difference is always read as 8 bytes, past the end of the stream too */
+#define PACKED_PADDING 8
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PACKED_SIMD   1
+#define PACKED_INLINE inline __attribute__((always_inline))
+#endif
+
+
+struct packed_skip
+{
+    uint64_t first;
+    size_t   offset;
+};
+
+
+struct packed_array
+{
+    enum packed_mode mode;
+    size_t           size;
+
+    /* PACKED_BITS, with one word of padding past the last integer */
+    uint64_t *words;
+    size_t    word_alloc;
+    unsigned  width;
+
+    /* PACKED_DELTA, with the integers of the unfinished block in `tail` */
+    unsigned char      *bytes;
+    size_t              byte_size;
+    size_t              byte_alloc;
+    struct packed_skip *skips;
+    size_t              skip_alloc;
+    uint64_t            tail[PACKED_BLOCK];
+
+    ds_realloc_fn realloc_fn;
+    ds_free_fn    free_fn;
+};
+
+
+static const unsigned char packed_lens[4]  = { 1, 2, 4, 8 };
+static const uint64_t      packed_masks[4] = {
+    0xffU, 0xffffU, 0xffffffffU, 0xffffffffffffffffU
+};
+
+
+/* grows @ptr to hold at least @need elements of @size bytes */
+static int
+packed_grow(packed_t pa, void **ptr, size_t *alloc, size_t need, size_t size)
+{
+    if (need <= *alloc) return 0;
+
+    size_t new_alloc = *alloc + (*alloc / 2);
+    if (new_alloc < need) new_alloc = need;
+
+    if (new_alloc > SIZE_MAX / size)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    void *new_ptr = PACKED_REALLOC(pa, *ptr, new_alloc * size);
+    if (new_ptr == NULL) return -1;
+
+    *ptr   = new_ptr;
+    *alloc = new_alloc;
+    return 0;
+}
+
+
+static unsigned
+packed_bit_width(uint64_t value)
+{
+    return value == 0 ? 0 : 64 - ds_clz64(value);
+}
+
+
+static uint64_t
+packed_bit_mask(unsigned width)
+{
+    return width == 64 ? ~(uint64_t)0 : ((uint64_t)1 << width) - 1;
+}
+
+
+static uint64_t
+packed_bits_get(const uint64_t *words, unsigned width, size_t index)
+{
+    size_t   bit   = index * width;
+    unsigned shift = bit & 63;
+
+    /* the padding word makes reading the next word always safe */
+    uint64_t lo = words[bit >> 6];
+    uint64_t hi = words[(bit >> 6) + 1];
+
+    return ((lo >> shift) | ((hi << 1) << (63 - shift)))
+         & packed_bit_mask(width);
+}
+
+
+static void
+packed_bits_put(uint64_t *words, unsigned width, size_t index, uint64_t value)
+{
+    if (width == 0) return;
+
+    size_t   bit   = index * width;
+    unsigned shift = bit & 63;
+    uint64_t mask  = packed_bit_mask(width);
+    size_t   word  = bit >> 6;
+
+    words[word] = (words[word] & ~(mask << shift)) | (value << shift);
+
+    if (shift + width > 64)
+    {
+        unsigned spill  = 64 - shift;
+        words[word + 1] = (words[word + 1] & ~(mask >> spill))
+                        | (value >> spill);
+    }
+}
+
+
+/* makes room for @size integers of @width bits, and repacks to @width */
+static int
+packed_bits_reserve(packed_t pa, size_t size, unsigned width)
+{
+    if (size > (SIZE_MAX - 127) / 64)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    size_t old_words = pa->word_alloc;
+    size_t need      = ((size * width) + 63) / 64 + 1;
+    if (need < 2) need = 2;
+
+    if (packed_grow(pa, (void **)&pa->words, &pa->word_alloc, need,
+                    sizeof(uint64_t))
+        != 0)
+        return -1;
+
+    memset(pa->words + old_words, 0,
+           (pa->word_alloc - old_words) * sizeof(uint64_t));
+
+    if (width <= pa->width) return 0;
+
+    /*
+     * Every integer moves to a higher bit offset, so repacking from the
+     * last one never overwrites an integer that was not moved yet.
+     */
+    for (size_t i = pa->size; i-- > 0;)
+        packed_bits_put(pa->words, width, i,
+                        packed_bits_get(pa->words, pa->width, i));
+
+    pa->width = width;
+    return 0;
+}
+
+
+static uint64_t
+packed_load(const unsigned char *p)
+{
+    /* compiles to a single load on little endian targets */
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16)
+         | ((uint64_t)p[3] << 24) | ((uint64_t)p[4] << 32)
+         | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48)
+         | ((uint64_t)p[7] << 56);
+}
+
+
+/* encodes the full `tail` block and its skip pointer */
+static int
+packed_flush(packed_t pa)
+{
+    size_t block = (pa->size / PACKED_BLOCK) - 1;
+
+    if (packed_grow(pa, (void **)&pa->skips, &pa->skip_alloc, block + 1,
+                    sizeof(struct packed_skip))
+            != 0
+        || packed_grow(pa, (void **)&pa->bytes, &pa->byte_alloc,
+                       pa->byte_size + PACKED_BLOCK_MAX + PACKED_PADDING, 1)
+               != 0)
+        return -1;
+
+    pa->skips[block].first  = pa->tail[0];
+    pa->skips[block].offset = pa->byte_size;
+
+    unsigned char *control = pa->bytes + pa->byte_size;
+    unsigned char *data    = control + PACKED_CONTROLS;
+    memset(control, 0, PACKED_CONTROLS);
+
+    uint64_t prev = pa->tail[0];
+    for (size_t i = 0; i < PACKED_BLOCK; i++)
+    {
+        uint64_t delta = pa->tail[i] - prev;
+        unsigned code  = delta <= 0xffU       ? 0
+                       : delta <= 0xffffU     ? 1
+                       : delta <= 0xffffffffU ? 2
+                                              : 3;
+
+        control[i / 4] |= (unsigned char)(code << ((i % 4) * 2));
+        for (unsigned j = 0; j < packed_lens[code]; j++)
+            *data++ = (unsigned char)(delta >> (j * 8));
+
+        prev = pa->tail[i];
+    }
+
+    pa->byte_size = (size_t)(data - pa->bytes);
+    return 0;
+}
+
+
+/*
+ * Decodes the first @count integers of a block. The four differences of a
+ * control byte are loaded from precomputed offsets, so their loads do not
+ * wait on each other.
+ */
+static void
+packed_block_decode(packed_t pa, size_t block, uint64_t *out, size_t count)
+{
+    const unsigned char *control = pa->bytes + pa->skips[block].offset;
+    const unsigned char *data    = control + PACKED_CONTROLS;
+    uint64_t             acc     = pa->skips[block].first;
+
+    for (size_t i = 0; i < count; i += 4)
+    {
+        unsigned c  = control[i / 4];
+        unsigned c0 = c & 3, c1 = (c >> 2) & 3, c2 = (c >> 4) & 3, c3 = c >> 6;
+
+        size_t o1 = packed_lens[c0];
+        size_t o2 = o1 + packed_lens[c1];
+        size_t o3 = o2 + packed_lens[c2];
+
+        uint64_t d[4] = {
+            packed_load(data) & packed_masks[c0],
+            packed_load(data + o1) & packed_masks[c1],
+            packed_load(data + o2) & packed_masks[c2],
+            packed_load(data + o3) & packed_masks[c3],
+        };
+        data += o3 + packed_lens[c3];
+
+        for (size_t j = 0; j < 4 && i + j < count; j++)
+        {
+            acc        += d[j];
+            out[i + j]  = acc;
+        }
+    }
+}
+
+
+#ifdef PACKED_SIMD
+typedef uint64_t packed_vec __attribute__((vector_size(32)));
+
+
+/*
+ * Unpacks four integers per step as one GNU vector, only worth it where
+ * the target has per-lane 64-bit shifts (AVX2, NEON), as emulating them is
+ * slower than the scalar loop. Returns the amount of integers unpacked.
+ */
+static PACKED_INLINE size_t
+packed_bits_unpack(const uint64_t *words, unsigned width, size_t bit,
+                   uint64_t *out, size_t n)
+{
+    const uint64_t mask = packed_bit_mask(width);
+    size_t         i    = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        packed_vec lo, hi, shift;
+
+        for (size_t k = 0; k < 4; k++, bit += width)
+        {
+            lo[k]    = words[bit >> 6];
+            hi[k]    = words[(bit >> 6) + 1];
+            shift[k] = bit & 63;
+        }
+
+        packed_vec v = ((lo >> shift) | ((hi << 1) << (63 - shift))) & mask;
+        memcpy(out + i, &v, sizeof(v));
+    }
+
+    return i;
+}
+#endif
+
+
+#if defined(DS_CPU_X86) && !defined(__AVX2__)
+static int packed_avx2 = -1;
+
+
+__attribute__((target("avx2"))) static size_t
+packed_bits_unpack_avx2(const uint64_t *words, unsigned width, size_t bit,
+                        uint64_t *out, size_t n)
+{
+    return packed_bits_unpack(words, width, bit, out, n);
+}
+
+
+static int
+packed_use_avx2(void)
+{
+    int avx2 = __atomic_load_n(&packed_avx2, __ATOMIC_RELAXED);
+    if (avx2 < 0)
+    {
+        avx2 = ds_cpu_avx2();
+        __atomic_store_n(&packed_avx2, avx2, __ATOMIC_RELAXED);
+    }
+
+    return avx2;
+}
+#endif
+
+
+static void
+packed_bits_decode(packed_t pa, size_t from, uint64_t *out, size_t n)
+{
+    const uint64_t *words = pa->words;
+    const unsigned  width = pa->width;
+    const uint64_t  mask  = packed_bit_mask(width);
+    size_t          i     = 0;
+
+#if defined(PACKED_SIMD) && (defined(__AVX2__) || defined(__aarch64__))
+    i = packed_bits_unpack(words, width, from * width, out, n);
+#elif defined(DS_CPU_X86)
+    /* baseline x86 builds pick the vector kernel when the CPU has it */
+    if (packed_use_avx2())
+        i = packed_bits_unpack_avx2(words, width, from * width, out, n);
+#endif
+
+    for (size_t bit = (from + i) * width; i < n; i++, bit += width)
+    {
+        unsigned shift = bit & 63;
+        uint64_t lo    = words[bit >> 6];
+        uint64_t hi    = words[(bit >> 6) + 1];
+
+        out[i] = ((lo >> shift) | ((hi << 1) << (63 - shift))) & mask;
+    }
+}
+
+
+packed_t
+packed_new_with_allocator(enum packed_mode mode, ds_malloc_fn malloc_fn,
+                          ds_realloc_fn realloc_fn, ds_free_fn free_fn)
+{
+    if (mode != PACKED_BITS && mode != PACKED_DELTA)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    packed_t pa = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct packed_array));
+    if (pa == NULL) return NULL;
+
+    pa->mode = mode;
+    pa->size = 0;
+
+    pa->words      = NULL;
+    pa->word_alloc = 0;
+    pa->width      = 0;
+
+    pa->bytes      = NULL;
+    pa->byte_size  = 0;
+    pa->byte_alloc = 0;
+    pa->skips      = NULL;
+    pa->skip_alloc = 0;
+
+    pa->realloc_fn = realloc_fn;
+    pa->free_fn    = free_fn;
+    return pa;
+}
+
+
+packed_t
+packed_new(enum packed_mode mode)
+{
+    return packed_new_with_allocator(mode, NULL, NULL, NULL);
+}
+
+
+void
+packed_free(packed_t pa)
+{
+    if (pa->words != NULL) PACKED_FREE(pa, pa->words);
+    if (pa->bytes != NULL) PACKED_FREE(pa, pa->bytes);
+    if (pa->skips != NULL) PACKED_FREE(pa, pa->skips);
+    PACKED_FREE(pa, pa);
+}
+
+
+int
+packed_append(packed_t pa, uint64_t value)
+{
+    if (pa->mode == PACKED_BITS)
+    {
+        unsigned width = packed_bit_width(value);
+        if (width < pa->width) width = pa->width;
+
+        if (packed_bits_reserve(pa, pa->size + 1, width) != 0) return -1;
+
+        packed_bits_put(pa->words, pa->width, pa->size++, value);
+        return 0;
+    }
+
+    if (pa->size > 0 && value < pa->tail[(pa->size - 1) % PACKED_BLOCK])
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    pa->tail[pa->size++ % PACKED_BLOCK] = value;
+    if (pa->size % PACKED_BLOCK != 0) return 0;
+
+    if (packed_flush(pa) != 0)
+    {
+        pa->size--;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+int
+packed_append_many(packed_t pa, const uint64_t *values, size_t n)
+{
+    if (pa->mode == PACKED_BITS && n > 0)
+    {
+        /* repack once for the widest integer instead of on every append */
+        uint64_t all = 0;
+        for (size_t i = 0; i < n; i++) all |= values[i];
+
+        unsigned width = packed_bit_width(all);
+        if (width < pa->width) width = pa->width;
+
+        if (n > SIZE_MAX - pa->size)
+        {
+            errno = ENOMEM;
+            return -1;
+        }
+
+        if (packed_bits_reserve(pa, pa->size + n, width) != 0) return -1;
+    }
+
+    for (size_t i = 0; i < n; i++)
+        if (packed_append(pa, values[i]) != 0) return -1;
+
+    return 0;
+}
+
+
+int
+packed_get(packed_t pa, size_t index, uint64_t *value)
+{
+    if (index >= pa->size)
+    {
+        errno = ERANGE;
+        return -1;
+    }
+
+    if (pa->mode == PACKED_BITS)
+    {
+        *value = packed_bits_get(pa->words, pa->width, index);
+        return 0;
+    }
+
+    size_t block = index / PACKED_BLOCK;
+    if (block == pa->size / PACKED_BLOCK)
+    {
+        *value = pa->tail[index % PACKED_BLOCK];
+        return 0;
+    }
+
+    uint64_t buf[PACKED_BLOCK];
+    packed_block_decode(pa, block, buf, (index % PACKED_BLOCK) + 1);
+
+    *value = buf[index % PACKED_BLOCK];
+    return 0;
+}
+
+
+int
+packed_set(packed_t pa, size_t index, uint64_t value)
+{
+    if (index >= pa->size)
+    {
+        errno = ERANGE;
+        return -1;
+    }
+
+    if (pa->mode != PACKED_BITS)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    unsigned width = packed_bit_width(value);
+    if (width > pa->width && packed_bits_reserve(pa, pa->size, width) != 0)
+        return -1;
+
+    packed_bits_put(pa->words, pa->width, index, value);
+    return 0;
+}
+
+
+size_t
+packed_decode(packed_t pa, size_t from, uint64_t *out, size_t n)
+{
+    if (from >= pa->size) return 0;
+    if (n > pa->size - from) n = pa->size - from;
+
+    if (pa->mode == PACKED_BITS)
+    {
+        if (pa->width == 0)
+            memset(out, 0, n * sizeof(uint64_t));
+        else
+            packed_bits_decode(pa, from, out, n);
+
+        return n;
+    }
+
+    const size_t full = pa->size / PACKED_BLOCK;
+    size_t       done = 0;
+
+    while (done < n)
+    {
+        size_t block  = (from + done) / PACKED_BLOCK;
+        size_t offset = (from + done) % PACKED_BLOCK;
+        size_t take   = PACKED_BLOCK - offset;
+        if (take > n - done) take = n - done;
+
+        if (block == full)
+            memcpy(out + done, pa->tail + offset, take * sizeof(uint64_t));
+        else if (offset == 0 && take == PACKED_BLOCK)
+            packed_block_decode(pa, block, out + done, PACKED_BLOCK);
+        else
+        {
+            uint64_t buf[PACKED_BLOCK];
+            packed_block_decode(pa, block, buf, offset + take);
+            memcpy(out + done, buf + offset, take * sizeof(uint64_t));
+        }
+
+        done += take;
+    }
+
+    return n;
+}
+
+
+size_t
+packed_size(packed_t pa)
+{
+    return pa->size;
+}
+
+
+size_t
+packed_bytes(packed_t pa)
+{
+    if (pa->mode == PACKED_BITS)
+        return (((pa->size * pa->width) + 63) / 64) * sizeof(uint64_t);
+
+    return pa->byte_size
+         + ((pa->size / PACKED_BLOCK) * sizeof(struct packed_skip))
+         + ((pa->size % PACKED_BLOCK) * sizeof(uint64_t));
+}
+
+
+unsigned
+packed_width(packed_t pa)
+{
+    return pa->mode == PACKED_BITS ? pa->width : 0;
+}
@@ -0,0 +1,317 @@
+#define _DEFAULT_SOURCE 1
+#include "ds/prof.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef DS_HAVE_PERF_EVENT
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <linux/perf_event.h>
+#endif
+
+#include "ds/darray.h"
+
+#define PROF_FREE(prof, ptr) \
+    ELSE_IF_NULL(((prof_t)prof)->free_fn, free, ptr)
+
+
+struct prof_entry
+{
+    const char        *name;
+    size_t             calls;
+    struct prof_sample total;
+};
+
+
+struct profiler
+{
+    /* the file descriptor of every counter, -1 if it is unavailable */
+    int fds[PROF_COUNTER_AMOUNT];
+    int leader;
+
+    /* maps a position inside a group read to its counter */
+    enum prof_counter order[PROF_COUNTER_AMOUNT];
+    size_t            opened;
+
+    /* the group's times at the last read, the kernel never resets them */
+    uint64_t time_enabled;
+    uint64_t time_running;
+
+    struct timespec start;
+    darray_t        entries;
+
+    ds_free_fn free_fn;
+};
+
+
+#ifdef DS_HAVE_PERF_EVENT
+#define PROF_CACHE_MISS(cache)                    \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) \
+     | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+
+static const struct
+{
+    uint32_t type;
+    uint64_t config;
+} prof_events[PROF_COUNTER_AMOUNT] = {
+    [PROF_CYCLES]        = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    [PROF_INSTRUCTIONS]  = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    [PROF_L1D_MISSES]    = { PERF_TYPE_HW_CACHE,
+                             PROF_CACHE_MISS(PERF_COUNT_HW_CACHE_L1D) },
+    [PROF_LLC_MISSES]    = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    [PROF_BRANCH_MISSES] = { PERF_TYPE_HARDWARE,
+                             PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+
+static void
+prof_open(prof_t prof)
+{
+    for (int i = 0; i < PROF_COUNTER_AMOUNT; i++)
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+
+        attr.size           = sizeof(attr);
+        attr.type           = prof_events[i].type;
+        attr.config         = prof_events[i].config;
+        attr.disabled       = prof->leader == -1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_GROUP
+                         | PERF_FORMAT_TOTAL_TIME_ENABLED
+                         | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        /* counters share one group so a single read gets all of them */
+        long fd = syscall(SYS_perf_event_open, &attr, 0, -1, prof->leader, 0);
+        if (fd < 0) continue;
+
+        prof->fds[i]                = (int)fd;
+        prof->order[prof->opened++] = (enum prof_counter)i;
+        if (prof->leader == -1) prof->leader = (int)fd;
+    }
+}
+#endif
+
+
+static uint64_t
+prof_elapsed_ns(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)(now.tv_sec - start->tv_sec) * 1000000000U)
+         + (uint64_t)now.tv_nsec - (uint64_t)start->tv_nsec;
+}
+
+
+static struct prof_entry *
+prof_entry(prof_t prof, const char *name, int create)
+{
+    struct prof_entry *entries = darray_data(prof->entries);
+
+    for (size_t i = 0; i < darray_size(prof->entries); i++)
+        if (entries[i].name == name || strcmp(entries[i].name, name) == 0)
+            return &entries[i];
+
+    if (!create) return NULL;
+
+    struct prof_entry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.name = name;
+
+    return darray_push_back(prof->entries, &entry);
+}
+
+
+prof_t
+prof_new_with_allocator(ds_malloc_fn malloc_fn, ds_realloc_fn realloc_fn,
+                        ds_free_fn free_fn)
+{
+    prof_t prof = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct profiler));
+    if (prof == NULL) return NULL;
+
+    prof->free_fn = free_fn;
+    prof->leader  = -1;
+    prof->opened  = 0;
+
+    prof->time_enabled = 0;
+    prof->time_running = 0;
+    for (int i = 0; i < PROF_COUNTER_AMOUNT; i++) prof->fds[i] = -1;
+
+    prof->entries = darray_new_with_allocator(
+        sizeof(struct prof_entry), malloc_fn, realloc_fn, free_fn);
+    if (prof->entries == NULL)
+    {
+        PROF_FREE(prof, prof);
+        return NULL;
+    }
+
+#ifdef DS_HAVE_PERF_EVENT
+    prof_open(prof);
+#endif
+
+    clock_gettime(CLOCK_MONOTONIC, &prof->start);
+    return prof;
+}
+
+
+prof_t
+prof_new(void)
+{
+    return prof_new_with_allocator(NULL, NULL, NULL);
+}
+
+
+void
+prof_free(prof_t prof)
+{
+#ifdef DS_HAVE_PERF_EVENT
+    for (int i = 0; i < PROF_COUNTER_AMOUNT; i++)
+        if (prof->fds[i] != -1) close(prof->fds[i]);
+#endif
+
+    darray_free_full(prof->entries);
+    PROF_FREE(prof, prof);
+}
+
+
+int
+prof_available(prof_t prof, enum prof_counter counter)
+{
+    return counter < PROF_COUNTER_AMOUNT && prof->fds[counter] != -1;
+}
+
+
+void
+prof_begin(prof_t prof)
+{
+#ifdef DS_HAVE_PERF_EVENT
+    if (prof->leader != -1)
+    {
+        ioctl(prof->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(prof->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+
+    clock_gettime(CLOCK_MONOTONIC, &prof->start);
+}
+
+
+int
+prof_end(prof_t prof, const char *name, struct prof_sample *out)
+{
+    struct prof_sample sample;
+    memset(&sample, 0, sizeof(sample));
+
+    sample.wall_ns = prof_elapsed_ns(&prof->start);
+
+#ifdef DS_HAVE_PERF_EVENT
+    if (prof->leader != -1)
+    {
+        /* the amount of counters, both times, then every counter */
+        uint64_t      buf[PROF_COUNTER_AMOUNT + 3];
+        const ssize_t size = (ssize_t)((prof->opened + 3) * sizeof(*buf));
+
+        ioctl(prof->leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        if (read(prof->leader, buf, sizeof(buf)) == size
+            && buf[0] == prof->opened)
+        {
+            const uint64_t enabled = buf[1] - prof->time_enabled;
+            const uint64_t running = buf[2] - prof->time_running;
+
+            prof->time_enabled = buf[1];
+            prof->time_running = buf[2];
+
+            /*
+             * A multiplexed group only counted part of the region, so its
+             * counts are extrapolated. One that was never scheduled has
+             * nothing to extrapolate from.
+             */
+            if (running != 0)
+            {
+                sample.counted = 1;
+
+                for (size_t i = 0; i < prof->opened; i++)
+                {
+                    uint64_t value = buf[i + 3];
+                    if (running < enabled)
+                        value = (uint64_t)((double)value * (double)enabled
+                                           / (double)running);
+
+                    sample.values[prof->order[i]] = value;
+                }
+            }
+        }
+    }
+#endif
+
+    if (out != NULL) *out = sample;
+    if (name == NULL) return 0;
+
+    struct prof_entry *entry = prof_entry(prof, name, 1);
+    if (entry == NULL) return -1;
+
+    entry->calls++;
+    entry->total.wall_ns += sample.wall_ns;
+    entry->total.counted += sample.counted;
+    for (int i = 0; i < PROF_COUNTER_AMOUNT; i++)
+        entry->total.values[i] += sample.values[i];
+
+    return 0;
+}
+
+
+size_t
+prof_stats(prof_t prof, const char *name, struct prof_sample *out)
+{
+    struct prof_entry *entry = prof_entry(prof, name, 0);
+
+    if (entry == NULL)
+    {
+        memset(out, 0, sizeof(*out));
+        return 0;
+    }
+
+    *out = entry->total;
+    return entry->calls;
+}
+
+
+void
+prof_report(prof_t prof, FILE *stream)
+{
+    static const char *headers[PROF_COUNTER_AMOUNT]
+        = { "cycles", "instrs", "l1d-miss", "llc-miss", "br-miss" };
+
+    fprintf(stream, "%-24s %10s %12s", "region", "calls", "ns/call");
+    for (int i = 0; i < PROF_COUNTER_AMOUNT; i++)
+        fprintf(stream, " %12s", headers[i]);
+    fputc('\n', stream);
+
+    struct prof_entry *entries = darray_data(prof->entries);
+    for (size_t i = 0; i < darray_size(prof->entries); i++)
+    {
+        const struct prof_entry *entry = &entries[i];
+        const double             calls   = (double)entry->calls;
+        const double             counted = (double)entry->total.counted;
+
+        fprintf(stream, "%-24s %10zu %12.1f", entry->name, entry->calls,
+                (double)entry->total.wall_ns / calls);
+
+        for (int j = 0; j < PROF_COUNTER_AMOUNT; j++)
+            if (prof->fds[j] == -1 || entry->total.counted == 0)
+                fprintf(stream, " %12s", "-");
+            else
+                fprintf(stream, " %12.1f",
+                        (double)entry->total.values[j] / counted);
+
+        fputc('\n', stream);
+    }
+}
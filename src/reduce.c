@@ -0,0 +1,195 @@
+#define _POSIX_C_SOURCE 200809L
+#include "ds/reduce.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ds/__priv/cpu.h"
+#include "ds/__priv/parallel.h"
+
+/* the smallest chunk of an array worth a thread of its own */
+#define REDUCE_CHUNK_MIN   ((size_t)1 << 20)
+#define REDUCE_MAX_THREADS DS_PARALLEL_MAX
+
+/* floats are summed a block at a time, and the block sums added pairwise */
+#define REDUCE_BLOCK 256
+
+/* the most elements a kernel finds extremes of, so block indices fit */
+#define REDUCE_SEGMENT ((size_t)1 << 30)
+
+#if defined(__GNUC__) || defined(__clang__)
+#define REDUCE_SIMD     1
+#define REDUCE_VEC_SIZE 32
+#define REDUCE_INLINE   inline __attribute__((always_inline))
+#else
+#define REDUCE_INLINE inline
+#endif
+
+
+enum reduce_op
+{
+    REDUCE_OP_SUM,
+    REDUCE_OP_KAHAN,
+    REDUCE_OP_MIN,
+    REDUCE_OP_MAX,
+    REDUCE_OP_MINMAX,
+    REDUCE_OP_ARGMIN,
+    REDUCE_OP_ARGMAX,
+};
+
+
+/*
+ * Reduces the @n elements at @data into @part , the partial result of the
+ * element type. @base is the index of the first element inside the array.
+ */
+typedef void (*reduce_kernel_fn)(const void *data, size_t base, size_t n,
+                                 enum reduce_op op, void *part);
+
+
+struct reduce_job
+{
+    reduce_kernel_fn kernel;
+    enum reduce_op   op;
+
+    const void *data;
+    size_t      base;
+    size_t      amount;
+    void       *part;
+};
+
+
+static size_t reduce_thread_amount = 1;
+
+
+#ifdef DS_CPU_X86
+static int reduce_avx2 = -1;
+
+
+static int
+reduce_use_avx2(void)
+{
+    int avx2 = __atomic_load_n(&reduce_avx2, __ATOMIC_RELAXED);
+    if (avx2 < 0)
+    {
+        avx2 = ds_cpu_avx2();
+        __atomic_store_n(&reduce_avx2, avx2, __ATOMIC_RELAXED);
+    }
+
+    return avx2;
+}
+#endif
+
+
+static void *
+reduce_job_run(void *arg)
+{
+    struct reduce_job *job = arg;
+
+    job->kernel(job->data, job->base, job->amount, job->op, job->part);
+    return NULL;
+}
+
+
+/*
+ * Runs @kernel over the elements of @da , split into as many chunks as the
+ * thread setting and the chunk size allow, the first one on the calling
+ * thread. Returns the amount of partial results written to @parts .
+ */
+static size_t
+reduce_run(darray_t da, reduce_kernel_fn kernel, enum reduce_op op,
+           unsigned char *parts, size_t part_size)
+{
+    const unsigned char *data  = darray_data(da);
+    const size_t         n     = darray_size(da);
+    const size_t         width = darray_type_size(da);
+
+    size_t chunks  = (n * width) / REDUCE_CHUNK_MIN;
+    size_t threads = __atomic_load_n(&reduce_thread_amount, __ATOMIC_RELAXED);
+    if (chunks > threads) chunks = threads;
+    if (chunks == 0) chunks = 1;
+
+    struct reduce_job jobs[REDUCE_MAX_THREADS];
+
+    for (size_t c = 0; c < chunks; c++)
+    {
+        size_t from = (c * (n / chunks)) + (c < n % chunks ? c : n % chunks);
+        size_t len  = (n / chunks) + (c < n % chunks ? 1 : 0);
+
+        jobs[c].kernel = kernel;
+        jobs[c].op     = op;
+        jobs[c].data   = data + (from * width);
+        jobs[c].base   = from;
+        jobs[c].amount = len;
+        jobs[c].part   = parts + (c * part_size);
+    }
+
+    ds_parallel_run(reduce_job_run, jobs, sizeof(struct reduce_job), chunks);
+    return chunks;
+}
+
+
+void
+darray_reduce_set_threads(size_t threads)
+{
+    if (threads == 0) threads = 1;
+    if (threads > REDUCE_MAX_THREADS) threads = REDUCE_MAX_THREADS;
+
+    __atomic_store_n(&reduce_thread_amount, threads, __ATOMIC_RELAXED);
+}
+
+
+size_t
+darray_reduce_threads(void)
+{
+    return __atomic_load_n(&reduce_thread_amount, __ATOMIC_RELAXED);
+}
+
+
+#define REDUCE_S     i32
+#define REDUCE_T     int32_t
+#define REDUCE_MASK  int32_t
+#define REDUCE_SUM   uint64_t
+#define REDUCE_ACC   int64_t
+#define REDUCE_FLOAT 0
+#include "reduce_type.h"
+
+#define REDUCE_S     i64
+#define REDUCE_T     int64_t
+#define REDUCE_MASK  int64_t
+#define REDUCE_SUM   uint64_t
+#define REDUCE_ACC   int64_t
+#define REDUCE_FLOAT 0
+#include "reduce_type.h"
+
+#define REDUCE_S     u32
+#define REDUCE_T     uint32_t
+#define REDUCE_MASK  int32_t
+#define REDUCE_SUM   uint64_t
+#define REDUCE_ACC   uint64_t
+#define REDUCE_FLOAT 0
+#include "reduce_type.h"
+
+#define REDUCE_S     u64
+#define REDUCE_T     uint64_t
+#define REDUCE_MASK  int64_t
+#define REDUCE_SUM   uint64_t
+#define REDUCE_ACC   uint64_t
+#define REDUCE_FLOAT 0
+#include "reduce_type.h"
+
+#define REDUCE_S     f32
+#define REDUCE_T     float
+#define REDUCE_MASK  int32_t
+#define REDUCE_SUM   float
+#define REDUCE_ACC   float
+#define REDUCE_FLOAT 1
+#include "reduce_type.h"
+
+#define REDUCE_S     f64
+#define REDUCE_T     double
+#define REDUCE_MASK  int64_t
+#define REDUCE_SUM   double
+#define REDUCE_ACC   double
+#define REDUCE_FLOAT 1
+#include "reduce_type.h"
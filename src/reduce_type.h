@@ -0,0 +1,519 @@
+/*
+ * The reductions of one element type, included by reduce.c once per type
+ * with these defined:
+ *
+ *   REDUCE_S      the suffix of the function names
+ *   REDUCE_T      the element type
+ *   REDUCE_MASK   the signed integer type as wide as REDUCE_T
+ *   REDUCE_SUM    the type the elements are summed in
+ *   REDUCE_ACC    the type the sum is returned in
+ *   REDUCE_FLOAT  1 if REDUCE_T is a floating type
+ */
+
+#define REDUCE_PASTE_(a, b) a##b
+#define REDUCE_PASTE(a, b)  REDUCE_PASTE_(a, b)
+#define REDUCE_FN(name)     REDUCE_PASTE(name, REDUCE_S)
+
+#define REDUCE_PART struct REDUCE_FN(reduce_part_)
+
+
+REDUCE_PART
+{
+    /* the sum, and the Kahan compensation to subtract from it */
+    REDUCE_SUM sum;
+    REDUCE_SUM comp;
+
+    REDUCE_T min;
+    REDUCE_T max;
+    size_t   imin;
+    size_t   imax;
+};
+
+
+static REDUCE_INLINE void
+REDUCE_FN(reduce_kahan_add_)(REDUCE_SUM *sum, REDUCE_SUM *comp, REDUCE_SUM x)
+{
+    REDUCE_SUM y = x - *comp;
+    REDUCE_SUM t = *sum + y;
+
+    *comp = (t - *sum) - y;
+    *sum  = t;
+}
+
+
+/* keeps the extremes of @b that beat @a , @a wins ties as the earlier one */
+static REDUCE_INLINE void
+REDUCE_FN(reduce_merge_)(REDUCE_PART *a, const REDUCE_PART *b)
+{
+    if (b->min < a->min)
+    {
+        a->min  = b->min;
+        a->imin = b->imin;
+    }
+
+    if (b->max > a->max)
+    {
+        a->max  = b->max;
+        a->imax = b->imax;
+    }
+}
+
+
+#ifdef REDUCE_SIMD
+#define REDUCE_LANES     (REDUCE_VEC_SIZE / sizeof(REDUCE_T))
+#define REDUCE_SUM_LANES (REDUCE_VEC_SIZE / sizeof(REDUCE_SUM))
+
+#define REDUCE_VEC     REDUCE_FN(reduce_vec_)
+#define REDUCE_MASKVEC REDUCE_FN(reduce_mask_)
+#define REDUCE_SUMVEC  REDUCE_FN(reduce_sumvec_)
+#define REDUCE_LOADVEC REDUCE_FN(reduce_loadvec_)
+
+typedef REDUCE_T    REDUCE_VEC __attribute__((vector_size(REDUCE_VEC_SIZE)));
+typedef REDUCE_MASK REDUCE_MASKVEC
+    __attribute__((vector_size(REDUCE_VEC_SIZE)));
+typedef REDUCE_SUM REDUCE_SUMVEC __attribute__((vector_size(REDUCE_VEC_SIZE)));
+
+/* as many elements as REDUCE_SUMVEC has lanes, widened when loaded */
+typedef REDUCE_T REDUCE_LOADVEC
+    __attribute__((vector_size(REDUCE_SUM_LANES * sizeof(REDUCE_T))));
+
+#define REDUCE_BLEND(m, a, b)                                              \
+    ((REDUCE_VEC)(((REDUCE_MASKVEC)(a) & (m))                              \
+                  | ((REDUCE_MASKVEC)(b) & ~(m))))
+
+
+static REDUCE_INLINE void
+REDUCE_FN(reduce_load_)(REDUCE_SUMVEC *out, const REDUCE_T *data)
+{
+    REDUCE_LOADVEC vec;
+    memcpy(&vec, data, sizeof(vec));
+    *out = __builtin_convertvector(vec, REDUCE_SUMVEC);
+}
+#endif
+
+
+/* sums @n elements with four vector accumulators */
+static REDUCE_INLINE REDUCE_SUM
+REDUCE_FN(reduce_sum_run_)(const REDUCE_T *data, size_t n)
+{
+    REDUCE_SUM sum = 0;
+    size_t     i   = 0;
+
+#ifdef REDUCE_SIMD
+    REDUCE_SUMVEC acc0 = { 0 }, acc1 = { 0 }, acc2 = { 0 }, acc3 = { 0 };
+    REDUCE_SUMVEC vec;
+
+    for (; i + (4 * REDUCE_SUM_LANES) <= n; i += 4 * REDUCE_SUM_LANES)
+    {
+        REDUCE_FN(reduce_load_)(&vec, data + i);
+        acc0 += vec;
+        REDUCE_FN(reduce_load_)(&vec, data + i + REDUCE_SUM_LANES);
+        acc1 += vec;
+        REDUCE_FN(reduce_load_)(&vec, data + i + (2 * REDUCE_SUM_LANES));
+        acc2 += vec;
+        REDUCE_FN(reduce_load_)(&vec, data + i + (3 * REDUCE_SUM_LANES));
+        acc3 += vec;
+    }
+
+    for (; i + REDUCE_SUM_LANES <= n; i += REDUCE_SUM_LANES)
+    {
+        REDUCE_FN(reduce_load_)(&vec, data + i);
+        acc0 += vec;
+    }
+
+    acc0 = (acc0 + acc1) + (acc2 + acc3);
+    for (size_t k = 0; k < REDUCE_SUM_LANES; k++) sum += acc0[k];
+#endif
+
+    for (; i < n; i++) sum += (REDUCE_SUM)data[i];
+    return sum;
+}
+
+
+static REDUCE_INLINE void
+REDUCE_FN(reduce_sum_)(const REDUCE_T *data, size_t n, REDUCE_PART *part)
+{
+    if (!REDUCE_FLOAT)
+    {
+        part->sum = REDUCE_FN(reduce_sum_run_)(data, n);
+        return;
+    }
+
+    /* levels[i] holds the sum of 2^i blocks while bit i of `used` is set */
+    REDUCE_SUM levels[64];
+    uint64_t   used = 0;
+
+    for (size_t i = 0; i < n; i += REDUCE_BLOCK)
+    {
+        size_t     len = n - i < REDUCE_BLOCK ? n - i : REDUCE_BLOCK;
+        REDUCE_SUM sum = REDUCE_FN(reduce_sum_run_)(data + i, len);
+
+        unsigned level = 0;
+        for (; used & ((uint64_t)1 << level); level++)
+        {
+            sum   = levels[level] + sum;
+            used &= ~((uint64_t)1 << level);
+        }
+
+        levels[level]  = sum;
+        used          |= (uint64_t)1 << level;
+    }
+
+    part->sum = 0;
+    for (unsigned level = 0; level < 64; level++)
+        if (used & ((uint64_t)1 << level)) part->sum += levels[level];
+}
+
+
+static REDUCE_INLINE void
+REDUCE_FN(reduce_kahan_)(const REDUCE_T *data, size_t n, REDUCE_PART *part)
+{
+    REDUCE_SUM sum  = 0;
+    REDUCE_SUM comp = 0;
+    size_t     i    = 0;
+
+#ifdef REDUCE_SIMD
+    /* two independent sets of lanes, to hide the latency of the adds */
+    REDUCE_SUMVEC s0 = { 0 }, c0 = { 0 }, s1 = { 0 }, c1 = { 0 };
+    REDUCE_SUMVEC x, y, t;
+
+    for (; i + (2 * REDUCE_SUM_LANES) <= n; i += 2 * REDUCE_SUM_LANES)
+    {
+        REDUCE_FN(reduce_load_)(&x, data + i);
+        y  = x - c0;
+        t  = s0 + y;
+        c0 = (t - s0) - y;
+        s0 = t;
+
+        REDUCE_FN(reduce_load_)(&x, data + i + REDUCE_SUM_LANES);
+        y  = x - c1;
+        t  = s1 + y;
+        c1 = (t - s1) - y;
+        s1 = t;
+    }
+
+    for (size_t k = 0; k < REDUCE_SUM_LANES; k++)
+    {
+        REDUCE_FN(reduce_kahan_add_)(&sum, &comp, s0[k]);
+        REDUCE_FN(reduce_kahan_add_)(&sum, &comp, s1[k]);
+        REDUCE_FN(reduce_kahan_add_)(&sum, &comp, -c0[k]);
+        REDUCE_FN(reduce_kahan_add_)(&sum, &comp, -c1[k]);
+    }
+#endif
+
+    for (; i < n; i++)
+        REDUCE_FN(reduce_kahan_add_)(&sum, &comp, (REDUCE_SUM)data[i]);
+
+    part->sum  = sum;
+    part->comp = comp;
+}
+
+
+/*
+ * Finds the extremes of @n elements, at least one. Every vector lane keeps
+ * its own extreme and the block it came from, and the lanes are merged at
+ * the end, the lowest index winning ties.
+ */
+static REDUCE_INLINE void
+REDUCE_FN(reduce_extremes_)(const REDUCE_T *data, size_t n, int want_min,
+                            int want_max, int want_index, REDUCE_PART *part)
+{
+    REDUCE_T min  = data[0];
+    REDUCE_T max  = data[0];
+    size_t   imin = 0;
+    size_t   imax = 0;
+    size_t   i    = 1;
+
+#ifdef REDUCE_SIMD
+    if (n >= 2 * REDUCE_LANES)
+    {
+        REDUCE_VEC     lo, hi, x;
+        REDUCE_MASKVEC ilo = { 0 }, ihi = { 0 }, block = { 0 }, m;
+
+        memcpy(&lo, data, sizeof(lo));
+        hi = lo;
+
+        const size_t blocks = n / REDUCE_LANES;
+        for (size_t b = 1; b < blocks; b++)
+        {
+            memcpy(&x, data + (b * REDUCE_LANES), sizeof(x));
+            block += 1;
+
+            if (want_min)
+            {
+                m  = (REDUCE_MASKVEC)(x < lo);
+                lo = REDUCE_BLEND(m, x, lo);
+                if (want_index) ilo = (block & m) | (ilo & ~m);
+            }
+
+            if (want_max)
+            {
+                m  = (REDUCE_MASKVEC)(x > hi);
+                hi = REDUCE_BLEND(m, x, hi);
+                if (want_index) ihi = (block & m) | (ihi & ~m);
+            }
+        }
+
+        min  = lo[0];
+        max  = hi[0];
+        imin = (size_t)ilo[0] * REDUCE_LANES;
+        imax = (size_t)ihi[0] * REDUCE_LANES;
+        for (size_t k = 1; k < REDUCE_LANES; k++)
+        {
+            size_t at_lo = ((size_t)ilo[k] * REDUCE_LANES) + k;
+            size_t at_hi = ((size_t)ihi[k] * REDUCE_LANES) + k;
+
+            if (lo[k] < min || (lo[k] == min && at_lo < imin))
+            {
+                min  = lo[k];
+                imin = at_lo;
+            }
+
+            if (hi[k] > max || (hi[k] == max && at_hi < imax))
+            {
+                max  = hi[k];
+                imax = at_hi;
+            }
+        }
+
+        i = blocks * REDUCE_LANES;
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        if (data[i] < min)
+        {
+            min  = data[i];
+            imin = i;
+        }
+
+        if (data[i] > max)
+        {
+            max  = data[i];
+            imax = i;
+        }
+    }
+
+    part->min  = min;
+    part->max  = max;
+    part->imin = imin;
+    part->imax = imax;
+}
+
+
+static REDUCE_INLINE void
+REDUCE_FN(reduce_body_)(const void *data, size_t base, size_t n,
+                        enum reduce_op op, void *ptr)
+{
+    const REDUCE_T *elems = data;
+    REDUCE_PART    *part  = ptr;
+
+    if (op == REDUCE_OP_SUM)
+    {
+        REDUCE_FN(reduce_sum_)(elems, n, part);
+        return;
+    }
+
+    if (op == REDUCE_OP_KAHAN)
+    {
+        REDUCE_FN(reduce_kahan_)(elems, n, part);
+        return;
+    }
+
+    for (size_t from = 0; from < n; from += REDUCE_SEGMENT)
+    {
+        REDUCE_PART seg;
+        size_t      len = n - from < REDUCE_SEGMENT ? n - from : REDUCE_SEGMENT;
+
+        /* constant flags, so every operation gets its own loop */
+        switch (op)
+        {
+        case REDUCE_OP_MIN:
+            REDUCE_FN(reduce_extremes_)(elems + from, len, 1, 0, 0, &seg);
+            break;
+        case REDUCE_OP_MAX:
+            REDUCE_FN(reduce_extremes_)(elems + from, len, 0, 1, 0, &seg);
+            break;
+        case REDUCE_OP_ARGMIN:
+            REDUCE_FN(reduce_extremes_)(elems + from, len, 1, 0, 1, &seg);
+            break;
+        case REDUCE_OP_ARGMAX:
+            REDUCE_FN(reduce_extremes_)(elems + from, len, 0, 1, 1, &seg);
+            break;
+        default:
+            REDUCE_FN(reduce_extremes_)(elems + from, len, 1, 1, 0, &seg);
+            break;
+        }
+
+        seg.imin += base + from;
+        seg.imax += base + from;
+
+        if (from == 0)
+            *part = seg;
+        else
+            REDUCE_FN(reduce_merge_)(part, &seg);
+    }
+}
+
+
+static void
+REDUCE_FN(reduce_kernel_)(const void *data, size_t base, size_t n,
+                          enum reduce_op op, void *part)
+{
+    REDUCE_FN(reduce_body_)(data, base, n, op, part);
+}
+
+
+#ifdef DS_CPU_X86
+__attribute__((target("avx2"))) static void
+REDUCE_FN(reduce_kernel_avx2_)(const void *data, size_t base, size_t n,
+                               enum reduce_op op, void *part)
+{
+    REDUCE_FN(reduce_body_)(data, base, n, op, part);
+}
+#endif
+
+
+static int
+REDUCE_FN(reduce_)(darray_t da, enum reduce_op op, REDUCE_PART *out)
+{
+    if (darray_type_size(da) != sizeof(REDUCE_T))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (op != REDUCE_OP_SUM && op != REDUCE_OP_KAHAN && darray_size(da) == 0)
+    {
+        errno = ERANGE;
+        return -1;
+    }
+
+    reduce_kernel_fn kernel = REDUCE_FN(reduce_kernel_);
+#ifdef DS_CPU_X86
+    if (reduce_use_avx2()) kernel = REDUCE_FN(reduce_kernel_avx2_);
+#endif
+
+    REDUCE_PART parts[REDUCE_MAX_THREADS];
+    size_t      chunks = reduce_run(da, kernel, op, (unsigned char *)parts,
+                                    sizeof(*parts));
+
+    *out = parts[0];
+    for (size_t c = 1; c < chunks; c++)
+        if (op == REDUCE_OP_SUM)
+            out->sum += parts[c].sum;
+        else if (op == REDUCE_OP_KAHAN)
+        {
+            REDUCE_FN(reduce_kahan_add_)(&out->sum, &out->comp, parts[c].sum);
+            REDUCE_FN(reduce_kahan_add_)(&out->sum, &out->comp,
+                                         -parts[c].comp);
+        }
+        else
+            REDUCE_FN(reduce_merge_)(out, &parts[c]);
+
+    return 0;
+}
+
+
+int
+REDUCE_FN(darray_sum_)(darray_t da, REDUCE_ACC *out)
+{
+    REDUCE_PART part;
+    if (REDUCE_FN(reduce_)(da, REDUCE_OP_SUM, &part) != 0) return -1;
+
+    *out = (REDUCE_ACC)part.sum;
+    return 0;
+}
+
+
+#if REDUCE_FLOAT
+int
+REDUCE_FN(darray_sum_kahan_)(darray_t da, REDUCE_ACC *out)
+{
+    REDUCE_PART part;
+    if (REDUCE_FN(reduce_)(da, REDUCE_OP_KAHAN, &part) != 0) return -1;
+
+    *out = (REDUCE_ACC)(part.sum - part.comp);
+    return 0;
+}
+#endif
+
+
+int
+REDUCE_FN(darray_min_)(darray_t da, REDUCE_T *out)
+{
+    REDUCE_PART part;
+    if (REDUCE_FN(reduce_)(da, REDUCE_OP_MIN, &part) != 0) return -1;
+
+    *out = part.min;
+    return 0;
+}
+
+
+int
+REDUCE_FN(darray_max_)(darray_t da, REDUCE_T *out)
+{
+    REDUCE_PART part;
+    if (REDUCE_FN(reduce_)(da, REDUCE_OP_MAX, &part) != 0) return -1;
+
+    *out = part.max;
+    return 0;
+}
+
+
+int
+REDUCE_FN(darray_minmax_)(darray_t da, REDUCE_T *min, REDUCE_T *max)
+{
+    REDUCE_PART part;
+    if (REDUCE_FN(reduce_)(da, REDUCE_OP_MINMAX, &part) != 0) return -1;
+
+    *min = part.min;
+    *max = part.max;
+    return 0;
+}
+
+
+int
+REDUCE_FN(darray_argmin_)(darray_t da, size_t *index)
+{
+    REDUCE_PART part;
+    if (REDUCE_FN(reduce_)(da, REDUCE_OP_ARGMIN, &part) != 0) return -1;
+
+    *index = part.imin;
+    return 0;
+}
+
+
+int
+REDUCE_FN(darray_argmax_)(darray_t da, size_t *index)
+{
+    REDUCE_PART part;
+    if (REDUCE_FN(reduce_)(da, REDUCE_OP_ARGMAX, &part) != 0) return -1;
+
+    *index = part.imax;
+    return 0;
+}
+
+
+#ifdef REDUCE_SIMD
+#undef REDUCE_LANES
+#undef REDUCE_SUM_LANES
+#undef REDUCE_VEC
+#undef REDUCE_MASKVEC
+#undef REDUCE_SUMVEC
+#undef REDUCE_LOADVEC
+#undef REDUCE_BLEND
+#endif
+
+#undef REDUCE_PART
+#undef REDUCE_FN
+#undef REDUCE_PASTE
+#undef REDUCE_PASTE_
+
+#undef REDUCE_S
+#undef REDUCE_T
+#undef REDUCE_MASK
+#undef REDUCE_SUM
+#undef REDUCE_ACC
+#undef REDUCE_FLOAT
@@ -0,0 +1,178 @@
+#include "ds/segtree.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SEGTREE_FREE(st, ptr) \
+    ELSE_IF_NULL(((segtree_t)st)->free_fn, free, ptr)
+
+#define SEGTREE_NODE(st, index) \
+    ((st)->nodes + ((size_t)(index) * (st)->type_size))
+
+/* the most entries on the right side of a query, one per level */
+#define SEGTREE_DEPTH (sizeof(size_t) * 8)
+
+
+struct segment_tree
+{
+    /* entry 0 is unused, the elements start at `size` */
+    unsigned char *nodes;
+    size_t         size;
+    size_t         type_size;
+
+    segtree_combine_fn combine;
+
+    ds_free_fn free_fn;
+};
+
+
+/* folds the entry @index into the @count th part of a query result */
+static void
+segtree_fold(segtree_t st, void *out, size_t index, size_t count)
+{
+    if (count == 0)
+        memcpy(out, SEGTREE_NODE(st, index), st->type_size);
+    else
+        st->combine(out, out, SEGTREE_NODE(st, index));
+}
+
+
+segtree_t
+segtree_new_with_allocator(size_t type_size, const void *data, size_t size,
+                           segtree_combine_fn combine, ds_malloc_fn malloc_fn,
+                           ds_free_fn free_fn)
+{
+    if (type_size == 0 || size == 0)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if (size > SIZE_MAX / 2 / type_size)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    segtree_t st = ELSE_IF_NULL(malloc_fn, malloc,
+                                sizeof(struct segment_tree));
+    if (st == NULL) return NULL;
+
+    st->free_fn = free_fn;
+    st->nodes   = ELSE_IF_NULL(malloc_fn, malloc, 2 * size * type_size);
+    if (st->nodes == NULL)
+    {
+        SEGTREE_FREE(st, st);
+        return NULL;
+    }
+
+    st->size      = size;
+    st->type_size = type_size;
+    st->combine   = combine;
+
+    memcpy(SEGTREE_NODE(st, size), data, size * type_size);
+    for (size_t i = size - 1; i > 0; i--)
+        combine(SEGTREE_NODE(st, i), SEGTREE_NODE(st, 2 * i),
+                SEGTREE_NODE(st, (2 * i) + 1));
+
+    return st;
+}
+
+
+segtree_t
+segtree_new(size_t type_size, const void *data, size_t size,
+            segtree_combine_fn combine)
+{
+    return segtree_new_with_allocator(type_size, data, size, combine, NULL,
+                                      NULL);
+}
+
+
+segtree_t
+segtree_from_darray(darray_t da, segtree_combine_fn combine)
+{
+    if (darray_size(da) == 0)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    return segtree_new(darray_type_size(da), darray_data(da), darray_size(da),
+                       combine);
+}
+
+
+void
+segtree_free(segtree_t st)
+{
+    SEGTREE_FREE(st, st->nodes);
+    SEGTREE_FREE(st, st);
+}
+
+
+int
+segtree_set(segtree_t restrict st, size_t index, const void *restrict value)
+{
+    if (index >= st->size)
+    {
+        errno = ERANGE;
+        return -1;
+    }
+
+    index += st->size;
+    memcpy(SEGTREE_NODE(st, index), value, st->type_size);
+
+    for (index /= 2; index > 0; index /= 2)
+        st->combine(SEGTREE_NODE(st, index), SEGTREE_NODE(st, 2 * index),
+                    SEGTREE_NODE(st, (2 * index) + 1));
+
+    return 0;
+}
+
+
+const void *
+segtree_at(segtree_t st, size_t index)
+{
+    if (index >= st->size) return NULL;
+    return SEGTREE_NODE(st, st->size + index);
+}
+
+
+int
+segtree_query(segtree_t restrict st, size_t from, size_t to,
+              void *restrict out)
+{
+    if (from >= to || to > st->size)
+    {
+        errno = ERANGE;
+        return -1;
+    }
+
+    /*
+     * The entries on the left side are met in order, and the ones on the
+     * right side backwards, so those are kept to be folded last.
+     */
+    size_t right[SEGTREE_DEPTH];
+    size_t right_amount = 0;
+    size_t count        = 0;
+
+    for (from += st->size, to += st->size; from < to; from /= 2, to /= 2)
+    {
+        if (from & 1) segtree_fold(st, out, from++, count++);
+        if (to & 1) right[right_amount++] = --to;
+    }
+
+    while (right_amount > 0)
+        segtree_fold(st, out, right[--right_amount], count++);
+
+    return 0;
+}
+
+
+size_t
+segtree_size(segtree_t st)
+{
+    return st->size;
+}
@@ -0,0 +1,270 @@
+#include "ds/slotmap.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ds/darray.h"
+
+#define SLOTMAP_FREE(sm, ptr) \
+    ELSE_IF_NULL(((slotmap_t)sm)->free_fn, free, ptr)
+
+#define SLOTMAP_HANDLE(index, gen) \
+    (((slotmap_handle_t)(gen) << 32) | (slotmap_handle_t)(index))
+
+#define SLOTMAP_INDEX(handle)      ((uint32_t)(handle))
+#define SLOTMAP_GENERATION(handle) ((uint32_t)((handle) >> 32))
+
+/* the end of the free list */
+#define SLOTMAP_NONE UINT32_MAX
+
+
+/*
+ * A slot is occupied while its generation is odd, so the generation of a
+ * handle never matches a free slot, and SLOTMAP_NULL never matches at all.
+ */
+struct slotmap_slot
+{
+    /* the index of the element, or of the next free slot */
+    uint32_t index;
+    uint32_t generation;
+};
+
+
+struct slot_map
+{
+    darray_t values;
+    darray_t slots;
+
+    /* the slot of every element, to fix it up when the element moves */
+    darray_t owners;
+
+    uint32_t free_head;
+
+    ds_free_fn free_fn;
+};
+
+
+static struct slotmap_slot *
+slotmap_slot(slotmap_t sm, slotmap_handle_t handle)
+{
+    uint32_t index = SLOTMAP_INDEX(handle);
+    if (index >= darray_size(sm->slots)) return NULL;
+
+    struct slotmap_slot *slot = (struct slotmap_slot *)darray_data(sm->slots)
+                              + index;
+    return slot->generation == SLOTMAP_GENERATION(handle)
+                && (slot->generation & 1)
+             ? slot
+             : NULL;
+}
+
+
+/* grows @da by half its capacity once @size elements do not fit */
+static int
+slotmap_reserve(darray_t da, size_t size)
+{
+    size_t capacity = darray_capacity(da);
+    if (size <= capacity) return 0;
+
+    capacity += capacity / 2;
+    return darray_reserve(da, capacity > size ? capacity : size) == NULL
+             ? -1
+             : 0;
+}
+
+
+slotmap_t
+slotmap_new_with_allocator(size_t type_size, ds_malloc_fn malloc_fn,
+                           ds_realloc_fn realloc_fn, ds_free_fn free_fn)
+{
+    slotmap_t sm = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct slot_map));
+    if (sm == NULL) return NULL;
+
+    sm->free_head = SLOTMAP_NONE;
+    sm->free_fn   = free_fn;
+
+    sm->values = darray_new_with_allocator(type_size, malloc_fn, realloc_fn,
+                                           free_fn);
+    sm->slots  = darray_new_with_allocator(sizeof(struct slotmap_slot),
+                                           malloc_fn, realloc_fn, free_fn);
+    sm->owners = darray_new_with_allocator(sizeof(uint32_t), malloc_fn,
+                                           realloc_fn, free_fn);
+
+    if (sm->values == NULL || sm->slots == NULL || sm->owners == NULL)
+    {
+        if (sm->values != NULL) darray_free(sm->values);
+        if (sm->slots != NULL) darray_free(sm->slots);
+        if (sm->owners != NULL) darray_free(sm->owners);
+        SLOTMAP_FREE(sm, sm);
+        return NULL;
+    }
+
+    return sm;
+}
+
+
+slotmap_t
+slotmap_new(size_t type_size)
+{
+    return slotmap_new_with_allocator(type_size, NULL, NULL, NULL);
+}
+
+
+void
+slotmap_free(slotmap_t sm)
+{
+    darray_free_full(sm->values);
+    darray_free_full(sm->slots);
+    darray_free_full(sm->owners);
+    SLOTMAP_FREE(sm, sm);
+}
+
+
+slotmap_handle_t
+slotmap_insert(slotmap_t sm, const void *data)
+{
+    size_t index = darray_size(sm->values);
+    if (index >= SLOTMAP_NONE || darray_size(sm->slots) >= SLOTMAP_NONE)
+    {
+        errno = ENOMEM;
+        return SLOTMAP_NULL;
+    }
+
+    /* reserve everything first, so a failure leaves nothing half done */
+    if (slotmap_reserve(sm->values, index + 1) != 0
+        || slotmap_reserve(sm->owners, index + 1) != 0
+        || (sm->free_head == SLOTMAP_NONE
+            && slotmap_reserve(sm->slots, darray_size(sm->slots) + 1) != 0))
+        return SLOTMAP_NULL;
+
+    uint32_t slot_index = sm->free_head;
+    if (slot_index == SLOTMAP_NONE)
+    {
+        struct slotmap_slot empty = { SLOTMAP_NONE, 0 };
+        slot_index                = (uint32_t)darray_size(sm->slots);
+        darray_push_back(sm->slots, &empty);
+    }
+
+    struct slotmap_slot *slot = darray_at(sm->slots, slot_index);
+    sm->free_head             = slot->index;
+
+    darray_resize(sm->values, index + 1);
+    if (data != NULL)
+        memcpy(darray_at(sm->values, index), data,
+               darray_type_size(sm->values));
+
+    darray_push_back(sm->owners, &slot_index);
+
+    slot->index = (uint32_t)index;
+    slot->generation++;
+
+    return SLOTMAP_HANDLE(slot_index, slot->generation);
+}
+
+
+int
+slotmap_erase(slotmap_t sm, slotmap_handle_t handle)
+{
+    struct slotmap_slot *slot = slotmap_slot(sm, handle);
+    if (slot == NULL)
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
+    size_t index = slot->index;
+    size_t last  = darray_size(sm->values) - 1;
+
+    if (index != last)
+    {
+        uint32_t *owners = darray_data(sm->owners);
+        memcpy(darray_at(sm->values, index), darray_at(sm->values, last),
+               darray_type_size(sm->values));
+
+        owners[index] = owners[last];
+        ((struct slotmap_slot *)darray_data(sm->slots))[owners[index]].index
+            = (uint32_t)index;
+    }
+
+    darray_pop_back(sm->values);
+    darray_pop_back(sm->owners);
+
+    /* a slot whose generation would wrap around is retired for good */
+    slot->generation++;
+    if (slot->generation != UINT32_MAX - 1)
+    {
+        slot->index   = sm->free_head;
+        sm->free_head = SLOTMAP_INDEX(handle);
+    }
+
+    return 0;
+}
+
+
+void *
+slotmap_get(slotmap_t sm, slotmap_handle_t handle)
+{
+    struct slotmap_slot *slot = slotmap_slot(sm, handle);
+    if (slot == NULL) return NULL;
+
+    return (char *)darray_data(sm->values)
+         + ((size_t)slot->index * darray_type_size(sm->values));
+}
+
+
+int
+slotmap_contains(slotmap_t sm, slotmap_handle_t handle)
+{
+    return slotmap_slot(sm, handle) != NULL;
+}
+
+
+void
+slotmap_clear(slotmap_t sm)
+{
+    const uint32_t *owners = darray_data(sm->owners);
+    const size_t    size   = darray_size(sm->owners);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        struct slotmap_slot *slot
+            = (struct slotmap_slot *)darray_data(sm->slots) + owners[i];
+
+        slot->generation++;
+        if (slot->generation != UINT32_MAX - 1)
+        {
+            slot->index   = sm->free_head;
+            sm->free_head = owners[i];
+        }
+    }
+
+    darray_clear(sm->values);
+    darray_clear(sm->owners);
+}
+
+
+void *
+slotmap_data(slotmap_t sm)
+{
+    return darray_data(sm->values);
+}
+
+
+slotmap_handle_t
+slotmap_handle_at(slotmap_t sm, size_t index)
+{
+    const uint32_t *owner = darray_at(sm->owners, index);
+    if (owner == NULL) return SLOTMAP_NULL;
+
+    const struct slotmap_slot *slot
+        = (const struct slotmap_slot *)darray_data(sm->slots) + *owner;
+    return SLOTMAP_HANDLE(*owner, slot->generation);
+}
+
+
+size_t
+slotmap_size(slotmap_t sm)
+{
+    return darray_size(sm->values);
+}
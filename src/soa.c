@@ -0,0 +1,274 @@
+#include "ds/soa.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SOA_FREE(soa, ptr) \
+    ELSE_IF_NULL(((soa_t)soa)->free_fn, free, ptr)
+
+#define SOA_REALLOC(soa, ...) \
+    ELSE_IF_NULL(((soa_t)soa)->realloc_fn, realloc, __VA_ARGS__)
+
+#define SOA_INITIAL_SIZE 5
+
+#define SOA_AT(soa, column, index)  \
+    ((char *)(soa)->cols[column].data \
+     + ((index) * (soa)->cols[column].tp_size))
+
+
+struct soa_column
+{
+    void  *data;
+    size_t tp_size;
+};
+
+
+struct soa_array
+{
+    size_t alloc_size;
+    size_t elem_amount;
+
+    ds_realloc_fn realloc_fn;
+    ds_free_fn    free_fn;
+
+    size_t            columns;
+    struct soa_column cols[];
+};
+
+
+soa_t
+soa_new_with_allocator(size_t columns, const size_t *column_sizes,
+                       ds_malloc_fn malloc_fn, ds_realloc_fn realloc_fn,
+                       ds_free_fn free_fn)
+{
+    if (columns == 0) goto inval;
+    for (size_t i = 0; i < columns; i++)
+        if (column_sizes[i] == 0) goto inval;
+
+    size_t size = sizeof(struct soa_array)
+                + (columns * sizeof(struct soa_column));
+    soa_t soa = ELSE_IF_NULL(malloc_fn, malloc, size);
+    if (soa == NULL) return NULL;
+
+    soa->alloc_size  = 0;
+    soa->elem_amount = 0;
+    soa->realloc_fn  = realloc_fn;
+    soa->free_fn     = free_fn;
+    soa->columns     = columns;
+
+    for (size_t i = 0; i < columns; i++)
+    {
+        soa->cols[i].data    = NULL;
+        soa->cols[i].tp_size = column_sizes[i];
+    }
+
+    return soa;
+
+inval:
+    errno = EINVAL;
+    return NULL;
+}
+
+
+soa_t
+soa_new(size_t columns, const size_t *column_sizes)
+{
+    return soa_new_with_allocator(columns, column_sizes, NULL, NULL, NULL);
+}
+
+
+void
+soa_free(soa_t soa)
+{
+    for (size_t i = 0; i < soa->columns; i++)
+        if (soa->cols[i].data != NULL) SOA_FREE(soa, soa->cols[i].data);
+
+    SOA_FREE(soa, soa);
+}
+
+
+void *
+soa_reserve(soa_t soa, size_t size)
+{
+    if (soa->alloc_size >= size) return soa->cols[0].data;
+    if (size == 0)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    /* a column that grew before a later one failed simply keeps the room */
+    errno = 0;
+    for (size_t i = 0; i < soa->columns; i++)
+    {
+        struct soa_column *col      = &soa->cols[i];
+        void              *new_data = SOA_REALLOC(soa, col->data,
+                                                  size * col->tp_size);
+        if (new_data == NULL) return NULL;
+
+        col->data = new_data;
+    }
+
+    soa->alloc_size = size;
+    return soa->cols[0].data;
+}
+
+
+void *
+soa_resize(soa_t soa, size_t size)
+{
+    const size_t old_size = soa->elem_amount;
+    void        *res      = soa_reserve(soa, size);
+
+    if (res == NULL) return NULL;
+
+    if (size > old_size)
+        for (size_t i = 0; i < soa->columns; i++)
+            memset(SOA_AT(soa, i, old_size), 0,
+                   (size - old_size) * soa->cols[i].tp_size);
+
+    soa->elem_amount = size;
+    return res;
+}
+
+
+void
+soa_clear(soa_t soa)
+{
+    soa->elem_amount = 0;
+}
+
+
+int
+soa_push_back(soa_t soa, const void *const *row)
+{
+    if (soa->elem_amount >= soa->alloc_size)
+    {
+        size_t size = soa->alloc_size == 0
+                        ? SOA_INITIAL_SIZE
+                        : soa->alloc_size + (soa->alloc_size >> 1);
+
+        if (soa_reserve(soa, size) == NULL) return -1;
+    }
+
+    for (size_t i = 0; i < soa->columns; i++)
+        memcpy(SOA_AT(soa, i, soa->elem_amount), row[i],
+               soa->cols[i].tp_size);
+
+    soa->elem_amount++;
+    return 0;
+}
+
+
+int
+soa_pop_back(soa_t soa)
+{
+    if (soa->elem_amount == 0)
+    {
+        errno = ERANGE;
+        return -1;
+    }
+
+    soa->elem_amount--;
+    return 0;
+}
+
+
+int
+soa_erase(soa_t soa, size_t pos)
+{
+    if (pos >= soa->elem_amount)
+    {
+        errno = ERANGE;
+        return -1;
+    }
+
+    const size_t rows_to_move = soa->elem_amount - pos - 1;
+    for (size_t i = 0; i < soa->columns; i++)
+        memmove(SOA_AT(soa, i, pos), SOA_AT(soa, i, pos + 1),
+                rows_to_move * soa->cols[i].tp_size);
+
+    soa->elem_amount--;
+    return 0;
+}
+
+
+int
+soa_get(soa_t soa, size_t index, void *const *row)
+{
+    if (index >= soa->elem_amount)
+    {
+        errno = ERANGE;
+        return -1;
+    }
+
+    for (size_t i = 0; i < soa->columns; i++)
+        memcpy(row[i], SOA_AT(soa, i, index), soa->cols[i].tp_size);
+
+    return 0;
+}
+
+
+int
+soa_set(soa_t soa, size_t index, const void *const *row)
+{
+    if (index >= soa->elem_amount)
+    {
+        errno = ERANGE;
+        return -1;
+    }
+
+    for (size_t i = 0; i < soa->columns; i++)
+        memcpy(SOA_AT(soa, i, index), row[i], soa->cols[i].tp_size);
+
+    return 0;
+}
+
+
+void *
+soa_at(soa_t soa, size_t column, size_t index)
+{
+    if (column >= soa->columns || index >= soa->elem_amount)
+    {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    return SOA_AT(soa, column, index);
+}
+
+
+void *
+soa_column(soa_t soa, size_t column)
+{
+    return column < soa->columns ? soa->cols[column].data : NULL;
+}
+
+
+size_t
+soa_column_size(soa_t soa, size_t column)
+{
+    return column < soa->columns ? soa->cols[column].tp_size : 0;
+}
+
+
+size_t
+soa_columns(soa_t soa)
+{
+    return soa->columns;
+}
+
+
+size_t
+soa_size(soa_t soa)
+{
+    return soa->elem_amount;
+}
+
+
+size_t
+soa_capacity(soa_t soa)
+{
+    return soa->alloc_size;
+}
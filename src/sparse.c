@@ -0,0 +1,244 @@
+#include "ds/sparse.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SPARSE_FREE(ss, ptr) \
+    ELSE_IF_NULL(((sparse_t)ss)->free_fn, free, ptr)
+
+#define SPARSE_REALLOC(ss, ...) \
+    ELSE_IF_NULL(((sparse_t)ss)->realloc_fn, realloc, __VA_ARGS__)
+
+#define SPARSE_INITIAL_SIZE 16
+
+/* without values, the key stands in so a found key is never `NULL` */
+#define SPARSE_VALUE(ss, index)                                        \
+    ((ss)->value_size == 0                                             \
+         ? (void *)&(ss)->dense[index]                                 \
+         : (void *)((unsigned char *)(ss)->values                      \
+                    + ((index) * (ss)->value_size)))
+
+
+struct sparse_set
+{
+    /* the dense index of every key, meaningful only if `dense` agrees */
+    size_t *sparse;
+    size_t  sparse_size;
+
+    size_t *dense;
+    void   *values;
+    size_t  value_size;
+    size_t  size;
+    size_t  dense_alloc;
+
+    ds_realloc_fn realloc_fn;
+    ds_free_fn    free_fn;
+};
+
+
+/* grows @ptr to hold at least @need elements of @size bytes */
+static int
+sparse_grow(sparse_t ss, void **ptr, size_t *alloc, size_t need, size_t size)
+{
+    size_t new_alloc = *alloc + (*alloc / 2);
+    if (new_alloc < need) new_alloc = need;
+    if (new_alloc < SPARSE_INITIAL_SIZE) new_alloc = SPARSE_INITIAL_SIZE;
+
+    if (new_alloc > SIZE_MAX / size)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    void *new_ptr = SPARSE_REALLOC(ss, *ptr, new_alloc * size);
+    if (new_ptr == NULL) return -1;
+
+    *ptr   = new_ptr;
+    *alloc = new_alloc;
+    return 0;
+}
+
+
+static size_t
+sparse_index(sparse_t ss, size_t key)
+{
+    if (key >= ss->sparse_size) return SIZE_MAX;
+
+    size_t index = ss->sparse[key];
+    return index < ss->size && ss->dense[index] == key ? index : SIZE_MAX;
+}
+
+
+sparse_t
+sparse_new_with_allocator(size_t value_size, ds_malloc_fn malloc_fn,
+                          ds_realloc_fn realloc_fn, ds_free_fn free_fn)
+{
+    sparse_t ss = ELSE_IF_NULL(malloc_fn, malloc, sizeof(struct sparse_set));
+    if (ss == NULL) return NULL;
+
+    ss->sparse      = NULL;
+    ss->sparse_size = 0;
+    ss->dense       = NULL;
+    ss->values      = NULL;
+    ss->value_size  = value_size;
+    ss->size        = 0;
+    ss->dense_alloc = 0;
+
+    ss->realloc_fn = realloc_fn;
+    ss->free_fn    = free_fn;
+    return ss;
+}
+
+
+sparse_t
+sparse_new(size_t value_size)
+{
+    return sparse_new_with_allocator(value_size, NULL, NULL, NULL);
+}
+
+
+void
+sparse_free(sparse_t ss)
+{
+    if (ss->sparse != NULL) SPARSE_FREE(ss, ss->sparse);
+    if (ss->dense != NULL) SPARSE_FREE(ss, ss->dense);
+    if (ss->values != NULL) SPARSE_FREE(ss, ss->values);
+    SPARSE_FREE(ss, ss);
+}
+
+
+void *
+sparse_insert(sparse_t ss, size_t key, const void *value)
+{
+    if (sparse_index(ss, key) != SIZE_MAX)
+    {
+        errno = EEXIST;
+        return NULL;
+    }
+
+    if (key >= ss->sparse_size)
+    {
+        if (key == SIZE_MAX)
+        {
+            errno = ERANGE;
+            return NULL;
+        }
+
+        size_t old_size = ss->sparse_size;
+        if (sparse_grow(ss, (void **)&ss->sparse, &ss->sparse_size, key + 1,
+                        sizeof(size_t))
+            != 0)
+            return NULL;
+
+        /* stale indices are harmless, but should not be uninitialized */
+        memset(ss->sparse + old_size, 0,
+               (ss->sparse_size - old_size) * sizeof(size_t));
+    }
+
+    if (ss->size == ss->dense_alloc)
+    {
+        size_t alloc = ss->dense_alloc;
+
+        if (sparse_grow(ss, (void **)&ss->dense, &alloc, ss->size + 1,
+                        sizeof(size_t))
+            != 0)
+            return NULL;
+
+        if (ss->value_size > 0)
+        {
+            size_t values_alloc = ss->dense_alloc;
+            if (sparse_grow(ss, &ss->values, &values_alloc, alloc,
+                            ss->value_size)
+                != 0)
+                return NULL;
+        }
+
+        ss->dense_alloc = alloc;
+    }
+
+    size_t index     = ss->size++;
+    ss->dense[index] = key;
+    ss->sparse[key]  = index;
+
+    void *slot = SPARSE_VALUE(ss, index);
+    if (ss->value_size > 0)
+    {
+        if (value != NULL)
+            memcpy(slot, value, ss->value_size);
+        else
+            memset(slot, 0, ss->value_size);
+    }
+
+    return slot;
+}
+
+
+int
+sparse_erase(sparse_t ss, size_t key)
+{
+    size_t index = sparse_index(ss, key);
+    if (index == SIZE_MAX)
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
+    size_t last = --ss->size;
+    if (index != last)
+    {
+        size_t moved      = ss->dense[last];
+        ss->dense[index]  = moved;
+        ss->sparse[moved] = index;
+
+        if (ss->value_size > 0)
+            memcpy(SPARSE_VALUE(ss, index), SPARSE_VALUE(ss, last),
+                   ss->value_size);
+    }
+
+    return 0;
+}
+
+
+int
+sparse_contains(sparse_t ss, size_t key)
+{
+    return sparse_index(ss, key) != SIZE_MAX;
+}
+
+
+void *
+sparse_get(sparse_t ss, size_t key)
+{
+    size_t index = sparse_index(ss, key);
+    return index == SIZE_MAX ? NULL : SPARSE_VALUE(ss, index);
+}
+
+
+void
+sparse_clear(sparse_t ss)
+{
+    ss->size = 0;
+}
+
+
+const size_t *
+sparse_keys(sparse_t ss)
+{
+    return ss->dense;
+}
+
+
+void *
+sparse_values(sparse_t ss)
+{
+    return ss->values;
+}
+
+
+size_t
+sparse_size(sparse_t ss)
+{
+    return ss->size;
+}
@@ -0,0 +1,341 @@
+#define _POSIX_C_SOURCE 200809L
+#include "ds/tcache.h"
+
+#include <stdlib.h>
+
+#include <pthread.h>
+
+#include "ds/__priv/tcache.h"
+
+#ifndef DS_TCACHE_DEFAULT
+#define DS_TCACHE_DEFAULT 0
+#endif
+
+/*
+ * Every class holds objects of exactly one size, a multiple of the class
+ * step, so an object freed with plain `malloc` semantics can be cached.
+ */
+#define TCACHE_CLASS_STEP 8
+#define TCACHE_CLASSES    32
+
+#define TCACHE_MAGAZINE_SIZE 64
+
+/* the magazines a depot keeps per class before releasing them */
+#define TCACHE_DEPOT_LIMIT 32
+
+#define TCACHE_ON() __atomic_load_n(&tcache_on, __ATOMIC_RELAXED)
+
+
+struct tcache_magazine
+{
+    struct tcache_magazine *next;
+
+    size_t count;
+    void  *objs[TCACHE_MAGAZINE_SIZE];
+};
+
+
+struct tcache_class
+{
+    /* objects are taken from and given to `loaded` first */
+    struct tcache_magazine *loaded;
+    struct tcache_magazine *previous;
+};
+
+
+struct tcache_thread
+{
+    struct tcache_class classes[TCACHE_CLASSES];
+};
+
+
+struct tcache_depot
+{
+    pthread_mutex_t lock;
+
+    struct tcache_magazine *full;
+    struct tcache_magazine *empty;
+    size_t                  full_amount;
+    size_t                  empty_amount;
+};
+
+
+static int tcache_on = DS_TCACHE_DEFAULT;
+static int tcache_ready;
+
+static pthread_once_t      tcache_once = PTHREAD_ONCE_INIT;
+static pthread_key_t       tcache_key;
+static struct tcache_depot tcache_depots[TCACHE_CLASSES];
+
+
+static size_t
+tcache_class(size_t size)
+{
+    if (size == 0 || size % TCACHE_CLASS_STEP != 0) return TCACHE_CLASSES;
+    return (size / TCACHE_CLASS_STEP) - 1;
+}
+
+
+static void
+tcache_release(struct tcache_magazine *mag)
+{
+    for (size_t i = 0; i < mag->count; i++) free(mag->objs[i]);
+    free(mag);
+}
+
+
+/* hands @mag to the depot of @cls , freeing it if the depot is full */
+static void
+tcache_depot_put(size_t cls, struct tcache_magazine *mag)
+{
+    struct tcache_depot *depot = &tcache_depots[cls];
+
+    pthread_mutex_lock(&depot->lock);
+
+    struct tcache_magazine **list   = mag->count > 0 ? &depot->full
+                                                     : &depot->empty;
+    size_t                  *amount = mag->count > 0 ? &depot->full_amount
+                                                     : &depot->empty_amount;
+    if (*amount < TCACHE_DEPOT_LIMIT)
+    {
+        mag->next = *list;
+        *list     = mag;
+        (*amount)++;
+        mag = NULL;
+    }
+
+    pthread_mutex_unlock(&depot->lock);
+
+    if (mag != NULL) tcache_release(mag);
+}
+
+
+/* takes a full or an empty magazine from the depot of @cls */
+static struct tcache_magazine *
+tcache_depot_get(size_t cls, int full)
+{
+    struct tcache_depot *depot = &tcache_depots[cls];
+
+    pthread_mutex_lock(&depot->lock);
+
+    struct tcache_magazine **list = full ? &depot->full : &depot->empty;
+    struct tcache_magazine  *mag  = *list;
+    if (mag != NULL)
+    {
+        *list = mag->next;
+        if (full)
+            depot->full_amount--;
+        else
+            depot->empty_amount--;
+    }
+
+    pthread_mutex_unlock(&depot->lock);
+
+    if (mag == NULL && !full)
+    {
+        mag = malloc(sizeof(struct tcache_magazine));
+        if (mag != NULL) mag->count = 0;
+    }
+
+    return mag;
+}
+
+
+static void
+tcache_thread_release(void *ptr)
+{
+    struct tcache_thread *tc = ptr;
+
+    for (size_t i = 0; i < TCACHE_CLASSES; i++)
+    {
+        if (tc->classes[i].loaded != NULL)
+            tcache_depot_put(i, tc->classes[i].loaded);
+        if (tc->classes[i].previous != NULL)
+            tcache_depot_put(i, tc->classes[i].previous);
+    }
+
+    free(tc);
+}
+
+
+static void
+tcache_init(void)
+{
+    for (size_t i = 0; i < TCACHE_CLASSES; i++)
+    {
+        pthread_mutex_init(&tcache_depots[i].lock, NULL);
+        tcache_depots[i].full         = NULL;
+        tcache_depots[i].empty        = NULL;
+        tcache_depots[i].full_amount  = 0;
+        tcache_depots[i].empty_amount = 0;
+    }
+
+    tcache_ready = pthread_key_create(&tcache_key, tcache_thread_release) == 0;
+}
+
+
+/*
+ * Returns the magazines of the calling thread for @cls , or `NULL` if they
+ * could not be allocated, in which case the system allocator is used.
+ */
+static struct tcache_class *
+tcache_get(size_t cls)
+{
+    pthread_once(&tcache_once, tcache_init);
+    if (!tcache_ready) return NULL;
+
+    struct tcache_thread *tc = pthread_getspecific(tcache_key);
+    if (tc == NULL)
+    {
+        tc = calloc(1, sizeof(struct tcache_thread));
+        if (tc == NULL) return NULL;
+
+        if (pthread_setspecific(tcache_key, tc) != 0)
+        {
+            free(tc);
+            return NULL;
+        }
+    }
+
+    struct tcache_class *c = &tc->classes[cls];
+    if (c->loaded == NULL) c->loaded = tcache_depot_get(cls, 0);
+    if (c->previous == NULL) c->previous = tcache_depot_get(cls, 0);
+
+    return c->loaded != NULL && c->previous != NULL ? c : NULL;
+}
+
+
+void *
+ds_tcache_malloc(size_t size)
+{
+    size_t cls = tcache_class(size);
+    if (cls >= TCACHE_CLASSES || !TCACHE_ON()) return malloc(size);
+
+    struct tcache_class *c = tcache_get(cls);
+    if (c == NULL) return malloc(size);
+
+    if (c->loaded->count == 0)
+    {
+        struct tcache_magazine *full;
+
+        if (c->previous->count > 0)
+        {
+            full        = c->previous;
+            c->previous = c->loaded;
+        }
+        else if ((full = tcache_depot_get(cls, 1)) != NULL)
+            tcache_depot_put(cls, c->loaded);
+        else
+            return malloc(size);
+
+        c->loaded = full;
+    }
+
+    return c->loaded->objs[--c->loaded->count];
+}
+
+
+void
+ds_tcache_free(void *ptr, size_t size)
+{
+    size_t cls = tcache_class(size);
+    if (cls >= TCACHE_CLASSES || !TCACHE_ON())
+    {
+        free(ptr);
+        return;
+    }
+
+    struct tcache_class *c = tcache_get(cls);
+    if (c == NULL)
+    {
+        free(ptr);
+        return;
+    }
+
+    if (c->loaded->count == TCACHE_MAGAZINE_SIZE)
+    {
+        struct tcache_magazine *empty;
+
+        if (c->previous->count == 0)
+        {
+            empty       = c->previous;
+            c->previous = c->loaded;
+        }
+        else if ((empty = tcache_depot_get(cls, 0)) != NULL)
+            tcache_depot_put(cls, c->loaded);
+        else
+        {
+            free(ptr);
+            return;
+        }
+
+        c->loaded = empty;
+    }
+
+    c->loaded->objs[c->loaded->count++] = ptr;
+}
+
+
+void
+tcache_set_enabled(int enabled)
+{
+    __atomic_store_n(&tcache_on, enabled != 0, __ATOMIC_RELAXED);
+}
+
+
+int
+tcache_enabled(void)
+{
+    return TCACHE_ON();
+}
+
+
+void
+tcache_flush(void)
+{
+    pthread_once(&tcache_once, tcache_init);
+    if (!tcache_ready) return;
+
+    struct tcache_thread *tc = pthread_getspecific(tcache_key);
+    if (tc == NULL) return;
+
+    pthread_setspecific(tcache_key, NULL);
+    tcache_thread_release(tc);
+}
+
+
+void
+tcache_trim(void)
+{
+    pthread_once(&tcache_once, tcache_init);
+
+    for (size_t i = 0; i < TCACHE_CLASSES; i++)
+    {
+        struct tcache_depot *depot = &tcache_depots[i];
+
+        pthread_mutex_lock(&depot->lock);
+
+        struct tcache_magazine *full  = depot->full;
+        struct tcache_magazine *empty = depot->empty;
+        depot->full                   = NULL;
+        depot->empty                  = NULL;
+        depot->full_amount            = 0;
+        depot->empty_amount           = 0;
+
+        pthread_mutex_unlock(&depot->lock);
+
+        while (full != NULL)
+        {
+            struct tcache_magazine *next = full->next;
+            tcache_release(full);
+            full = next;
+        }
+
+        while (empty != NULL)
+        {
+            struct tcache_magazine *next = empty->next;
+            free(empty);
+            empty = next;
+        }
+    }
+}
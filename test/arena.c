@@ -0,0 +1,171 @@
+#include "ds/arena.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ds/darray.h"
+#include "ds/list.h"
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define CHUNK_SIZE 4096
+
+
+void
+test_bump(void)
+{
+    START
+
+    arena_t arena = arena_new(CHUNK_SIZE);
+    ASSERT(arena != NULL && arena_size(arena) == CHUNK_SIZE);
+
+    /* aligned, and never overlapping */
+    unsigned char *first = arena_alloc(arena, 1);
+    unsigned char *prev  = first;
+    memset(prev, 0, 1);
+
+    for (size_t i = 1; i < 500; i++)
+    {
+        unsigned char *ptr = arena_alloc(arena, i);
+        ASSERT(ptr != NULL && (uintptr_t)ptr % 16 == 0);
+        memset(ptr, (int)(i & 0xff), i);
+        ASSERT(prev[0] == (unsigned char)((i - 1) & 0xff));
+        prev = ptr;
+    }
+
+    /* the allocations spilled into more chunks, which a reset keeps */
+    size_t size = arena_size(arena);
+    ASSERT(size > CHUNK_SIZE);
+
+    arena_reset(arena);
+    ASSERT(arena_alloc(arena, 1) == first);
+    ASSERT(arena_size(arena) == size);
+
+    /* a mark returns the same memory */
+    arena_mark_t mark = arena_mark(arena);
+    void        *a    = arena_alloc(arena, 100);
+    for (size_t i = 0; i < 100; i++) ASSERT(arena_alloc(arena, 100) != NULL);
+    arena_rewind(arena, mark);
+    ASSERT(arena_alloc(arena, 100) == a);
+
+    /* larger than a chunk */
+    unsigned char *big = arena_alloc(arena, CHUNK_SIZE * 4);
+    ASSERT(big != NULL);
+    memset(big, 1, CHUNK_SIZE * 4);
+
+    arena_reset(arena);
+    arena_trim(arena);
+    ASSERT(arena_size(arena) == CHUNK_SIZE);
+    ASSERT(arena_alloc(arena, SIZE_MAX) == NULL && errno == ENOMEM);
+
+    arena_free(arena);
+    SUCCESS
+}
+
+
+void
+test_resize(void)
+{
+    START
+
+    arena_t arena = arena_new(CHUNK_SIZE);
+    ASSERT(arena_use(arena) == NULL && arena_current() == arena);
+
+    /* the most recent allocation grows and shrinks in place */
+    unsigned char *top = arena_malloc(16);
+    memset(top, 7, 16);
+    ASSERT(arena_realloc(top, 1000) == top);
+    ASSERT(arena_realloc(top, 8) == top);
+    ASSERT(top[0] == 7 && top[7] == 7);
+
+    /* anything else moves when it grows */
+    unsigned char *other = arena_malloc(16);
+    ASSERT(arena_realloc(top, 12) == top);
+    unsigned char *moved = arena_realloc(top, 64);
+    ASSERT(moved != top && moved[0] == 7 && moved[7] == 7);
+
+    /* freeing the top gives its memory back, anything else is kept */
+    arena_dealloc(moved);
+    ASSERT(arena_malloc(64) == moved);
+    arena_dealloc(other);
+    ASSERT(arena_malloc(16) != other);
+    arena_dealloc(NULL);
+
+    /* past the end of the chunk, the top moves into the next one */
+    top = arena_malloc(16);
+    memset(top, 3, 16);
+    moved = arena_realloc(top, CHUNK_SIZE);
+    ASSERT(moved != NULL && moved != top && moved[15] == 3);
+
+    ASSERT(arena_use(NULL) == arena);
+    ASSERT(arena_malloc(1) == NULL && errno == EINVAL);
+
+    arena_free(arena);
+    SUCCESS
+}
+
+
+void
+test_containers(void)
+{
+    START
+
+    arena_t arena = arena_new(0);
+    arena_use(arena);
+
+    darray_t da = darray_new_with_allocator(sizeof(int), arena_malloc,
+                                            arena_realloc, arena_dealloc);
+    ASSERT(da != NULL);
+
+    int value = 0;
+    darray_push_back(da, &value);
+
+    /* the buffer stays at the top, so it always grows in place */
+    void *data = darray_data(da);
+    for (value = 1; value < 5000; value++) darray_push_back(da, &value);
+
+    ASSERT(darray_data(da) == data && darray_size(da) == 5000);
+    for (int i = 0; i < 5000; i++) ASSERT(*(int *)darray_at(da, i) == i);
+
+    list_t list = list_new_with_allocator(arena_malloc, arena_dealloc);
+    ASSERT(list != NULL);
+
+    int items[100];
+    list_set_data(list, &items[0]);
+    for (int i = 1; i < 100; i++) ASSERT(list_append(list, &items[i]) != NULL);
+    ASSERT(list_data(list_at(list, 99)) == &items[99]);
+
+    /* the whole request is torn down at once */
+    arena_mark_t empty = arena_mark(arena);
+    arena_reset(arena);
+    ASSERT(empty.used > 0 && arena_mark(arena).used == 0);
+
+    darray_t again = darray_new_with_allocator(sizeof(int), arena_malloc,
+                                               arena_realloc, arena_dealloc);
+    ASSERT(again == da);
+
+    arena_free(arena);
+    ASSERT(arena_current() == NULL);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_bump();
+    test_resize();
+    test_containers();
+
+    return 0;
+}
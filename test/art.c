@@ -0,0 +1,218 @@
+#include "ds/art.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define PATH_AMOUNT 5000
+
+
+struct visit
+{
+    char   last[64];
+    size_t last_len;
+    size_t count;
+    int    ordered;
+};
+
+
+static int
+visit_key(const void *key, size_t len, void *value, void *data)
+{
+    struct visit *v = data;
+
+    size_t min = len < v->last_len ? len : v->last_len;
+    int    res = memcmp(v->last, key, min);
+    if (v->count > 0 && (res > 0 || (res == 0 && v->last_len >= len)))
+        v->ordered = 0;
+
+    memcpy(v->last, key, len);
+    v->last_len = len;
+    v->count++;
+    return 0;
+}
+
+
+static int
+stop_after_two(const void *key, size_t len, void *value, void *data)
+{
+    return ++*(int *)data == 2 ? 7 : 0;
+}
+
+
+/* a long shared prefix, so most nodes store only part of their prefix */
+static size_t
+make_path(char *buf, size_t i)
+{
+    return (size_t)sprintf(buf, "/usr/share/libds/data/%zu/%zu", i % 37, i);
+}
+
+
+void
+test_basic(void)
+{
+    START
+
+    art_t art = art_new_with_allocator(xmalloc, NULL);
+    int   a = 1, b = 2, c = 3;
+
+    ASSERT(art_find(art, "a", 1) == NULL);
+    ASSERT(art_erase(art, "a", 1) == -1 && errno == ENOENT);
+
+    /* keys that are prefixes of each other */
+    ASSERT(art_insert(art, "abc", 3, &a) == 0);
+    ASSERT(art_insert(art, "ab", 2, &b) == 0);
+    ASSERT(art_insert(art, "", 0, &c) == 0);
+    ASSERT(art_insert(art, "ab", 2, &c) == -1 && errno == EEXIST);
+    ASSERT(art_size(art) == 3);
+
+    ASSERT(*art_find(art, "abc", 3) == &a);
+    ASSERT(*art_find(art, "ab", 2) == &b);
+    ASSERT(*art_find(art, "", 0) == &c);
+    ASSERT(art_find(art, "a", 1) == NULL);
+    ASSERT(art_find(art, "abcd", 4) == NULL);
+
+    size_t len = 0;
+    ASSERT(*art_longest_prefix(art, "abd", 3, &len) == &b && len == 2);
+    ASSERT(*art_longest_prefix(art, "abcdef", 6, &len) == &a && len == 3);
+    ASSERT(*art_longest_prefix(art, "x", 1, &len) == &c && len == 0);
+
+    ASSERT(art_erase(art, "ab", 2) == 0);
+    ASSERT(art_find(art, "ab", 2) == NULL && *art_find(art, "abc", 3) == &a);
+    ASSERT(art_erase(art, "", 0) == 0 && art_erase(art, "abc", 3) == 0);
+    ASSERT(art_size(art) == 0);
+
+    art_free(art);
+    ASSERT(art_new_with_allocator(fail_malloc, NULL) == NULL);
+    SUCCESS
+}
+
+
+void
+test_node_growth(void)
+{
+    START
+
+    art_t art = art_new();
+
+    /* every byte below a shared prefix, growing one node to 256 children */
+    for (int i = 0; i < 256; i++)
+    {
+        unsigned char key[] = { 'k', 'e', 'y', (unsigned char)i };
+        ASSERT(art_insert(art, key, 4, (void *)(intptr_t)(i + 1)) == 0);
+    }
+
+    for (int i = 0; i < 256; i++)
+    {
+        unsigned char key[] = { 'k', 'e', 'y', (unsigned char)i };
+        ASSERT(*art_find(art, key, 4) == (void *)(intptr_t)(i + 1));
+    }
+
+    struct visit v = { .ordered = 1 };
+    ASSERT(art_foreach_prefix(art, "ke", 2, visit_key, &v) == 0);
+    ASSERT(v.count == 256 && v.ordered);
+
+    /* and shrinking it back down */
+    for (int i = 255; i > 0; i--)
+    {
+        unsigned char key[] = { 'k', 'e', 'y', (unsigned char)i };
+        ASSERT(art_erase(art, key, 4) == 0);
+        ASSERT(art_find(art, key, 4) == NULL);
+    }
+
+    unsigned char key[] = { 'k', 'e', 'y', 0 };
+    ASSERT(*art_find(art, key, 4) == (void *)1 && art_size(art) == 1);
+
+    art_free(art);
+    SUCCESS
+}
+
+
+void
+test_paths(void)
+{
+    START
+
+    art_t art = art_new();
+    char  buf[64];
+
+    for (size_t i = 0; i < PATH_AMOUNT; i++)
+    {
+        size_t len = make_path(buf, i);
+        ASSERT(art_insert(art, buf, len, (void *)(uintptr_t)(i + 1)) == 0);
+    }
+
+    ASSERT(art_size(art) == PATH_AMOUNT);
+    for (size_t i = 0; i < PATH_AMOUNT; i++)
+    {
+        size_t len = make_path(buf, i);
+        ASSERT(*art_find(art, buf, len) == (void *)(uintptr_t)(i + 1));
+    }
+
+    /* a differing byte past the stored part of the prefix */
+    ASSERT(art_find(art, "/usr/share/libds/dXta/1/1", 25) == NULL);
+
+    struct visit v = { .ordered = 1 };
+    ASSERT(art_foreach_prefix(art, "", 0, visit_key, &v) == 0);
+    ASSERT(v.count == PATH_AMOUNT && v.ordered);
+
+    /* "/usr/share/libds/data/5/" holds i % 37 == 5 */
+    memset(&v, 0, sizeof(v));
+    v.ordered = 1;
+    ASSERT(art_foreach_prefix(art, "/usr/share/libds/data/5/", 24, visit_key,
+                              &v)
+           == 0);
+    ASSERT(v.count == (PATH_AMOUNT + 31) / 37 && v.ordered);
+
+    memset(&v, 0, sizeof(v));
+    ASSERT(art_foreach_prefix(art, "/usr/share/x", 12, visit_key, &v) == 0);
+    ASSERT(v.count == 0);
+
+    int calls = 0;
+    ASSERT(art_foreach_prefix(art, "/usr", 4, stop_after_two, &calls) == 7);
+
+    size_t len;
+    ASSERT(art_insert(art, "/usr/share", 10, buf) == 0);
+    ASSERT(*art_longest_prefix(art, "/usr/share/libds/d", 18, &len) == buf);
+    ASSERT(len == 10);
+
+    for (size_t i = 0; i < PATH_AMOUNT; i += 2)
+    {
+        size_t len = make_path(buf, i);
+        ASSERT(art_erase(art, buf, len) == 0);
+    }
+
+    for (size_t i = 0; i < PATH_AMOUNT; i++)
+    {
+        size_t len = make_path(buf, i);
+        ASSERT((art_find(art, buf, len) == NULL) == (i % 2 == 0));
+    }
+
+    ASSERT(art_size(art) == (PATH_AMOUNT / 2) + 1);
+
+    art_free(art);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_basic();
+    test_node_growth();
+    test_paths();
+
+    return 0;
+}
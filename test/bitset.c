@@ -0,0 +1,126 @@
+#include "ds/bitset.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+
+void
+test_single_bits(void)
+{
+    START
+
+    bitset_t bs = bitset_new(130);
+    ASSERT(bitset_size(bs) == 130 && bitset_count(bs) == 0);
+
+    bitset_set(bs, 0);
+    bitset_set(bs, 64);
+    bitset_set(bs, 129);
+    ASSERT(bitset_test(bs, 64) && !bitset_test(bs, 63));
+    ASSERT(bitset_count(bs) == 3);
+
+    bitset_clear(bs, 64);
+    bitset_flip(bs, 65);
+    ASSERT(!bitset_test(bs, 64) && bitset_test(bs, 65));
+
+    /* out-of-range operations should fail */
+    ASSERT(bitset_set(bs, 130) == -1 && errno == ERANGE);
+    errno = 0;
+    ASSERT(!bitset_test(bs, 200) && errno == ERANGE);
+
+    bitset_free(bs);
+    SUCCESS
+}
+
+
+void
+test_bulk(void)
+{
+    START
+
+    bitset_t a = bitset_new_with_allocator(200, xmalloc, xrealloc, NULL);
+    bitset_t b = bitset_new(200);
+    bitset_t c = bitset_new(100);
+
+    for (size_t i = 0; i < 200; i += 2) bitset_set(a, i);
+    for (size_t i = 0; i < 200; i += 3) bitset_set(b, i);
+
+    ASSERT(bitset_and(a, c) == -1 && errno == EINVAL);
+
+    /* the unused bits of the last word must not be counted */
+    bitset_set_all(c);
+    ASSERT(bitset_count(c) == 100);
+
+    ASSERT(bitset_and(a, b) == 0);
+    ASSERT(bitset_count(a) == 34);
+
+    bitset_or(a, b);
+    ASSERT(bitset_count(a) == 67);
+
+    bitset_xor(a, b);
+    ASSERT(bitset_count(a) == 0);
+
+    bitset_set_all(a);
+    bitset_andnot(a, b);
+    ASSERT(bitset_count(a) == 200 - 67);
+
+    bitset_free(a);
+    bitset_free(b);
+    bitset_free(c);
+    SUCCESS
+}
+
+
+void
+test_find(void)
+{
+    START
+
+    bitset_t bs = bitset_new(1000);
+    ASSERT(bitset_find_first(bs) == 1000);
+
+    size_t expected[] = { 3, 64, 65, 500, 999 };
+    for (size_t i = 0; i < 5; i++) bitset_set(bs, expected[i]);
+
+    ASSERT(bitset_find_first(bs) == 3);
+    ASSERT(bitset_find_next(bs, 4) == 64);
+    ASSERT(bitset_find_next(bs, 66) == 500);
+
+    size_t index, n = 0;
+    BITSET_FOREACH(bs, index)
+    {
+        ASSERT(index == expected[n]);
+        n++;
+    }
+    ASSERT(n == 5);
+
+    /* shrinking drops the bits past the new end */
+    bitset_resize(bs, 500);
+    ASSERT(bitset_count(bs) == 3);
+    bitset_resize(bs, 2000);
+    ASSERT(bitset_count(bs) == 3 && !bitset_test(bs, 999));
+
+    bitset_free(bs);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_single_bits();
+    test_bulk();
+    test_find();
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "ds/bloom.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define KEY_AMOUNT   10000
+#define QUERY_AMOUNT 100000
+
+
+void
+test_invalid(void)
+{
+    START
+
+    /* should fail */
+    ASSERT(bloom_new(100, 0) == NULL && errno == EINVAL);
+    ASSERT(bloom_new(100, 1) == NULL && errno == EINVAL);
+    ASSERT(bloom_new_with_allocator(100, 0.01, fail_malloc, NULL) == NULL);
+
+    bloom_t a = bloom_new(100, 0.01);
+    bloom_t b = bloom_new(100000, 0.01);
+    ASSERT(bloom_size(a) % 64 == 0 && bloom_size(a) < bloom_size(b));
+    ASSERT(bloom_merge(a, b) == -1 && errno == EINVAL);
+
+    bloom_free(a);
+    bloom_free(b);
+    SUCCESS
+}
+
+
+void
+test_membership(void)
+{
+    START
+
+    bloom_t bf = bloom_new_with_allocator(KEY_AMOUNT, 0.01, xmalloc, NULL);
+
+    for (uint32_t i = 0; i < KEY_AMOUNT; i++) bloom_insert(bf, &i, sizeof(i));
+
+    /* no false negatives */
+    for (uint32_t i = 0; i < KEY_AMOUNT; i++)
+        ASSERT(bloom_contains(bf, &i, sizeof(i)));
+
+    size_t false_positives = 0;
+    for (uint32_t i = KEY_AMOUNT; i < KEY_AMOUNT + QUERY_AMOUNT; i++)
+        false_positives += (size_t)bloom_contains(bf, &i, sizeof(i));
+
+    ASSERT(false_positives < QUERY_AMOUNT / 50);
+
+    bloom_clear(bf);
+    uint32_t key = 1;
+    ASSERT(!bloom_contains(bf, &key, sizeof(key)));
+
+    bloom_free(bf);
+    SUCCESS
+}
+
+
+void
+test_batch_merge(void)
+{
+    START
+
+    static uint64_t hashes[KEY_AMOUNT];
+    static unsigned char out[KEY_AMOUNT];
+
+    for (uint32_t i = 0; i < KEY_AMOUNT; i++)
+        hashes[i] = bloom_hash(&i, sizeof(i));
+
+    bloom_t even = bloom_new(KEY_AMOUNT, 0.001);
+    bloom_t odd  = bloom_new(KEY_AMOUNT, 0.001);
+
+    for (size_t i = 0; i < KEY_AMOUNT; i++)
+        bloom_insert_hash(i % 2 == 0 ? even : odd, hashes[i]);
+
+    ASSERT(bloom_contains_batch(even, hashes, KEY_AMOUNT, out)
+           < KEY_AMOUNT / 2 + KEY_AMOUNT / 100);
+    for (size_t i = 0; i < KEY_AMOUNT; i += 2) ASSERT(out[i] == 1);
+
+    ASSERT(bloom_merge(even, odd) == 0);
+    ASSERT(bloom_contains_batch(even, hashes, KEY_AMOUNT, out) == KEY_AMOUNT);
+
+    bloom_clear(odd);
+    bloom_insert_batch(odd, hashes, KEY_AMOUNT);
+    ASSERT(bloom_contains_batch(odd, hashes, KEY_AMOUNT, out) == KEY_AMOUNT);
+
+    bloom_free(even);
+    bloom_free(odd);
+    SUCCESS
+}
+
+
+void
+test_serialize(void)
+{
+    START
+
+    FILE *file = tmpfile();
+    ASSERT(file != NULL);
+
+    bloom_t bf = bloom_new(1000, 0.01);
+    for (uint32_t i = 0; i < 1000; i++) bloom_insert(bf, &i, sizeof(i));
+
+    ASSERT(bloom_write(bf, file) == 0);
+    rewind(file);
+
+    /* the header integers are little endian whatever the host */
+    unsigned char header[24];
+    ASSERT(fread(header, sizeof(header), 1, file) == 1);
+    ASSERT(header[8] == 1 && header[9] == 0 && header[12] == 64);
+    ASSERT(header[16] + ((size_t)header[17] << 8)
+           == bloom_size(bf) / 64);
+    rewind(file);
+
+    bloom_t copy = bloom_read(file, NULL, NULL);
+    ASSERT(copy != NULL && bloom_size(copy) == bloom_size(bf));
+    for (uint32_t i = 0; i < 1000; i++)
+        ASSERT(bloom_contains(copy, &i, sizeof(i)));
+
+    /* not a filter */
+    rewind(file);
+    fputs("garbage", file);
+    rewind(file);
+    ASSERT(bloom_read(file, NULL, NULL) == NULL && errno == EINVAL);
+
+    fclose(file);
+    bloom_free(bf);
+    bloom_free(copy);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_invalid();
+    test_membership();
+    test_batch_merge();
+    test_serialize();
+
+    return 0;
+}
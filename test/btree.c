@@ -0,0 +1,229 @@
+#include "ds/btree.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define KEY_AMOUNT 20000
+
+
+static int
+cmp_name(const void *a, const void *b)
+{
+    return strncmp(a, b, 16);
+}
+
+
+/* walks every key, checking the order and the values */
+static size_t
+check_order(btree_t bt)
+{
+    struct btree_iter it;
+    int64_t           prev  = INT64_MIN;
+    size_t            count = 0;
+
+    for (btree_seek(bt, NULL, &it); btree_iter_key(&it) != NULL;
+         btree_iter_next(&it))
+    {
+        int64_t key = *(int64_t *)btree_iter_key(&it);
+        if (key <= prev || *(int64_t *)btree_iter_value(&it) != key * 2)
+            return SIZE_MAX;
+
+        prev = key;
+        count++;
+    }
+
+    return count;
+}
+
+
+void
+test_invalid(void)
+{
+    START
+
+    /* should fail */
+    ASSERT(btree_new(0, 8, NULL) == NULL && errno == EINVAL);
+    ASSERT(btree_new(3, 8, NULL) == NULL && errno == EINVAL);
+    ASSERT(btree_new_with_allocator(8, 8, NULL, fail_malloc, NULL) == NULL);
+
+    btree_t bt = btree_new(16, 64, cmp_name);
+    ASSERT(bt != NULL && btree_node_size(bt) % 64 == 0);
+    ASSERT(btree_find(bt, "missing") == NULL);
+    ASSERT(btree_erase(bt, "missing") == -1 && errno == ENOENT);
+
+    btree_free(bt);
+    SUCCESS
+}
+
+
+void
+test_insert_erase(void)
+{
+    START
+
+    btree_t bt = btree_new_with_allocator(sizeof(int64_t), sizeof(int64_t),
+                                          NULL, xmalloc, NULL);
+
+    /* a permutation of 0..KEY_AMOUNT - 1 */
+    for (int64_t i = 0; i < KEY_AMOUNT; i++)
+    {
+        int64_t key = (i * 7919) % KEY_AMOUNT;
+        int64_t val = key * 2;
+        ASSERT(btree_insert(bt, &key, &val) == 0);
+    }
+
+    int64_t key = 42;
+    ASSERT(btree_insert(bt, &key, &key) == -1 && errno == EEXIST);
+    ASSERT(btree_size(bt) == KEY_AMOUNT && btree_height(bt) > 1);
+    ASSERT(check_order(bt) == KEY_AMOUNT);
+    ASSERT(*(int64_t *)btree_find(bt, &key) == 84);
+
+    /* erase every odd key */
+    for (int64_t i = 0; i < KEY_AMOUNT; i++)
+    {
+        key = (i * 7919) % KEY_AMOUNT;
+        if (key % 2 == 1) ASSERT(btree_erase(bt, &key) == 0);
+    }
+
+    ASSERT(btree_size(bt) == KEY_AMOUNT / 2);
+    ASSERT(check_order(bt) == KEY_AMOUNT / 2);
+
+    key = 43;
+    ASSERT(!btree_contains(bt, &key));
+    ASSERT(btree_erase(bt, &key) == -1 && errno == ENOENT);
+
+    /* range scan over [1000, 1100) */
+    struct btree_iter it;
+    size_t            count = 0;
+
+    key = 999;
+    for (btree_seek(bt, &key, &it); btree_iter_key(&it) != NULL;
+         btree_iter_next(&it))
+    {
+        if (*(int64_t *)btree_iter_key(&it) >= 1100) break;
+        count++;
+    }
+    ASSERT(count == 50);
+
+    for (key = 0; key < KEY_AMOUNT; key += 2)
+        ASSERT(btree_erase(bt, &key) == 0);
+
+    ASSERT(btree_size(bt) == 0 && btree_height(bt) == 0);
+    btree_seek(bt, NULL, &it);
+    ASSERT(btree_iter_key(&it) == NULL && !btree_iter_next(&it));
+
+    btree_free(bt);
+    SUCCESS
+}
+
+
+void
+test_bulk_load(void)
+{
+    START
+
+    darray_t keys   = darray_new(sizeof(int64_t));
+    darray_t values = darray_new(sizeof(int64_t));
+
+    for (int64_t i = 0; i < KEY_AMOUNT; i++)
+    {
+        int64_t key = i * 3;
+        int64_t val = key * 2;
+
+        darray_push_back(keys, &key);
+        darray_push_back(values, &val);
+    }
+
+    btree_t bt = btree_new(sizeof(int64_t), sizeof(int64_t), NULL);
+    ASSERT(btree_bulk_load(bt, keys, NULL) == -1 && errno == EINVAL);
+    ASSERT(btree_bulk_load(bt, keys, values) == 0);
+    ASSERT(btree_bulk_load(bt, keys, values) == -1 && errno == EINVAL);
+
+    ASSERT(btree_size(bt) == KEY_AMOUNT);
+    ASSERT(check_order(bt) == KEY_AMOUNT);
+
+    int64_t key = 300;
+    ASSERT(*(int64_t *)btree_find(bt, &key) == 600);
+
+    /* the tree stays valid when modified after loading */
+    for (key = 1; key < 3000; key += 3)
+    {
+        int64_t val = key * 2;
+        ASSERT(btree_insert(bt, &key, &val) == 0);
+    }
+    for (key = 0; key < KEY_AMOUNT * 3; key += 6)
+        ASSERT(btree_erase(bt, &key) == 0);
+
+    ASSERT(check_order(bt) == KEY_AMOUNT + 1000 - (KEY_AMOUNT / 2));
+
+    btree_free(bt);
+
+    /* unsorted keys */
+    bt  = btree_new(sizeof(int64_t), sizeof(int64_t), NULL);
+    key = -1;
+    darray_push_back(keys, &key);
+    darray_push_back(values, &key);
+    ASSERT(btree_bulk_load(bt, keys, values) == -1 && errno == EINVAL);
+
+    btree_free(bt);
+    darray_free_full(keys);
+    darray_free_full(values);
+    SUCCESS
+}
+
+
+void
+test_custom_keys(void)
+{
+    START
+
+    static const char *names[] = { "delta", "alpha", "echo", "charlie",
+                                   "bravo" };
+
+    btree_t bt = btree_new(16, 0, cmp_name);
+
+    for (size_t i = 0; i < 5; i++)
+    {
+        char key[16] = { 0 };
+        strncpy(key, names[i], sizeof(key) - 1);
+        ASSERT(btree_insert(bt, key, NULL) == 0);
+    }
+
+    struct btree_iter it;
+    btree_seek(bt, "b", &it);
+    ASSERT(strcmp(btree_iter_key(&it), "bravo") == 0);
+    ASSERT(btree_iter_next(&it));
+    ASSERT(strcmp(btree_iter_key(&it), "charlie") == 0);
+
+    ASSERT(btree_contains(bt, "echo\0\0\0\0\0\0\0\0\0\0\0"));
+    ASSERT(btree_erase(bt, "alpha\0\0\0\0\0\0\0\0\0\0") == 0);
+    ASSERT(btree_size(bt) == 4);
+
+    btree_free(bt);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_invalid();
+    test_insert_erase();
+    test_bulk_load();
+    test_custom_keys();
+
+    return 0;
+}
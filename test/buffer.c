@@ -0,0 +1,172 @@
+#include "ds/buffer.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unistd.h>
+
+#include "shared/xmalloc.h"
+
+
+static int fail_growth = 0;
+
+
+static void *
+failing_realloc(void *ptr, size_t size)
+{
+    if (fail_growth)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    return xrealloc(ptr, size);
+}
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+
+void
+test_spare_commit(void)
+{
+    START
+
+    buffer_t buf = buffer_new_with_allocator(xmalloc, xrealloc, NULL);
+    ASSERT(buffer_size(buf) == 0 && buffer_capacity(buf) == 0);
+
+    char *spare = buffer_spare(buf, 10);
+    ASSERT(spare != NULL && buffer_spare_size(buf) >= 10);
+
+    memcpy(spare, "hello worl", 10);
+    ASSERT(buffer_size(buf) == 0);
+    ASSERT(buffer_commit(buf, 10) == 0 && buffer_size(buf) == 10);
+    ASSERT(buffer_commit(buf, buffer_spare_size(buf) + 1) == -1
+           && errno == ERANGE);
+
+    ASSERT(buffer_append(buf, "d", 1) == 0);
+    ASSERT(memcmp(buffer_data(buf), "hello world", 11) == 0);
+
+    /* consuming only moves the read offset */
+    char *data = buffer_data(buf);
+    ASSERT(buffer_consume(buf, 6) == 0);
+    ASSERT((char *)buffer_data(buf) == data + 6);
+    ASSERT(memcmp(buffer_data(buf), "world", 5) == 0);
+    ASSERT(buffer_consume(buf, 6) == -1 && errno == ERANGE);
+
+    /* consumed bytes are reclaimed before growing */
+    size_t capacity = buffer_capacity(buf);
+    ASSERT(buffer_spare(buf, capacity - 5) != NULL);
+    ASSERT(buffer_capacity(buf) == capacity);
+    ASSERT(memcmp(buffer_data(buf), "world", 5) == 0);
+
+    ASSERT(buffer_spare(buf, capacity * 4) != NULL);
+    ASSERT(buffer_capacity(buf) >= capacity * 4 + 5);
+    ASSERT(memcmp(buffer_data(buf), "world", 5) == 0);
+
+    ASSERT(buffer_consume(buf, 5) == 0 && buffer_size(buf) == 0);
+
+    buffer_free(buf);
+    SUCCESS
+}
+
+
+void
+test_fd(void)
+{
+    START
+
+    int fds[2];
+    ASSERT(pipe(fds) == 0);
+
+    buffer_t head = buffer_new();
+    buffer_t body = buffer_new();
+    buffer_t in   = buffer_new();
+
+    char payload[200];
+    memset(payload, 'x', sizeof(payload));
+
+    ASSERT(buffer_append(head, "POST / ", 7) == 0);
+    ASSERT(buffer_append(body, payload, sizeof(payload)) == 0);
+
+    buffer_t out[] = { head, body };
+    ASSERT(buffer_writev_fd(out, 2, fds[1]) == 207);
+    ASSERT(buffer_size(head) == 0 && buffer_size(body) == 0);
+
+    /* more is read than the 4 bytes asked for */
+    ASSERT(buffer_readv_fd(in, fds[0], 4) == 207);
+    ASSERT(buffer_size(in) == 207 && buffer_capacity(in) >= 207);
+    ASSERT(memcmp(buffer_data(in), "POST / ", 7) == 0);
+    ASSERT(memcmp((char *)buffer_data(in) + 7, payload, 200) == 0);
+
+    close(fds[1]);
+    ASSERT(buffer_readv_fd(in, fds[0], 0) == 0);
+    close(fds[0]);
+
+    buffer_free(head);
+    buffer_free(body);
+    buffer_free(in);
+    SUCCESS
+}
+
+
+void
+test_alloc_failure(void)
+{
+    START
+
+    buffer_t buf = buffer_new_with_allocator(fail_malloc, NULL, NULL);
+    ASSERT(buf == NULL);
+
+    int fds[2];
+    ASSERT(pipe(fds) == 0);
+
+    char payload[300];
+    for (size_t i = 0; i < sizeof(payload); i++) payload[i] = (char)i;
+    ASSERT(write(fds[1], payload, sizeof(payload)) == sizeof(payload));
+
+    buf = buffer_new_with_allocator(xmalloc, failing_realloc, NULL);
+    ASSERT(buffer_append(buf, payload, 10) == 0);
+    ASSERT(buffer_consume(buf, 10) == 0);
+
+    /* the read overflows the spare capacity, which can not grow */
+    fail_growth = 1;
+    ssize_t res = buffer_readv_fd(buf, fds[0], 1);
+    ASSERT(res > 0 && (size_t)res == buffer_capacity(buf));
+    ASSERT(buffer_size(buf) == (size_t)res);
+    ASSERT(buffer_readv_fd(buf, fds[0], buffer_capacity(buf)) == -1
+           && errno == ENOMEM);
+
+    /* a full buffer that can not grow is not at the end of file */
+    errno = 0;
+    ASSERT(buffer_readv_fd(buf, fds[0], 0) == -1 && errno == ENOMEM);
+
+    /* nothing taken off the pipe was lost */
+    fail_growth = 0;
+    while (buffer_size(buf) < sizeof(payload))
+        ASSERT(buffer_readv_fd(buf, fds[0], 1) > 0);
+    ASSERT(memcmp(buffer_data(buf), payload, sizeof(payload)) == 0);
+
+    close(fds[0]);
+    close(fds[1]);
+    buffer_free(buf);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_spare_commit();
+    test_fd();
+    test_alloc_failure();
+
+    return 0;
+}
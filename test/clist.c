@@ -0,0 +1,216 @@
+#include "ds/clist.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <pthread.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define KEY(i)       ((void *)(uintptr_t)(i))
+#define THREADS      4
+#define PER_THREAD   2000
+#define LISTS        2048
+
+
+static long live_allocations = 0;
+static int  fail_records     = 0;
+
+
+static void *
+counting_malloc(size_t size)
+{
+    __atomic_fetch_add(&live_allocations, 1, __ATOMIC_RELAXED);
+    return xmalloc(size);
+}
+
+
+static void
+counting_free(void *ptr)
+{
+    __atomic_fetch_sub(&live_allocations, 1, __ATOMIC_RELAXED);
+    free(ptr);
+}
+
+
+static void *
+record_malloc(size_t size)
+{
+    if (fail_records)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    return counting_malloc(size);
+}
+
+
+void
+test_basic(void)
+{
+    START
+
+    clist_t cl = clist_new(NULL);
+    int     a = 1, b = 2;
+
+    ASSERT(clist_insert(cl, KEY(20), &b) == 0);
+    ASSERT(clist_insert(cl, KEY(10), &a) == 0);
+    ASSERT(clist_size(cl) == 2);
+
+    /* duplicate keys are rejected */
+    ASSERT(clist_insert(cl, KEY(10), &b) == -1 && errno == EEXIST);
+
+    ASSERT(clist_find(cl, KEY(10)) == &a);
+    ASSERT(clist_find(cl, KEY(20)) == &b);
+    ASSERT(clist_find(cl, KEY(30)) == NULL && errno == ENOENT);
+    ASSERT(clist_contains(cl, KEY(20)));
+
+    ASSERT(clist_remove(cl, KEY(10)) == 0);
+    ASSERT(!clist_contains(cl, KEY(10)));
+    ASSERT(clist_remove(cl, KEY(10)) == -1 && errno == ENOENT);
+    ASSERT(clist_size(cl) == 1);
+
+    clist_free(cl);
+    SUCCESS
+}
+
+
+static void *
+worker(void *arg)
+{
+    clist_t   cl    = ((void **)arg)[0];
+    uintptr_t first = (uintptr_t)((void **)arg)[1];
+
+    for (uintptr_t i = first; i < first + PER_THREAD; i++)
+        if (clist_insert(cl, KEY(i), KEY(i)) != 0) return arg;
+
+    /* remove every odd key while the other threads still insert */
+    for (uintptr_t i = first + 1; i < first + PER_THREAD; i += 2)
+        if (clist_remove(cl, KEY(i)) != 0) return arg;
+
+    for (uintptr_t i = first; i < first + PER_THREAD; i++)
+        if (clist_contains(cl, KEY(i)) != (i % 2 == 0)) return arg;
+
+    return NULL;
+}
+
+
+void
+test_concurrent(void)
+{
+    START
+
+    clist_t cl
+        = clist_new_with_allocator(NULL, counting_malloc, counting_free);
+
+    pthread_t threads[THREADS];
+    void     *args[THREADS][2];
+
+    for (uintptr_t i = 0; i < THREADS; i++)
+    {
+        args[i][0] = cl;
+        args[i][1] = KEY(i * PER_THREAD);
+        ASSERT(pthread_create(&threads[i], NULL, worker, args[i]) == 0);
+    }
+
+    for (int i = 0; i < THREADS; i++)
+    {
+        void *res;
+        pthread_join(threads[i], &res);
+        ASSERT(res == NULL);
+    }
+
+    ASSERT(clist_size(cl) == THREADS * PER_THREAD / 2);
+
+    /* every node, retired or not, goes back through the free function */
+    clist_free(cl);
+    ASSERT(live_allocations == 0);
+    SUCCESS
+}
+
+
+void
+test_many(void)
+{
+    START
+
+    static clist_t lists[LISTS];
+
+    /* more live lists than a process has thread-specific keys */
+    for (uintptr_t i = 0; i < LISTS; i++)
+    {
+        lists[i] = clist_new_with_allocator(NULL, counting_malloc,
+                                            counting_free);
+        ASSERT(lists[i] != NULL);
+        ASSERT(clist_insert(lists[i], KEY(i), KEY(i)) == 0);
+    }
+
+    for (uintptr_t i = 0; i < LISTS; i++)
+    {
+        ASSERT(clist_find(lists[i], KEY(i)) == KEY(i));
+        clist_free(lists[i]);
+    }
+
+    ASSERT(live_allocations == 0);
+    SUCCESS
+}
+
+
+void
+test_retire_without_record(void)
+{
+    START
+
+    epoch_t ep = epoch_new_with_allocator(record_malloc, counting_free);
+    ASSERT(ep != NULL);
+
+    /* the thread gets no record, its retirements must still be kept */
+    fail_records = 1;
+    ASSERT(epoch_enter(ep) == -1 && errno == ENOMEM);
+
+    for (int i = 0; i < 100; i++)
+    {
+        struct epoch_node *node = counting_malloc(sizeof(*node));
+        epoch_retire(ep, node, node);
+    }
+
+    ASSERT(live_allocations == 101);
+
+    /* and are reclaimed once the epoch has moved on */
+    fail_records = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        ASSERT(epoch_enter(ep) == 0);
+        epoch_leave(ep);
+        epoch_collect(ep);
+    }
+
+    ASSERT(live_allocations == 2);
+
+    epoch_free(ep);
+    ASSERT(live_allocations == 0);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_basic();
+    test_concurrent();
+    test_many();
+    test_retire_without_record();
+
+    return 0;
+}
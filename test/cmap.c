@@ -0,0 +1,255 @@
+#include "ds/cmap.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <pthread.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define THREADS    4
+#define PER_THREAD 20000
+#define SHARED     64
+#define ROUNDS     20000
+#define MAPS       2048
+
+
+/* both halves are always written together, a torn read breaks the pair */
+struct pair
+{
+    uint64_t value;
+    uint64_t check;
+};
+
+
+static long live_allocations = 0;
+
+
+static void *
+counting_malloc(size_t size)
+{
+    __atomic_fetch_add(&live_allocations, 1, __ATOMIC_RELAXED);
+    return xmalloc(size);
+}
+
+
+static void
+counting_free(void *ptr)
+{
+    __atomic_fetch_sub(&live_allocations, 1, __ATOMIC_RELAXED);
+    free(ptr);
+}
+
+
+void
+test_basic(void)
+{
+    START
+
+    cmap_t   map = cmap_new(sizeof(uint32_t), sizeof(uint64_t));
+    uint32_t key = 7;
+    uint64_t value = 70, out = 0;
+
+    ASSERT(cmap_new(0, 8) == NULL && errno == EINVAL);
+
+    ASSERT(cmap_insert(map, &key, &value) == 0);
+    ASSERT(cmap_insert(map, &key, &value) == -1 && errno == EEXIST);
+    ASSERT(cmap_get(map, &key, &out) == 0 && out == 70);
+    ASSERT(cmap_size(map) == 1);
+
+    /* put replaces, a `NULL` value is zeroed */
+    value = 71;
+    ASSERT(cmap_put(map, &key, &value) == 0);
+    ASSERT(cmap_get(map, &key, &out) == 0 && out == 71);
+    ASSERT(cmap_put(map, &key, NULL) == 0);
+    ASSERT(cmap_get(map, &key, &out) == 0 && out == 0);
+    ASSERT(cmap_size(map) == 1);
+
+    key = 8;
+    ASSERT(cmap_get(map, &key, &out) == -1 && errno == ENOENT);
+    ASSERT(!cmap_contains(map, &key));
+    ASSERT(cmap_erase(map, &key) == -1 && errno == ENOENT);
+
+    key = 7;
+    ASSERT(cmap_contains(map, &key));
+    ASSERT(cmap_get(map, &key, NULL) == 0);
+    ASSERT(cmap_erase(map, &key) == 0);
+    ASSERT(!cmap_contains(map, &key));
+    ASSERT(cmap_size(map) == 0);
+
+    cmap_free(map);
+    SUCCESS
+}
+
+
+void
+test_grow(void)
+{
+    START
+
+    cmap_t map = cmap_new_with_allocator(sizeof(uint64_t), sizeof(uint64_t),
+                                         counting_malloc, counting_free);
+
+    /* enough keys to double the table several times over */
+    for (uint64_t i = 0; i < 100000; i++)
+    {
+        uint64_t value = i * 3;
+        ASSERT(cmap_insert(map, &i, &value) == 0);
+    }
+
+    ASSERT(cmap_size(map) == 100000);
+
+    for (uint64_t i = 0; i < 100000; i += 2) ASSERT(cmap_erase(map, &i) == 0);
+
+    for (uint64_t i = 0; i < 100000; i++)
+    {
+        uint64_t out   = 0;
+        int      found = cmap_get(map, &i, &out) == 0;
+
+        ASSERT(found == (i % 2 == 1));
+        ASSERT(!found || out == i * 3);
+    }
+
+    ASSERT(cmap_size(map) == 50000);
+
+    cmap_free(map);
+    ASSERT(live_allocations == 0);
+    SUCCESS
+}
+
+
+static void *
+writer(void *arg)
+{
+    cmap_t   map   = ((void **)arg)[0];
+    uint64_t first = (uint64_t)(uintptr_t)((void **)arg)[1];
+
+    /* disjoint keys keep the table growing under the readers */
+    for (uint64_t i = first; i < first + PER_THREAD; i++)
+    {
+        struct pair pair = { i, ~i };
+        if (cmap_insert(map, &i, &pair) != 0) return arg;
+
+        uint64_t    shared = i % SHARED;
+        struct pair update = { i, ~i };
+        if (cmap_put(map, &shared, &update) != 0) return arg;
+    }
+
+    for (uint64_t i = first; i < first + PER_THREAD; i += 2)
+        if (cmap_erase(map, &i) != 0) return arg;
+
+    return NULL;
+}
+
+
+static void *
+reader(void *arg)
+{
+    cmap_t map = ((void **)arg)[0];
+
+    for (uint64_t round = 0; round < ROUNDS; round++)
+    {
+        uint64_t    key = round % SHARED;
+        struct pair pair;
+
+        if (cmap_get(map, &key, &pair) != 0 || pair.check != ~pair.value)
+            return arg;
+    }
+
+    return NULL;
+}
+
+
+void
+test_concurrent(void)
+{
+    START
+
+    cmap_t map = cmap_new_with_allocator(sizeof(uint64_t), sizeof(struct pair),
+                                         counting_malloc, counting_free);
+
+    for (uint64_t i = 0; i < SHARED; i++)
+    {
+        struct pair pair = { i, ~i };
+        ASSERT(cmap_insert(map, &i, &pair) == 0);
+    }
+
+    pthread_t threads[THREADS * 2];
+    void     *args[THREADS][2];
+
+    for (uintptr_t i = 0; i < THREADS; i++)
+    {
+        args[i][0] = map;
+        args[i][1] = (void *)(SHARED + (i * PER_THREAD));
+        ASSERT(pthread_create(&threads[i], NULL, writer, args[i]) == 0);
+        ASSERT(pthread_create(&threads[THREADS + i], NULL, reader, args[i])
+               == 0);
+    }
+
+    for (int i = 0; i < THREADS * 2; i++)
+    {
+        void *res;
+        pthread_join(threads[i], &res);
+        ASSERT(res == NULL);
+    }
+
+    ASSERT(cmap_size(map) == SHARED + (THREADS * PER_THREAD / 2));
+
+    for (uint64_t i = SHARED; i < SHARED + (THREADS * PER_THREAD); i++)
+        ASSERT(cmap_contains(map, &i) == (i % 2 == 1));
+
+    /* every node and table, retired or not, goes back through the free */
+    cmap_free(map);
+    ASSERT(live_allocations == 0);
+    SUCCESS
+}
+
+
+void
+test_many(void)
+{
+    START
+
+    static cmap_t maps[MAPS];
+
+    /* more live maps than a process has thread-specific keys */
+    for (uint64_t i = 0; i < MAPS; i++)
+    {
+        maps[i] = cmap_new_with_allocator(sizeof(uint64_t), sizeof(uint64_t),
+                                          counting_malloc, counting_free);
+        ASSERT(maps[i] != NULL);
+        ASSERT(cmap_insert(maps[i], &i, &i) == 0);
+    }
+
+    for (uint64_t i = 0; i < MAPS; i++)
+    {
+        uint64_t out = 0;
+        ASSERT(cmap_get(maps[i], &i, &out) == 0 && out == i);
+        cmap_free(maps[i]);
+    }
+
+    ASSERT(live_allocations == 0);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_basic();
+    test_grow();
+    test_concurrent();
+    test_many();
+
+    return 0;
+}
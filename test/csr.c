@@ -0,0 +1,184 @@
+#include "ds/csr.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+/* enough edges for 4 chunks of at least 1 << 16 */
+#define VERTEX_AMOUNT 1000
+#define EDGE_AMOUNT   300000
+
+
+static darray_t
+make_edges(size_t amount, darray_t payloads)
+{
+    darray_t        da   = darray_new(sizeof(struct csr_edge));
+    uint64_t        seed = 12345;
+    struct csr_edge edge;
+
+    for (size_t i = 0; i < amount; i++)
+    {
+        seed      = (seed * 6364136223846793005ULL) + 1442695040888963407ULL;
+        edge.from = (uint32_t)((seed >> 33) % VERTEX_AMOUNT);
+        edge.to   = (uint32_t)((seed >> 13) % VERTEX_AMOUNT);
+        darray_push_back(da, &edge);
+
+        /* the payload is the index of the edge inside the list */
+        uint64_t index = i;
+        if (payloads != NULL) darray_push_back(payloads, &index);
+    }
+
+    return da;
+}
+
+
+void
+test_invalid(void)
+{
+    START
+
+    darray_t        edges = darray_new(sizeof(struct csr_edge));
+    struct csr_edge edge  = { 0, 3 };
+    darray_push_back(edges, &edge);
+
+    ASSERT(csr_new(3, edges, NULL) == NULL && errno == ERANGE);
+
+    darray_t payloads = darray_new(sizeof(int));
+    ASSERT(csr_new(4, edges, payloads) == NULL && errno == EINVAL);
+
+    darray_t wrong = darray_new(sizeof(uint32_t));
+    ASSERT(csr_new(4, wrong, NULL) == NULL && errno == EINVAL);
+
+    csr_t g = csr_new(4, edges, NULL);
+    ASSERT(g != NULL && csr_edge_amount(g) == 1);
+    ASSERT(csr_neighbors(g, 4, NULL) == NULL && errno == ERANGE);
+    ASSERT(csr_degree(g, 4) == 0 && csr_payloads(g, 0) == NULL);
+
+    uint32_t distances[4];
+    ASSERT(csr_bfs(g, 4, distances, NULL) == 0 && errno == ERANGE);
+    csr_free(g);
+
+    darray_clear(edges);
+    g = csr_new(2, edges, NULL);
+    ASSERT(g != NULL && csr_degree(g, 1) == 0);
+    csr_free(g);
+
+    darray_free_full(edges);
+    darray_free_full(payloads);
+    darray_free_full(wrong);
+    SUCCESS
+}
+
+
+void
+test_build(void)
+{
+    START
+
+    for (size_t threads = 1; threads <= 4; threads += 3)
+    {
+        csr_set_threads(threads);
+
+        darray_t payloads = darray_new(sizeof(uint64_t));
+        darray_t edges    = make_edges(EDGE_AMOUNT, payloads);
+        csr_t    g        = csr_new(VERTEX_AMOUNT, edges, payloads);
+
+        ASSERT(g != NULL && csr_vertex_amount(g) == VERTEX_AMOUNT);
+        ASSERT(csr_edge_amount(g) == EDGE_AMOUNT);
+
+        const struct csr_edge *list  = darray_data(edges);
+        size_t                 total = 0;
+
+        for (uint32_t v = 0; v < VERTEX_AMOUNT; v++)
+        {
+            size_t          amount;
+            const uint32_t *targets = csr_neighbors(g, v, &amount);
+            const uint64_t *index   = csr_payloads(g, v);
+
+            ASSERT(amount == csr_degree(g, v));
+
+            /* every edge of the vertex, in the order of the list */
+            for (size_t i = 0; i < amount; i++)
+            {
+                ASSERT(list[index[i]].from == v);
+                ASSERT(list[index[i]].to == targets[i]);
+                if (i > 0) ASSERT(index[i - 1] < index[i]);
+            }
+
+            size_t          visited = 0;
+            const uint32_t *it;
+            CSR_FOREACH(g, v, it) ASSERT(*it == targets[visited++]);
+            ASSERT(visited == amount);
+
+            total += amount;
+        }
+
+        ASSERT(total == EDGE_AMOUNT);
+
+        csr_free(g);
+        darray_free_full(edges);
+        darray_free_full(payloads);
+    }
+
+    csr_set_threads(1);
+    SUCCESS
+}
+
+
+void
+test_traversal(void)
+{
+    START
+
+    /* 0 -> 1 -> 2 -> 3, 0 -> 2, 4 -> 0, and 5 on its own */
+    static struct csr_edge list[] = {
+        { 1, 2 }, { 0, 1 }, { 2, 3 }, { 0, 2 }, { 4, 0 }, { 2, 3 },
+    };
+
+    darray_t edges = darray_new(sizeof(struct csr_edge));
+    for (size_t i = 0; i < sizeof(list) / sizeof(list[0]); i++)
+        darray_push_back(edges, &list[i]);
+
+    csr_t g = csr_new(6, edges, NULL);
+
+    uint32_t distances[6], order[6];
+    ASSERT(csr_bfs(g, 0, distances, order) == 4);
+    ASSERT(distances[0] == 0 && distances[1] == 1 && distances[2] == 1);
+    ASSERT(distances[3] == 2 && distances[4] == CSR_UNREACHED);
+    ASSERT(distances[5] == CSR_UNREACHED);
+    ASSERT(order[0] == 0 && order[1] == 1 && order[2] == 2 && order[3] == 3);
+
+    ASSERT(csr_bfs(g, 4, distances, NULL) == 5 && distances[3] == 3);
+
+    size_t degrees[6];
+    csr_in_degrees(g, degrees);
+    ASSERT(degrees[0] == 1 && degrees[2] == 2 && degrees[3] == 2);
+    ASSERT(degrees[4] == 0 && degrees[5] == 0);
+    ASSERT(csr_degree(g, 2) == 2 && csr_degree(g, 5) == 0);
+
+    csr_free(g);
+    darray_free_full(edges);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_invalid();
+    test_build();
+    test_traversal();
+
+    return 0;
+}
@@ -5,8 +5,46 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <pthread.h>
+
 #include "shared/xmalloc.h"
 
+
+static long live_bytes   = 0;
+static int  stop_readers = 0;
+
+
+/* every block starts with its size, so a free knows what it gives back */
+static void *
+counting_realloc(void *ptr, size_t size)
+{
+    size_t *block = ptr == NULL ? NULL : (size_t *)ptr - 2;
+    long    old   = block == NULL ? 0 : (long)block[0];
+
+    block    = xrealloc(block, size + (2 * sizeof(size_t)));
+    block[0] = size;
+
+    __atomic_fetch_add(&live_bytes, (long)size - old, __ATOMIC_RELAXED);
+    return block + 2;
+}
+
+
+static void *
+counting_malloc(size_t size)
+{
+    return counting_realloc(NULL, size);
+}
+
+
+static void
+counting_free(void *ptr)
+{
+    size_t *block = (size_t *)ptr - 2;
+
+    __atomic_fetch_sub(&live_bytes, (long)block[0], __ATOMIC_RELAXED);
+    free(block);
+}
+
 #define SUCCESS fprintf(stderr, "successful\n");
 #define FAILED \
    { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
@@ -210,6 +248,311 @@ test_string_pointers(void)
 }
 
 
+void
+test_snapshot(void)
+{
+    START
+
+    darray_t da = darray_new(sizeof(int));
+    for (int i = 0; i < 4; i++) darray_push_back(da, &i);
+
+    darray_snapshot_t snap = darray_snapshot(da);
+    ASSERT(darray_snapshot_size(snap) == 4);
+    ASSERT(darray_snapshot_data(snap) == darray_data(da));
+
+    /* appending into spare capacity leaves the buffer shared */
+    int val = 4;
+    darray_push_back(da, &val);
+    ASSERT(darray_snapshot_data(snap) == darray_data(da));
+
+    /* writing to a visible element copies it */
+    darray_erase(da, 0);
+    ASSERT(darray_snapshot_data(snap) != darray_data(da));
+    ASSERT(*(const int *)darray_snapshot_at(snap, 0) == 0);
+    ASSERT(*(int *)darray_at(da, 0) == 1);
+    ASSERT(darray_snapshot_at(snap, 4) == NULL && errno == ERANGE);
+
+    /* without live snapshots, the writer takes the buffer back */
+    darray_snapshot_t snap2 = darray_snapshot(da);
+    darray_snapshot_release(snap2);
+
+    void *data = darray_data(da);
+    darray_erase(da, 0);
+    ASSERT(darray_data(da) == data);
+
+    /* snapshots outlive the array */
+    darray_snapshot_t snap3 = darray_snapshot(da);
+    darray_free_full(da);
+    ASSERT(darray_snapshot_size(snap3) == 3);
+    ASSERT(*(const int *)darray_snapshot_at(snap3, 2) == 4);
+
+    darray_snapshot_release(snap3);
+    darray_snapshot_release(snap);
+    SUCCESS
+}
+
+
+static void *
+snapshot_reader(void *arg)
+{
+    darray_t da = arg;
+
+    for (int i = 0; i < 10000; i++)
+    {
+        darray_snapshot_t snap = darray_acquire(da);
+        if (snap == NULL) continue;
+
+        /* every published view is a prefix of 0, 1, 2, ... */
+        const int *data = darray_snapshot_data(snap);
+        for (size_t j = 0; j < darray_snapshot_size(snap); j++)
+            if (data[j] != (int)j) return arg;
+
+        darray_snapshot_release(snap);
+    }
+
+    return NULL;
+}
+
+
+void
+test_publish(void)
+{
+    START
+
+    darray_t da = darray_new_with_allocator(sizeof(int), xmalloc, xrealloc,
+                                            NULL);
+    ASSERT(darray_acquire(da) == NULL && errno == ENOENT);
+
+    pthread_t readers[4];
+    for (int i = 0; i < 4; i++)
+        pthread_create(&readers[i], NULL, snapshot_reader, da);
+
+    for (int i = 0; i < 5000; i++)
+    {
+        darray_push_back(da, &i);
+        ASSERT(darray_publish(da) == 0);
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        void *res;
+        pthread_join(readers[i], &res);
+        ASSERT(res == NULL);
+    }
+
+    darray_free_full(da);
+    SUCCESS
+}
+
+
+static void *
+steady_reader(void *arg)
+{
+    darray_t da = arg;
+
+    while (!__atomic_load_n(&stop_readers, __ATOMIC_RELAXED))
+    {
+        darray_snapshot_t snap = darray_acquire(da);
+        if (snap != NULL) darray_snapshot_release(snap);
+    }
+
+    return NULL;
+}
+
+
+void
+test_publish_reclaim(void)
+{
+    START
+
+    darray_t da = darray_new_with_allocator(sizeof(int), counting_malloc,
+                                            counting_realloc, counting_free);
+
+    pthread_t readers[4];
+    for (int i = 0; i < 4; i++)
+        pthread_create(&readers[i], NULL, steady_reader, da);
+
+    /* readers are always acquiring, replaced snapshots must still go */
+    long peak = 0;
+    for (int i = 0; i < 20000; i++)
+    {
+        darray_push_back(da, &i);
+        ASSERT(darray_publish(da) == 0);
+
+        long live = __atomic_load_n(&live_bytes, __ATOMIC_RELAXED);
+        if (live > peak) peak = live;
+    }
+
+    __atomic_store_n(&stop_readers, 1, __ATOMIC_RELAXED);
+    for (int i = 0; i < 4; i++) pthread_join(readers[i], NULL);
+
+    /* a copy per reader and a few more, never one per publish */
+    ASSERT(peak < (long)(64 * 20000 * sizeof(int)));
+
+    darray_free_full(da);
+    ASSERT(live_bytes == 0);
+    SUCCESS
+}
+
+
+/* checks the scans against a plain loop, over every element size path */
+void
+test_find(void)
+{
+    START
+
+    static const size_t widths[] = { 1, 2, 3, 4, 8, 16 };
+
+    for (size_t w = 0; w < sizeof(widths) / sizeof(*widths); w++)
+    {
+        const size_t width = widths[w];
+
+        for (size_t n = 0; n < 300; n += (n < 70 ? 1 : 37))
+        {
+            darray_t da = darray_new(width);
+
+            /* every 7th element is the key, the others differ in one byte */
+            unsigned char elem[16];
+            unsigned char key[16];
+            memset(key, 0xab, width);
+
+            for (size_t i = 0; i < n; i++)
+            {
+                memcpy(elem, key, width);
+                if (i % 7 != 3) elem[(i % width)] ^= (unsigned char)(1 + i);
+                darray_push_back(da, elem);
+            }
+
+            size_t first = n, last = n, count = 0;
+            for (size_t i = 0; i < n; i++)
+                if (memcmp(darray_at(da, i), key, width) == 0)
+                {
+                    if (first == n) first = i;
+                    last = i;
+                    count++;
+                }
+
+            unsigned char *found = darray_find(da, key);
+            ASSERT(first == n ? found == NULL
+                              : found == darray_at(da, first));
+
+            found = darray_find_last(da, key);
+            ASSERT(last == n ? found == NULL : found == darray_at(da, last));
+
+            ASSERT(darray_count(da, key) == count);
+
+            darray_free_full(da);
+        }
+    }
+
+    SUCCESS
+}
+
+
+void
+test_gather_scatter(void)
+{
+    START
+
+    static const size_t widths[] = { 1, 2, 3, 4, 8, 16 };
+
+    for (size_t w = 0; w < sizeof(widths) / sizeof(*widths); w++)
+    {
+        const size_t width = widths[w];
+        darray_t     src   = darray_new(width);
+        darray_t     dst   = darray_new(width);
+        size_t       indices[500];
+
+        /* every byte of an element holds its index, truncated */
+        unsigned char elem[16];
+        for (size_t i = 0; i < 1000; i++)
+        {
+            memset(elem, (int)i, width);
+            darray_push_back(src, elem);
+        }
+
+        for (size_t i = 0; i < 500; i++) indices[i] = (i * 7919) % 1000;
+
+        for (size_t distance = 0; distance <= 64; distance += 32)
+        {
+            darray_set_prefetch_distance(distance);
+
+            ASSERT(darray_gather(dst, src, indices, 500) == 0);
+            ASSERT(darray_size(dst) == 500);
+            for (size_t i = 0; i < 500; i++)
+                ASSERT(memcmp(darray_at(dst, i), darray_at(src, indices[i]),
+                              width)
+                       == 0);
+        }
+
+        /* scattering the gathered elements back leaves the source as is */
+        ASSERT(darray_scatter(src, indices, dst, 500) == 0);
+        for (size_t i = 0; i < 1000; i++)
+        {
+            memset(elem, (int)i, width);
+            ASSERT(memcmp(darray_at(src, i), elem, width) == 0);
+        }
+
+        memset(elem, 0xee, width);
+        for (size_t i = 0; i < 500; i++) memcpy(darray_at(dst, i), elem, width);
+        ASSERT(darray_scatter(src, indices, dst, 500) == 0);
+        for (size_t i = 0; i < 500; i++)
+            ASSERT(memcmp(darray_at(src, indices[i]), elem, width) == 0);
+
+        darray_free_full(src);
+        darray_free_full(dst);
+    }
+
+    darray_set_prefetch_distance(16);
+    ASSERT(darray_prefetch_distance() == 16);
+
+    darray_t src     = darray_new(sizeof(int));
+    darray_t dst     = darray_new(sizeof(int));
+    darray_t other   = darray_new(sizeof(char));
+    size_t   index   = 3;
+    int      value   = 5;
+    darray_push_back(src, &value);
+
+    ASSERT(darray_gather(dst, src, &index, 1) == -1 && errno == ERANGE);
+    ASSERT(darray_size(dst) == 0);
+    ASSERT(darray_gather(other, src, &index, 1) == -1 && errno == EINVAL);
+    ASSERT(darray_gather(src, src, &index, 1) == -1 && errno == EINVAL);
+    ASSERT(darray_scatter(dst, &index, src, 2) == -1 && errno == ERANGE);
+    ASSERT(darray_scatter(dst, &index, src, 1) == -1 && errno == ERANGE);
+
+    /* a gather into an array with a live snapshot does not change it */
+    index = 0;
+    darray_push_back(dst, &value);
+    darray_snapshot_t snap = darray_snapshot(dst);
+    value = 9;
+    darray_push_back(src, &value);
+    index = 1;
+    ASSERT(darray_gather(dst, src, &index, 1) == 0);
+    ASSERT(*(int *)darray_at(dst, 0) == 9);
+    ASSERT(*(const int *)darray_snapshot_at(snap, 0) == 5);
+    darray_snapshot_release(snap);
+
+    /* an empty array with a snapshot has no elements to copy when growing */
+    darray_t empty = darray_new(sizeof(int));
+    snap           = darray_snapshot(empty);
+    ASSERT(darray_gather(empty, src, &index, 1) == 0);
+    ASSERT(*(int *)darray_at(empty, 0) == 9);
+    ASSERT(darray_snapshot_size(snap) == 0);
+    darray_snapshot_release(snap);
+
+    snap = darray_snapshot(empty);
+    darray_clear(empty);
+    ASSERT(darray_gather(empty, src, &index, 1) == 0);
+    darray_snapshot_release(snap);
+    darray_free_full(empty);
+
+    darray_free_full(src);
+    darray_free_full(dst);
+    darray_free_full(other);
+    SUCCESS
+}
+
+
 int
 main(void)
 {
@@ -219,6 +562,11 @@ main(void)
     test_error_handling();
     test_data_types();
     test_string_pointers();
+    test_snapshot();
+    test_publish();
+    test_publish_reclaim();
+    test_find();
+    test_gather_scatter();
 
     return 0;
 }
@@ -0,0 +1,140 @@
+#include "ds/fenwick.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define ELEM_AMOUNT 300
+
+
+void
+test_invalid(void)
+{
+    START
+
+    fenwick_t ft = fenwick_new(10, FENWICK_I64);
+    int64_t   sum;
+    double    fsum;
+
+    ASSERT(fenwick_add_i64(ft, 10, 1) == -1 && errno == ERANGE);
+    ASSERT(fenwick_set_i64(ft, SIZE_MAX, 1) == -1 && errno == ERANGE);
+    ASSERT(fenwick_sum_i64(ft, 5, 4, &sum) == -1 && errno == ERANGE);
+    ASSERT(fenwick_sum_i64(ft, 0, 11, &sum) == -1 && errno == ERANGE);
+    ASSERT(fenwick_add_f64(ft, 0, 1) == -1 && errno == EINVAL);
+    ASSERT(fenwick_sum_f64(ft, 0, 1, &fsum) == -1 && errno == EINVAL);
+    ASSERT(fenwick_sum_i64(ft, 4, 4, &sum) == 0 && sum == 0);
+    fenwick_free(ft);
+
+    darray_t da = darray_new(sizeof(int32_t));
+    ASSERT(fenwick_from_darray(da, FENWICK_I64) == NULL && errno == EINVAL);
+    darray_free_full(da);
+
+    SUCCESS
+}
+
+
+void
+test_i64(void)
+{
+    START
+
+    darray_t da = darray_new(sizeof(int64_t));
+    for (int64_t i = 0; i < ELEM_AMOUNT; i++)
+    {
+        int64_t value = (i * 37 % 101) - 50;
+        darray_push_back(da, &value);
+    }
+
+    fenwick_t ft = fenwick_from_darray(da, FENWICK_I64);
+    ASSERT(ft != NULL && fenwick_size(ft) == ELEM_AMOUNT);
+
+    int64_t *values = darray_data(da);
+    for (size_t round = 0; round < 3; round++)
+    {
+        for (size_t from = 0; from <= ELEM_AMOUNT; from += 7)
+            for (size_t to = from; to <= ELEM_AMOUNT; to++)
+            {
+                /* wrapping around, like the tree */
+                uint64_t sum = 0;
+                int64_t  got;
+                for (size_t i = from; i < to; i++) sum += (uint64_t)values[i];
+
+                ASSERT(fenwick_sum_i64(ft, from, to, &got) == 0);
+                ASSERT(got == (int64_t)sum);
+            }
+
+        /* point updates, mirrored on the plain array */
+        for (size_t i = round; i < ELEM_AMOUNT; i += 5)
+        {
+            ASSERT(fenwick_add_i64(ft, i, -3) == 0);
+            values[i] -= 3;
+        }
+
+        ASSERT(fenwick_set_i64(ft, ELEM_AMOUNT - 1, INT64_MIN) == 0);
+        values[ELEM_AMOUNT - 1] = INT64_MIN;
+        ASSERT(fenwick_set_i64(ft, 0, 1000) == 0);
+        values[0] = 1000;
+    }
+
+    fenwick_clear(ft);
+    int64_t sum;
+    ASSERT(fenwick_sum_i64(ft, 0, ELEM_AMOUNT, &sum) == 0 && sum == 0);
+
+    fenwick_free(ft);
+    darray_free_full(da);
+    SUCCESS
+}
+
+
+void
+test_f64(void)
+{
+    START
+
+    fenwick_t ft = fenwick_new(ELEM_AMOUNT, FENWICK_F64);
+    double    values[ELEM_AMOUNT] = { 0 };
+
+    /* halves sum exactly, so every order gives the same result */
+    for (size_t i = 0; i < ELEM_AMOUNT; i++)
+    {
+        values[i] = (double)(i % 9) * 0.5;
+        ASSERT(fenwick_set_f64(ft, i, values[i]) == 0);
+    }
+
+    ASSERT(fenwick_add_f64(ft, 17, 2.5) == 0);
+    values[17] += 2.5;
+
+    for (size_t from = 0; from <= ELEM_AMOUNT; from += 3)
+        for (size_t to = from; to <= ELEM_AMOUNT; to += 2)
+        {
+            double sum = 0, got;
+            for (size_t i = from; i < to; i++) sum += values[i];
+
+            ASSERT(fenwick_sum_f64(ft, from, to, &got) == 0 && got == sum);
+        }
+
+    fenwick_free(ft);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_invalid();
+    test_i64();
+    test_f64();
+
+    return 0;
+}
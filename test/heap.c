@@ -0,0 +1,169 @@
+#include "ds/heap.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+
+struct task
+{
+    int    priority;
+    size_t index;
+};
+
+
+static int
+int_cmp(const void *a, const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+
+static int
+task_cmp(const void *a, const void *b)
+{
+    return ((const struct task *)a)->priority
+         - ((const struct task *)b)->priority;
+}
+
+
+static void
+task_index(void *elem, size_t index)
+{
+    ((struct task *)elem)->index = index;
+}
+
+
+static int
+drains_sorted(heap_t heap)
+{
+    int prev = -1, val;
+
+    while (heap_size(heap) > 0)
+    {
+        heap_pop(heap, &val);
+        if (val < prev) return 0;
+        prev = val;
+    }
+
+    return 1;
+}
+
+
+void
+test_push_pop(void)
+{
+    START
+
+    heap_t heap = heap_new_with_allocator(sizeof(int), int_cmp, xmalloc,
+                                          xrealloc, NULL);
+
+    /* empty heap operations should fail */
+    ASSERT(heap_top(heap) == NULL && errno == ERANGE);
+    ASSERT(heap_pop(heap, NULL) == NULL && errno == ERANGE);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        int val = (i * 7919) % 1000;
+        heap_push(heap, &val);
+    }
+
+    ASSERT(heap_size(heap) == 1000 && *(int *)heap_top(heap) == 0);
+    ASSERT(drains_sorted(heap));
+
+    heap_free(heap);
+    SUCCESS
+}
+
+
+void
+test_from_darray(void)
+{
+    START
+
+    darray_t da = darray_new(sizeof(int));
+    for (int i = 0; i < 500; i++)
+    {
+        int val = (i * 31) % 500;
+        darray_push_back(da, &val);
+    }
+
+    heap_t heap = heap_from_darray(da, int_cmp);
+    ASSERT(heap_darray(heap) == da && *(int *)heap_top(heap) == 0);
+
+    /* small bulk inserts sift, large ones rebuild */
+    int vals[600];
+    for (int i = 0; i < 600; i++) vals[i] = 600 - i;
+
+    heap_push_bulk(heap, vals, 10);
+    ASSERT(heap_size(heap) == 510);
+    heap_push_bulk(heap, vals, 600);
+    ASSERT(heap_size(heap) == 1110);
+
+    ASSERT(drains_sorted(heap));
+
+    heap_free(heap);
+    SUCCESS
+}
+
+
+void
+test_index_map(void)
+{
+    START
+
+    heap_t      heap = heap_new(sizeof(struct task), task_cmp);
+    struct task task;
+
+    heap_set_index_fn(heap, task_index);
+
+    for (int i = 0; i < 100; i++)
+    {
+        task.priority = 100 + i;
+        heap_push(heap, &task);
+    }
+
+    /* every element knows where it is */
+    darray_t da = heap_darray(heap);
+    for (size_t i = 0; i < darray_size(da); i++)
+        ASSERT(((struct task *)darray_at(da, i))->index == i);
+
+    /* decrease the key of the element with priority 150 */
+    for (size_t i = 0; i < darray_size(da); i++)
+        if (((struct task *)darray_at(da, i))->priority == 150)
+        {
+            task.priority = 1;
+            heap_update(heap, i, &task);
+            break;
+        }
+
+    ASSERT(((struct task *)heap_top(heap))->priority == 1);
+
+    heap_erase(heap, ((struct task *)heap_top(heap))->index);
+    ASSERT(((struct task *)heap_top(heap))->priority == 100);
+    ASSERT(heap_update(heap, 500, &task) == NULL && errno == ERANGE);
+
+    heap_free(heap);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_push_pop();
+    test_from_darray();
+    test_index_map();
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include <ds.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+
+#define SUCCESS std::fprintf(stderr, "successful\n");
+#define FAILED                                                        \
+    {                                                                 \
+        std::fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); \
+        std::exit(1);                                                 \
+    }
+#define START std::fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define AMOUNT 1000
+
+
+void
+test_darray_trivial()
+{
+    START
+
+    ds::darray<int> da;
+    for (int i = 0; i < AMOUNT; i++) da.push_back(AMOUNT - 1 - i);
+
+    ASSERT(da.size() == AMOUNT && da.capacity() >= AMOUNT);
+
+    std::sort(da.begin(), da.end());
+    for (int i = 0; i < AMOUNT; i++) ASSERT(da[i] == i);
+
+    /* the C side sees the same buffer */
+    darray_t handle = da.handle();
+    ASSERT(darray_size(handle) == AMOUNT);
+    ASSERT(*(int *)darray_at(handle, 10) == 10);
+
+    int value = -1;
+    darray_push_back(handle, &value);
+    ASSERT(da.back() == -1 && da.size() == AMOUNT + 1);
+
+    da.insert(da.begin() + 1, 42);
+    ASSERT(da[0] == 0 && da[1] == 42 && da[2] == 1);
+    da.erase(da.begin() + 1);
+    ASSERT(da[1] == 1);
+
+    /* appending an element of itself survives growth */
+    while (da.size() < da.capacity()) da.push_back(0);
+    da.push_back(da[5]);
+    ASSERT(da.back() == 5);
+
+    da.resize(3);
+    ASSERT(da.size() == 3);
+    da.resize(6);
+    ASSERT(da[5] == 0);
+
+    bool thrown = false;
+    try
+    {
+        (void)da.at(6);
+    }
+    catch (const std::out_of_range &)
+    {
+        thrown = true;
+    }
+    ASSERT(thrown);
+
+    /* a wrapper adopts a handle made by C code */
+    darray_t raw = darray_new(sizeof(int));
+    for (int i = 0; i < 10; i++) darray_push_back(raw, &i);
+
+    ds::darray<int> adopted(raw);
+    ASSERT(std::accumulate(adopted.begin(), adopted.end(), 0) == 45);
+
+    darray_free_full(adopted.release());
+
+    SUCCESS
+}
+
+
+void
+test_darray_move_only()
+{
+    START
+
+    ds::darray<std::unique_ptr<int>> da;
+    for (int i = 0; i < AMOUNT; i++) da.emplace_back(new int(i));
+
+    for (int i = 0; i < AMOUNT; i++) ASSERT(*da[i] == i);
+
+    da.insert(da.begin(), std::unique_ptr<int>(new int(-1)));
+    ASSERT(*da[0] == -1 && *da[1] == 0 && da.size() == AMOUNT + 1);
+
+    da.erase(da.begin());
+    ASSERT(*da[0] == 0 && da.size() == AMOUNT);
+
+    std::reverse(da.begin(), da.end());
+    ASSERT(*da.front() == AMOUNT - 1 && *da.back() == 0);
+
+    ds::darray<std::unique_ptr<int>> moved(std::move(da));
+    ASSERT(moved.size() == AMOUNT);
+
+    moved.resize(10);
+    moved.resize(20);
+    ASSERT(*moved[9] == AMOUNT - 10 && moved[19] == nullptr);
+
+    SUCCESS
+}
+
+
+void
+test_list()
+{
+    START
+
+    ds::list<int> list;
+    for (int i = 0; i < AMOUNT; i++)
+        if (i % 2 == 0)
+            list.push_back(i);
+        else
+            list.push_front(i);
+
+    ASSERT(list.size() == AMOUNT);
+    ASSERT(list.front() == AMOUNT - 1 && list.back() == AMOUNT - 2);
+
+    list.sort();
+    int expect = 0;
+    for (int value : list) ASSERT(value == expect++);
+
+    /* the C side walks the same nodes */
+    list_t node = list.handle();
+    for (int i = 0; i < 5; i++) node = list_next(node);
+    ASSERT(*(int *)list_data(node) == 5);
+
+    auto it = std::find(list.begin(), list.end(), 500);
+    it      = list.erase(it);
+    ASSERT(*it == 501 && list.size() == AMOUNT - 1);
+
+    list.insert(it, 500);
+    ASSERT(*--it == 500);
+
+    auto last = list.end();
+    ASSERT(*--last == AMOUNT - 1);
+
+    list.pop_front();
+    list.pop_back();
+    ASSERT(list.front() == 1 && list.back() == AMOUNT - 2);
+
+    ds::list<int> copy(list);
+    list.clear();
+    ASSERT(list.empty() && copy.size() == AMOUNT - 2);
+    ASSERT(std::is_sorted(copy.begin(), copy.end()));
+
+    SUCCESS
+}
+
+
+int
+main()
+{
+    test_darray_trivial();
+    test_darray_move_only();
+    test_list();
+
+    return 0;
+}
@@ -1,14 +1,65 @@
 #include "ds/list.h"
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "shared/xmalloc.h"
 
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
 
-int
-main(void)
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define SORT_AMOUNT 1000
+
+
+static int
+cmp_value(const void *a, const void *b)
 {
+    intptr_t x = (intptr_t)a / 16;
+    intptr_t y = (intptr_t)b / 16;
+    return (x > y) - (x < y);
+}
+
+
+/* checks that the list starting at @head holds exactly @values */
+static int
+list_equals(list_t head, const intptr_t *values, size_t n)
+{
+    list_t prev = NULL;
+
+    for (size_t i = 0; i < n; i++, head = list_next(head))
+    {
+        if (head == NULL || list_prev(head) != prev) return 0;
+        if ((intptr_t)list_data(head) != values[i]) return 0;
+        prev = head;
+    }
+
+    return head == NULL;
+}
+
+
+static list_t
+list_from(const intptr_t *values, size_t n)
+{
+    list_t head = list_new_with_allocator(xmalloc, NULL);
+    list_t tail = list_set_data(head, (void *)values[0]);
+
+    for (size_t i = 1; i < n; i++) tail = list_append(tail, (void *)values[i]);
+    return head;
+}
+
+
+void
+test_basic(void)
+{
+    START
+
     list_t list = list_new_with_allocator(xmalloc, NULL);
 
     char *str1 = "Hello, World!";
@@ -19,9 +70,175 @@ main(void)
     list_append(list, str2);
     list_prepend(list, str3);
 
-    printf("%s\n", (char *)list_data(list));
-    printf("%s\n", (char *)list_data(list_next(list)));
-    printf("%s\n", (char *)list_data(list_at(list, -1)));
+    ASSERT(list_data(list) == str1);
+    ASSERT(list_data(list_next(list)) == str2);
+    ASSERT(list_data(list_at(list, -1)) == str3);
+
+    list_free(list);
+    SUCCESS
+}
+
+
+void
+test_splice(void)
+{
+    START
+
+    const intptr_t a[] = { 1, 2, 3, 4, 5 };
+    const intptr_t b[] = { 6, 7 };
+
+    list_t la = list_from(a, 5);
+    list_t lb = list_from(b, 2);
+
+    /* 1 2 3 4 5 6 7 */
+    ASSERT(list_concat(list_at(la, 4), lb) == lb);
+    const intptr_t r1[] = { 1, 2, 3, 4, 5, 6, 7 };
+    ASSERT(list_equals(la, r1, 7));
+
+    /* move 2 3 after 6 */
+    list_t two = list_at(la, 1);
+    ASSERT(list_splice(lb, two, list_next(two)) == two);
+    const intptr_t r2[] = { 1, 4, 5, 6, 2, 3, 7 };
+    ASSERT(list_equals(la, r2, 7));
+
+    /* move 4 after its own predecessor, a no-op */
+    list_t four = list_at(la, 1);
+    list_splice(la, four, four);
+    ASSERT(list_equals(la, r2, 7));
+
+    /* move the tail right after the head */
+    list_splice(la, list_at(la, 6), list_at(la, 6));
+    const intptr_t r3[] = { 1, 7, 4, 5, 6, 2, 3 };
+    ASSERT(list_equals(la, r3, 7));
+
+    ASSERT(list_split_at(la) == NULL);
+
+    list_t second = list_at(la, 3);
+    list_t tail   = list_split_at(second);
+    ASSERT(tail != NULL && list_data(tail) == (void *)4);
+    ASSERT(list_equals(la, r3, 3) && list_equals(second, r3 + 3, 4));
+
+    list_free(la);
+    list_free(second);
+    SUCCESS
+}
+
+
+void
+test_sort(void)
+{
+    START
+
+    static intptr_t values[SORT_AMOUNT];
+    static intptr_t sorted[SORT_AMOUNT];
+    uint32_t        seed = 42;
+
+    /* few distinct keys, the low bits tell equal keys apart */
+    for (size_t i = 0; i < SORT_AMOUNT; i++)
+    {
+        seed      = (seed * 1103515245U) + 12345U;
+        values[i] = ((intptr_t)((seed >> 16) % 50) * 16) + (intptr_t)(i % 16);
+    }
 
+    list_t list = list_from(values, SORT_AMOUNT);
+    list        = list_sort(list_at(list, SORT_AMOUNT / 2), cmp_value);
+
+    /* a stable counting sort as the reference */
+    size_t n = 0;
+    for (intptr_t key = 0; key < 50; key++)
+        for (size_t i = 0; i < SORT_AMOUNT; i++)
+            if (values[i] / 16 == key) sorted[n++] = values[i];
+
+    ASSERT(list_equals(list, sorted, SORT_AMOUNT));
     list_free(list);
+
+    list_t one = list_new();
+    ASSERT(list_sort(one, cmp_value) == one && list_next(one) == NULL);
+    list_free(one);
+    SUCCESS
+}
+
+
+static int
+sum_until(void *value, void *data)
+{
+    intptr_t *sum = data;
+
+    if ((intptr_t)value < 0) return (int)-(intptr_t)value;
+    *sum += (intptr_t)value;
+    return 0;
+}
+
+
+void
+test_compact(void)
+{
+    START
+
+    static intptr_t values[SORT_AMOUNT];
+
+    /* prepending and appending in turn scatters the traversal order */
+    list_t head = list_new();
+    list_t tail = list_set_data(head, (void *)0);
+    for (intptr_t i = 1; i < SORT_AMOUNT; i++)
+    {
+        if (i % 2 == 0)
+            tail = list_append(tail, (void *)i);
+        else
+            head = list_prepend(head, (void *)i);
+    }
+
+    for (size_t i = 0; i < SORT_AMOUNT; i++)
+    {
+        values[i] = (intptr_t)list_data(head);
+        head      = list_next(head) != NULL ? list_next(head) : head;
+    }
+
+    list_t list = list_compact(tail);
+    ASSERT(list != NULL && list_equals(list, values, SORT_AMOUNT));
+
+    /* the nodes follow each other in memory, a node apart */
+    ptrdiff_t stride = (char *)list_next(list) - (char *)list;
+    ASSERT(stride > 0);
+    for (list_t node = list; list_next(node) != NULL; node = list_next(node))
+        ASSERT((char *)list_next(node) - (char *)node == stride);
+
+    /* the block outlives its nodes until the last one is freed */
+    list_t last = list_at(list, SORT_AMOUNT - 1);
+    ASSERT(list_split_at(last) != NULL);
+    list_free_node(last);
+
+    list = list_compact(list_at(list, 10));
+    ASSERT(list != NULL && list_equals(list, values, SORT_AMOUNT - 1));
+    ASSERT(list_append(list, (void *)7) != NULL);
+
+    intptr_t sum = 0;
+    ASSERT(list_foreach(list, 0, sum_until, &sum) == 0);
+
+    intptr_t expected = 7;
+    for (size_t i = 0; i < SORT_AMOUNT - 1; i++) expected += values[i];
+    ASSERT(sum == expected);
+
+    sum = 0;
+    ASSERT(list_foreach(list, 8, sum_until, &sum) == 0 && sum == expected);
+
+    list_set_data(list_at(list, 5), (void *)-3);
+    sum = 0;
+    ASSERT(list_foreach(list, 64, sum_until, &sum) == 3);
+    ASSERT(sum == values[0] + values[1] + values[2] + values[3] + values[4]);
+
+    list_free(list);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_basic();
+    test_splice();
+    test_sort();
+    test_compact();
+
+    return 0;
 }
@@ -0,0 +1,152 @@
+#include "ds/lru.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define CAPACITY 64
+
+
+struct evictions
+{
+    size_t   count;
+    uint64_t last_key;
+};
+
+
+static void
+count_eviction(const void *key, void *value, void *data)
+{
+    struct evictions *ev = data;
+
+    ev->count++;
+    ev->last_key = *(const uint64_t *)key;
+}
+
+
+void
+test_invalid(void)
+{
+    START
+
+    ASSERT(lru_new(0, 8, 8, LRU_EXACT) == NULL && errno == EINVAL);
+    ASSERT(lru_new(8, 0, 8, LRU_EXACT) == NULL && errno == EINVAL);
+    ASSERT(lru_new(8, 8, 8, (enum lru_policy)9) == NULL && errno == EINVAL);
+    ASSERT(lru_new_with_allocator(8, 8, 8, LRU_CLOCK, fail_malloc, NULL)
+           == NULL);
+
+    SUCCESS
+}
+
+
+void
+test_exact(void)
+{
+    START
+
+    lru_t            lru = lru_new_with_allocator(CAPACITY, sizeof(uint64_t),
+                                                  sizeof(uint64_t), LRU_EXACT,
+                                                  xmalloc, NULL);
+    struct evictions ev  = { 0, 0 };
+    lru_set_evict(lru, count_eviction, &ev);
+
+    for (uint64_t key = 0; key < CAPACITY; key++)
+    {
+        uint64_t value = key * 10;
+        ASSERT(*(uint64_t *)lru_put(lru, &key, &value) == value);
+    }
+
+    ASSERT(lru_size(lru) == CAPACITY && ev.count == 0);
+
+    /* key 0 becomes the most recent, so key 1 is evicted first */
+    uint64_t key = 0;
+    ASSERT(*(uint64_t *)lru_get(lru, &key) == 0);
+
+    key = 1000;
+    ASSERT(lru_put(lru, &key, NULL) != NULL);
+    ASSERT(ev.count == 1 && ev.last_key == 1);
+
+    key = 1;
+    ASSERT(lru_get(lru, &key) == NULL);
+    key = 0;
+    ASSERT(lru_get(lru, &key) != NULL);
+
+    /* replacing a value evicts nothing */
+    uint64_t value = 7;
+    key            = 1000;
+    ASSERT(*(uint64_t *)lru_put(lru, &key, &value) == 7 && ev.count == 1);
+
+    /* a freed entry is reused before evicting */
+    key = 5;
+    ASSERT(lru_erase(lru, &key) == 0 && lru_size(lru) == CAPACITY - 1);
+    ASSERT(lru_erase(lru, &key) == -1 && errno == ENOENT);
+    key = 2000;
+    ASSERT(lru_put(lru, &key, NULL) != NULL && ev.count == 1);
+
+    /* then the least recent keys go in order */
+    for (uint64_t i = 0; i < 10; i++)
+    {
+        key = 3000 + i;
+        lru_put(lru, &key, NULL);
+        ASSERT(ev.last_key == (i < 3 ? i + 2 : i + 3));
+    }
+
+    lru_clear(lru);
+    ASSERT(lru_size(lru) == 0 && lru_get(lru, &key) == NULL);
+
+    lru_free(lru);
+    SUCCESS
+}
+
+
+void
+test_clock(void)
+{
+    START
+
+    lru_t            lru = lru_new(CAPACITY, sizeof(uint64_t), sizeof(uint64_t),
+                                   LRU_CLOCK);
+    struct evictions ev  = { 0, 0 };
+    lru_set_evict(lru, count_eviction, &ev);
+
+    for (uint64_t key = 0; key < CAPACITY; key++) lru_put(lru, &key, &key);
+
+    /* a hot set that is hit between every insertion is never evicted */
+    for (uint64_t round = 0; round < 1000; round++)
+    {
+        for (uint64_t key = 0; key < CAPACITY / 4; key++)
+            ASSERT(*(uint64_t *)lru_get(lru, &key) == key);
+
+        uint64_t key = 10000 + round;
+        lru_put(lru, &key, &key);
+        ASSERT(ev.last_key >= CAPACITY / 4);
+    }
+
+    ASSERT(ev.count == 1000 && lru_size(lru) == CAPACITY);
+    ASSERT(lru_capacity(lru) == CAPACITY);
+
+    lru_free(lru);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_invalid();
+    test_exact();
+    test_clock();
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include "ds/packed.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define AMOUNT 10000
+
+
+static uint64_t values[AMOUNT];
+static uint64_t out[AMOUNT];
+
+
+void
+test_invalid(void)
+{
+    START
+
+    uint64_t value;
+
+    ASSERT(packed_new((enum packed_mode)7) == NULL && errno == EINVAL);
+    ASSERT(packed_new_with_allocator(PACKED_BITS, fail_malloc, NULL, NULL)
+           == NULL);
+
+    packed_t pa = packed_new(PACKED_DELTA);
+    ASSERT(packed_get(pa, 0, &value) == -1 && errno == ERANGE);
+    ASSERT(packed_append(pa, 5) == 0);
+    ASSERT(packed_append(pa, 4) == -1 && errno == EINVAL);
+    ASSERT(packed_set(pa, 0, 6) == -1 && errno == EINVAL);
+    ASSERT(packed_size(pa) == 1 && packed_width(pa) == 0);
+    packed_free(pa);
+
+    SUCCESS
+}
+
+
+void
+test_bits(void)
+{
+    START
+
+    packed_t pa = packed_new_with_allocator(PACKED_BITS, xmalloc, xrealloc,
+                                            NULL);
+    uint64_t value;
+
+    /* all zeroes take no bits at all */
+    for (size_t i = 0; i < 100; i++) ASSERT(packed_append(pa, 0) == 0);
+    ASSERT(packed_width(pa) == 0 && packed_bytes(pa) == 0);
+
+    /* the width grows with the widest integer, repacking the old ones */
+    ASSERT(packed_append(pa, 5) == 0 && packed_width(pa) == 3);
+    ASSERT(packed_get(pa, 99, &value) == 0 && value == 0);
+    ASSERT(packed_get(pa, 100, &value) == 0 && value == 5);
+
+    ASSERT(packed_set(pa, 7, 1000) == 0 && packed_width(pa) == 10);
+    ASSERT(packed_get(pa, 7, &value) == 0 && value == 1000);
+    ASSERT(packed_get(pa, 100, &value) == 0 && value == 5);
+    ASSERT(packed_get(pa, 101, &value) == -1 && errno == ERANGE);
+    packed_free(pa);
+
+    /* integers straddling words at every width */
+    for (unsigned width = 1; width <= 64; width += 7)
+    {
+        uint64_t mask = width == 64 ? ~(uint64_t)0
+                                    : ((uint64_t)1 << width) - 1;
+
+        for (size_t i = 0; i < AMOUNT; i++)
+            values[i] = ((uint64_t)i * 0x9e3779b97f4a7c15U) & mask;
+        values[0] = mask;
+
+        pa = packed_new(PACKED_BITS);
+        ASSERT(packed_append_many(pa, values, AMOUNT) == 0);
+        ASSERT(packed_width(pa) == width);
+
+        for (size_t i = 0; i < AMOUNT; i++)
+            ASSERT(packed_get(pa, i, &value) == 0 && value == values[i]);
+
+        ASSERT(packed_decode(pa, 3, out, AMOUNT) == AMOUNT - 3);
+        for (size_t i = 3; i < AMOUNT; i++) ASSERT(out[i - 3] == values[i]);
+
+        packed_free(pa);
+    }
+
+    SUCCESS
+}
+
+
+void
+test_delta(void)
+{
+    START
+
+    packed_t pa = packed_new(PACKED_DELTA);
+    uint64_t value;
+
+    /* mostly small gaps, with a few of every varint size */
+    values[0] = 1000;
+    for (size_t i = 1; i < AMOUNT; i++)
+    {
+        uint64_t gap = (i * 7) % 13;
+        if (i % 1000 == 0) gap = 70000;
+        if (i % 3000 == 0) gap = (uint64_t)1 << 40;
+        if (i % 555 == 0) gap = 300;
+        values[i] = values[i - 1] + gap;
+    }
+
+    ASSERT(packed_append_many(pa, values, AMOUNT) == 0);
+    ASSERT(packed_size(pa) == AMOUNT);
+    ASSERT(packed_bytes(pa) < AMOUNT * 2);
+
+    for (size_t i = 0; i < AMOUNT; i++)
+        ASSERT(packed_get(pa, i, &value) == 0 && value == values[i]);
+
+    /* from the middle of a block, through the unfinished one */
+    ASSERT(packed_decode(pa, 77, out, AMOUNT) == AMOUNT - 77);
+    for (size_t i = 77; i < AMOUNT; i++) ASSERT(out[i - 77] == values[i]);
+
+    ASSERT(packed_decode(pa, 256, out, 128) == 128);
+    for (size_t i = 0; i < 128; i++) ASSERT(out[i] == values[256 + i]);
+
+    ASSERT(packed_decode(pa, AMOUNT, out, 1) == 0);
+
+    packed_free(pa);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_invalid();
+    test_bits();
+    test_delta();
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "ds/prof.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ds/darray.h"
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+
+void
+test_regions(void)
+{
+    START
+
+    /* works whether or not the counters are available */
+    prof_t   prof = prof_new_with_allocator(xmalloc, xrealloc, NULL);
+    darray_t da   = darray_new(sizeof(int));
+
+    for (int i = 0; i < 100; i++)
+        PROF_SCOPE(prof, "darray_insert", darray_insert(da, &i, 0));
+
+    struct prof_sample sample;
+    int                sum = 0;
+
+    prof_begin(prof);
+    for (size_t i = 0; i < darray_size(da); i++) sum += *(int *)darray_at(da, i);
+    ASSERT(prof_end(prof, "darray_at", &sample) == 0);
+    ASSERT(sum == 4950);
+
+    ASSERT(sample.counted <= 1);
+    ASSERT(prof_stats(prof, "darray_insert", &sample) == 100);
+    ASSERT(sample.wall_ns > 0 && sample.counted <= 100);
+    ASSERT(prof_stats(prof, "darray_at", &sample) == 1);
+    ASSERT(prof_stats(prof, "list_next", &sample) == 0);
+
+    /* a region the counters measured has counted something */
+    prof_stats(prof, "darray_insert", &sample);
+    if (prof_available(prof, PROF_INSTRUCTIONS) && sample.counted > 0)
+        ASSERT(sample.values[PROF_INSTRUCTIONS] > 0);
+
+    prof_report(prof, stdout);
+
+    darray_free_full(da);
+    prof_free(prof);
+    SUCCESS
+}
+
+
+void
+test_unnamed(void)
+{
+    START
+
+    prof_t             prof = prof_new();
+    struct prof_sample sample;
+
+    ASSERT(!prof_available(prof, PROF_COUNTER_AMOUNT));
+
+    /* regions without a name are not recorded */
+    prof_begin(prof);
+    ASSERT(prof_end(prof, NULL, &sample) == 0);
+    ASSERT(prof_stats(prof, "", &sample) == 0);
+
+    prof_free(prof);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_regions();
+    test_unnamed();
+
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include "ds/reduce.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+/* the last size of the checks, split into 4 chunks of at least 1 MiB */
+#define LARGE_AMOUNT ((size_t)80 << 15)
+
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+
+static uint64_t
+rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+
+void
+test_invalid(void)
+{
+    START
+
+    darray_t da = darray_new(sizeof(int32_t));
+    int32_t  min, max;
+    int64_t  sum;
+    size_t   index;
+
+    ASSERT(darray_sum_i32(da, &sum) == 0 && sum == 0);
+    ASSERT(darray_min_i32(da, &min) == -1 && errno == ERANGE);
+    ASSERT(darray_minmax_i32(da, &min, &max) == -1 && errno == ERANGE);
+    ASSERT(darray_argmax_i32(da, &index) == -1 && errno == ERANGE);
+    ASSERT(darray_sum_i64(da, &sum) == -1 && errno == EINVAL);
+
+    int32_t value = -5;
+    darray_push_back(da, &value);
+    ASSERT(darray_minmax_i32(da, &min, &max) == 0 && min == -5 && max == -5);
+    ASSERT(darray_argmin_i32(da, &index) == 0 && index == 0);
+
+    darray_free_full(da);
+
+    darray_reduce_set_threads(0);
+    ASSERT(darray_reduce_threads() == 1);
+
+    SUCCESS
+}
+
+
+/*
+ * Checks one element type against a plain loop, over sizes that hit the
+ * scalar tails and the vector loops, then over an array large enough to be
+ * split between threads.
+ */
+#define CHECK_TYPE(S, T, ACC, gen)                                          \
+    do {                                                                   \
+        for (size_t n = 1; n <= LARGE_AMOUNT; n += n < 80 ? 1 : n * 7)     \
+        {                                                                  \
+            darray_t da = darray_new(sizeof(T));                           \
+            darray_resize(da, n);                                          \
+            T *data = darray_data(da);                                     \
+                                                                           \
+            ACC    sum  = 0;                                               \
+            size_t imin = 0, imax = 0;                                     \
+            for (size_t i = 0; i < n; i++)                                 \
+            {                                                              \
+                data[i]  = (T)(gen);                                       \
+                sum     += (ACC)data[i];                                   \
+                if (data[i] < data[imin]) imin = i;                        \
+                if (data[i] > data[imax]) imax = i;                        \
+            }                                                              \
+                                                                           \
+            ACC    got_sum;                                                \
+            T      min, max;                                               \
+            size_t index;                                                  \
+                                                                           \
+            ASSERT(darray_sum_##S(da, &got_sum) == 0);                     \
+            ASSERT(got_sum == sum);                                        \
+            ASSERT(darray_min_##S(da, &min) == 0 && min == data[imin]);    \
+            ASSERT(darray_max_##S(da, &max) == 0 && max == data[imax]);    \
+            ASSERT(darray_minmax_##S(da, &min, &max) == 0);                \
+            ASSERT(min == data[imin] && max == data[imax]);                \
+            ASSERT(darray_argmin_##S(da, &index) == 0 && index == imin);   \
+            ASSERT(darray_argmax_##S(da, &index) == 0 && index == imax);   \
+                                                                           \
+            darray_free_full(da);                                          \
+        }                                                                  \
+    } while (0)
+
+
+void
+test_integers(void)
+{
+    START
+
+    for (size_t threads = 1; threads <= 4; threads += 3)
+    {
+        darray_reduce_set_threads(threads);
+
+        /* small ranges, so the extremes repeat and ties are checked */
+        CHECK_TYPE(i32, int32_t, int64_t, (int32_t)(rng() % 2001) - 1000);
+        CHECK_TYPE(u32, uint32_t, uint64_t, rng() % 5000);
+        CHECK_TYPE(i64, int64_t, int64_t, (int64_t)(rng() % 1000001) - 500000);
+        CHECK_TYPE(u64, uint64_t, uint64_t, rng());
+    }
+
+    darray_reduce_set_threads(1);
+    SUCCESS
+}
+
+
+void
+test_floats(void)
+{
+    START
+
+    for (size_t threads = 1; threads <= 4; threads += 3)
+    {
+        darray_reduce_set_threads(threads);
+
+        /* small integers, which every summation order adds exactly */
+        CHECK_TYPE(f32, float, float, (float)(rng() % 17) - 8);
+        CHECK_TYPE(f64, double, double, (double)(rng() % 1001) - 500);
+    }
+
+    darray_reduce_set_threads(1);
+    SUCCESS
+}
+
+
+void
+test_compensated(void)
+{
+    START
+
+    /* 1 followed by values each too small to change it on their own */
+    darray_t da = darray_new(sizeof(float));
+    float    one = 1.0F, tiny = 1e-8F;
+
+    darray_push_back(da, &one);
+    for (size_t i = 0; i < 1000000; i++) darray_push_back(da, &tiny);
+
+    float plain = 0, kahan, pairwise;
+    for (size_t i = 0; i < darray_size(da); i++)
+        plain += ((float *)darray_data(da))[i];
+
+    ASSERT(darray_sum_kahan_f32(da, &kahan) == 0);
+    ASSERT(darray_sum_f32(da, &pairwise) == 0);
+
+    /* the exact sum is 1.01 */
+    ASSERT(plain == 1.0F);
+    ASSERT(kahan > 1.0099F && kahan < 1.0101F);
+    ASSERT(pairwise > 1.0099F && pairwise < 1.0101F);
+
+    darray_free_full(da);
+
+    double sum;
+    da = darray_new(sizeof(double));
+    ASSERT(darray_sum_kahan_f64(da, &sum) == 0 && sum == 0);
+    ASSERT(darray_sum_kahan_f32(da, &kahan) == -1 && errno == EINVAL);
+    darray_free_full(da);
+
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_invalid();
+    test_integers();
+    test_floats();
+    test_compensated();
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include "ds/segtree.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define MODULUS 1000003U
+
+
+/* `x * mul + add`, composed left to right */
+struct affine
+{
+    uint64_t mul;
+    uint64_t add;
+};
+
+
+static void
+combine_min(void *out, const void *left, const void *right)
+{
+    int32_t a = *(const int32_t *)left;
+    int32_t b = *(const int32_t *)right;
+
+    *(int32_t *)out = b < a ? b : a;
+}
+
+
+static void
+combine_affine(void *out, const void *left, const void *right)
+{
+    const struct affine *f = left;
+    const struct affine *g = right;
+    struct affine        r = { (f->mul * g->mul) % MODULUS,
+                               ((f->add * g->mul) + g->add) % MODULUS };
+
+    *(struct affine *)out = r;
+}
+
+
+void
+test_invalid(void)
+{
+    START
+
+    int32_t   value = 4, out;
+    segtree_t st    = segtree_new(sizeof(int32_t), &value, 1, combine_min);
+
+    ASSERT(segtree_query(st, 0, 0, &out) == -1 && errno == ERANGE);
+    ASSERT(segtree_query(st, 0, 2, &out) == -1 && errno == ERANGE);
+    ASSERT(segtree_set(st, 1, &value) == -1 && errno == ERANGE);
+    ASSERT(segtree_at(st, 1) == NULL);
+    ASSERT(segtree_query(st, 0, 1, &out) == 0 && out == 4);
+    segtree_free(st);
+
+    darray_t da = darray_new(sizeof(int32_t));
+    ASSERT(segtree_from_darray(da, combine_min) == NULL && errno == EINVAL);
+    ASSERT(segtree_new(0, &value, 1, combine_min) == NULL && errno == EINVAL);
+    darray_free_full(da);
+
+    SUCCESS
+}
+
+
+void
+test_min(void)
+{
+    START
+
+    /* sizes that are and are not powers of two */
+    for (size_t size = 1; size <= 70; size++)
+    {
+        darray_t da = darray_new(sizeof(int32_t));
+        for (size_t i = 0; i < size; i++)
+        {
+            int32_t value = (int32_t)((i * 7919) % 61) - 30;
+            darray_push_back(da, &value);
+        }
+
+        segtree_t st     = segtree_from_darray(da, combine_min);
+        int32_t  *values = darray_data(da);
+        ASSERT(st != NULL && segtree_size(st) == size);
+
+        for (size_t i = 0; i < size; i += 3)
+        {
+            int32_t value = -(int32_t)i;
+            ASSERT(segtree_set(st, i, &value) == 0);
+            values[i] = value;
+        }
+
+        for (size_t from = 0; from < size; from++)
+            for (size_t to = from + 1; to <= size; to++)
+            {
+                int32_t min = values[from], got;
+                for (size_t i = from; i < to; i++)
+                    if (values[i] < min) min = values[i];
+
+                ASSERT(segtree_query(st, from, to, &got) == 0 && got == min);
+            }
+
+        ASSERT(*(const int32_t *)segtree_at(st, size - 1)
+               == values[size - 1]);
+
+        segtree_free(st);
+        darray_free_full(da);
+    }
+
+    SUCCESS
+}
+
+
+void
+test_ordered(void)
+{
+    START
+
+    /* composing functions depends on their order */
+    for (size_t size = 1; size <= 45; size++)
+    {
+        struct affine fns[45];
+        for (size_t i = 0; i < size; i++)
+        {
+            fns[i].mul = (i * 31) + 2;
+            fns[i].add = (i * 17) + 5;
+        }
+
+        segtree_t st = segtree_new(sizeof(struct affine), fns, size,
+                                   combine_affine);
+        ASSERT(st != NULL);
+
+        fns[size / 2].mul = 3;
+        ASSERT(segtree_set(st, size / 2, &fns[size / 2]) == 0);
+
+        for (size_t from = 0; from < size; from++)
+            for (size_t to = from + 1; to <= size; to++)
+            {
+                struct affine expect = fns[from], got;
+                for (size_t i = from + 1; i < to; i++)
+                    combine_affine(&expect, &expect, &fns[i]);
+
+                ASSERT(segtree_query(st, from, to, &got) == 0);
+                ASSERT(got.mul == expect.mul && got.add == expect.add);
+            }
+
+        segtree_free(st);
+    }
+
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_invalid();
+    test_min();
+    test_ordered();
+
+    return 0;
+}
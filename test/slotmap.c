@@ -0,0 +1,113 @@
+#include "ds/slotmap.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define ELEM_AMOUNT 5000
+
+
+void
+test_basic(void)
+{
+    START
+
+    slotmap_t sm = slotmap_new_with_allocator(sizeof(int), xmalloc, xrealloc,
+                                              NULL);
+    int a = 1, b = 2, c = 3;
+
+    ASSERT(slotmap_get(sm, SLOTMAP_NULL) == NULL);
+    ASSERT(slotmap_erase(sm, SLOTMAP_NULL) == -1 && errno == ENOENT);
+
+    slotmap_handle_t ha = slotmap_insert(sm, &a);
+    slotmap_handle_t hb = slotmap_insert(sm, &b);
+    slotmap_handle_t hc = slotmap_insert(sm, &c);
+    ASSERT(ha != SLOTMAP_NULL && hb != SLOTMAP_NULL && hc != SLOTMAP_NULL);
+    ASSERT(slotmap_size(sm) == 3);
+
+    /* the last element moves into the hole, its handle still finds it */
+    ASSERT(slotmap_erase(sm, ha) == 0);
+    ASSERT(slotmap_size(sm) == 2 && ((int *)slotmap_data(sm))[0] == 3);
+    ASSERT(*(int *)slotmap_get(sm, hc) == 3);
+    ASSERT(*(int *)slotmap_get(sm, hb) == 2);
+    ASSERT(slotmap_handle_at(sm, 0) == hc && slotmap_handle_at(sm, 1) == hb);
+    ASSERT(slotmap_handle_at(sm, 2) == SLOTMAP_NULL && errno == ERANGE);
+
+    /* the slot is reused, the stale handle is not confused with it */
+    slotmap_handle_t hd = slotmap_insert(sm, NULL);
+    ASSERT((uint32_t)hd == (uint32_t)ha && hd != ha);
+    ASSERT(*(int *)slotmap_get(sm, hd) == 0);
+    ASSERT(!slotmap_contains(sm, ha) && slotmap_get(sm, ha) == NULL);
+    ASSERT(slotmap_erase(sm, ha) == -1 && errno == ENOENT);
+
+    slotmap_clear(sm);
+    ASSERT(slotmap_size(sm) == 0);
+    ASSERT(!slotmap_contains(sm, hb) && !slotmap_contains(sm, hd));
+
+    slotmap_free(sm);
+    ASSERT(slotmap_new(0) == NULL && errno == EINVAL);
+    SUCCESS
+}
+
+
+void
+test_churn(void)
+{
+    START
+
+    static slotmap_handle_t handles[ELEM_AMOUNT];
+    slotmap_t               sm = slotmap_new(sizeof(size_t));
+
+    for (size_t round = 0; round < 4; round++)
+    {
+        for (size_t i = 0; i < ELEM_AMOUNT; i++)
+        {
+            if (round > 0 && i % 3 != 0) continue;
+            if (round > 0) ASSERT(slotmap_erase(sm, handles[i]) == 0);
+
+            size_t value = (round * ELEM_AMOUNT) + i;
+            handles[i]   = slotmap_insert(sm, &value);
+            ASSERT(handles[i] != SLOTMAP_NULL);
+        }
+    }
+
+    /* slots are reused instead of growing */
+    ASSERT(slotmap_size(sm) == ELEM_AMOUNT);
+
+    for (size_t i = 0; i < ELEM_AMOUNT; i++)
+    {
+        size_t *value = slotmap_get(sm, handles[i]);
+        ASSERT(value != NULL && *value % ELEM_AMOUNT == i);
+        ASSERT(*value / ELEM_AMOUNT == (i % 3 == 0 ? 3 : 0));
+    }
+
+    for (size_t i = 0; i < slotmap_size(sm); i++)
+    {
+        size_t value = ((size_t *)slotmap_data(sm))[i];
+        ASSERT(slotmap_handle_at(sm, i) == handles[value % ELEM_AMOUNT]);
+    }
+
+    slotmap_free(sm);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_basic();
+    test_churn();
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "ds/soa.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+
+static const size_t column_sizes[] = { sizeof(uint32_t), sizeof(double),
+                                       sizeof(char) };
+
+
+void
+test_invalid(void)
+{
+    START
+
+    size_t sizes[] = { 4, 0 };
+
+    /* should fail */
+    soa_t soa = soa_new(2, sizes);
+    ASSERT(soa == NULL && errno == EINVAL);
+    soa = soa_new(0, sizes);
+    ASSERT(soa == NULL && errno == EINVAL);
+
+    soa = soa_new_with_allocator(3, column_sizes, fail_malloc, NULL, NULL);
+    ASSERT(soa == NULL);
+
+    SUCCESS
+}
+
+
+void
+test_rows(void)
+{
+    START
+
+    soa_t soa = soa_new_with_allocator(3, column_sizes, xmalloc, xrealloc,
+                                       NULL);
+    ASSERT(soa_columns(soa) == 3 && soa_column_size(soa, 1) == sizeof(double));
+
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        double      score = i * 0.5;
+        char        tag   = (char)('a' + (i % 26));
+        const void *row[] = { &i, &score, &tag };
+
+        ASSERT(soa_push_back(soa, row) == 0);
+    }
+    ASSERT(soa_size(soa) == 100 && soa_capacity(soa) >= 100);
+
+    /* columns are contiguous */
+    double *scores = soa_column(soa, 1);
+    double  sum    = 0;
+    for (size_t i = 0; i < soa_size(soa); i++) sum += scores[i];
+    ASSERT(sum == 2475.0);
+
+    uint32_t id;
+    double   score;
+    char     tag;
+    void    *out[] = { &id, &score, &tag };
+
+    ASSERT(soa_erase(soa, 0) == 0);
+    ASSERT(soa_get(soa, 0, out) == 0);
+    ASSERT(id == 1 && score == 0.5 && tag == 'b');
+    ASSERT(*(uint32_t *)soa_at(soa, 0, 98) == 99);
+
+    ASSERT(soa_get(soa, 99, out) == -1 && errno == ERANGE);
+    ASSERT(soa_at(soa, 3, 0) == NULL && errno == ERANGE);
+
+    ASSERT(soa_pop_back(soa) == 0 && soa_size(soa) == 98);
+
+    soa_resize(soa, 200);
+    ASSERT(soa_size(soa) == 200 && *(double *)soa_at(soa, 1, 150) == 0);
+
+    soa_clear(soa);
+    ASSERT(soa_size(soa) == 0);
+    ASSERT(soa_pop_back(soa) == -1 && errno == ERANGE);
+
+    soa_free(soa);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_invalid();
+    test_rows();
+
+    return 0;
+}
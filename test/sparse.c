@@ -0,0 +1,102 @@
+#include "ds/sparse.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared/xmalloc.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define KEY_AMOUNT 10000
+
+
+struct position
+{
+    double x, y;
+};
+
+
+void
+test_keys(void)
+{
+    START
+
+    sparse_t ss = sparse_new_with_allocator(0, xmalloc, xrealloc, NULL);
+
+    ASSERT(!sparse_contains(ss, 3) && sparse_get(ss, 3) == NULL);
+    ASSERT(sparse_erase(ss, 3) == -1 && errno == ENOENT);
+
+    ASSERT(*(size_t *)sparse_insert(ss, 3, NULL) == 3);
+    ASSERT(sparse_insert(ss, 3, NULL) == NULL && errno == EEXIST);
+    ASSERT(sparse_insert(ss, 1000, NULL) != NULL);
+    ASSERT(sparse_insert(ss, 0, NULL) != NULL);
+    ASSERT(sparse_size(ss) == 3);
+    ASSERT(sparse_contains(ss, 0) && sparse_contains(ss, 1000));
+    ASSERT(!sparse_contains(ss, 999) && !sparse_contains(ss, 5000));
+
+    /* the last key moves into the erased slot */
+    ASSERT(sparse_erase(ss, 3) == 0);
+    ASSERT(sparse_size(ss) == 2 && !sparse_contains(ss, 3));
+    ASSERT(sparse_keys(ss)[0] == 0 && sparse_keys(ss)[1] == 1000);
+
+    sparse_clear(ss);
+    ASSERT(sparse_size(ss) == 0 && !sparse_contains(ss, 0));
+    ASSERT(sparse_insert(ss, 1000, NULL) != NULL && sparse_size(ss) == 1);
+
+    sparse_free(ss);
+    ASSERT(sparse_new_with_allocator(0, fail_malloc, NULL, NULL) == NULL);
+    SUCCESS
+}
+
+
+void
+test_values(void)
+{
+    START
+
+    sparse_t ss = sparse_new(sizeof(struct position));
+
+    for (size_t i = 0; i < KEY_AMOUNT; i++)
+    {
+        struct position pos = { (double)i, (double)i * 2 };
+        ASSERT(sparse_insert(ss, (i * 7) % KEY_AMOUNT, &pos) != NULL);
+    }
+
+    for (size_t i = 0; i < KEY_AMOUNT; i += 2)
+        ASSERT(sparse_erase(ss, i) == 0);
+    ASSERT(sparse_size(ss) == KEY_AMOUNT / 2);
+
+    /* the dense arrays stay in step */
+    const size_t    *keys   = sparse_keys(ss);
+    struct position *values = sparse_values(ss);
+    for (size_t i = 0; i < sparse_size(ss); i++)
+    {
+        ASSERT(keys[i] % 2 == 1);
+        ASSERT(((size_t)values[i].x * 7) % KEY_AMOUNT == keys[i]);
+        ASSERT(values[i].y == values[i].x * 2);
+        ASSERT(sparse_get(ss, keys[i]) == &values[i]);
+    }
+
+    struct position *zero = sparse_insert(ss, 4, NULL);
+    ASSERT(zero != NULL && zero->x == 0 && zero->y == 0);
+
+    sparse_free(ss);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_keys();
+    test_values();
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "ds/tcache.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <pthread.h>
+
+#include "ds/darray.h"
+#include "ds/list.h"
+
+#define SUCCESS fprintf(stderr, "successful\n");
+#define FAILED \
+   { fprintf(stderr, "failed (%s:%d)\n", __FILE__, __LINE__); exit(1); }
+#define START fprintf(stderr, "%s: ", __func__);
+
+#define ASSERT(expr) \
+    if (!(expr)) FAILED
+
+#define THREADS    4
+#define ROUNDS     2000
+#define LIST_NODES 100
+
+
+/* lists handed between the threads, so nodes are freed by other threads */
+static list_t slots[THREADS];
+
+
+static list_t
+make_list(uintptr_t tag)
+{
+    list_t head = list_new();
+    list_t tail = head;
+    if (head == NULL) return NULL;
+
+    list_set_data(head, (void *)tag);
+    for (size_t i = 1; i < LIST_NODES; i++)
+    {
+        tail = list_append(tail, (void *)tag);
+        if (tail == NULL) return NULL;
+    }
+
+    return head;
+}
+
+
+static int
+check_list(list_t list)
+{
+    uintptr_t tag   = (uintptr_t)list_data(list);
+    size_t    count = 0;
+
+    for (; list != NULL; list = list_next(list), count++)
+        if ((uintptr_t)list_data(list) != tag) return 0;
+
+    return count == LIST_NODES;
+}
+
+
+static void *
+worker(void *arg)
+{
+    uintptr_t id = (uintptr_t)arg;
+
+    for (uintptr_t i = 0; i < ROUNDS; i++)
+    {
+        list_t list = make_list((id * ROUNDS) + i + 1);
+        if (list == NULL) return (void *)1;
+
+        list_t other = __atomic_exchange_n(&slots[(id + i) % THREADS], list,
+                                           __ATOMIC_ACQ_REL);
+        if (other != NULL)
+        {
+            if (!check_list(other)) return (void *)1;
+            list_free(other);
+        }
+
+        darray_t da = darray_new(sizeof(uintptr_t));
+        if (da == NULL || darray_push_back(da, &i) == NULL) return (void *)1;
+        if (*(uintptr_t *)darray_at(da, 0) != i) return (void *)1;
+        darray_free_full(da);
+    }
+
+    return NULL;
+}
+
+
+void
+test_switch(void)
+{
+    START
+
+    tcache_set_enabled(0);
+    ASSERT(!tcache_enabled());
+
+    /* allocated outside the cache, freed into it */
+    list_t list = make_list(1);
+    tcache_set_enabled(1);
+    ASSERT(tcache_enabled());
+    list_free(list);
+
+    /* and the other way around */
+    list = make_list(2);
+    tcache_set_enabled(0);
+    ASSERT(check_list(list));
+    list_free(list);
+
+    tcache_flush();
+    tcache_trim();
+    SUCCESS
+}
+
+
+void
+test_threads(void)
+{
+    START
+
+    pthread_t threads[THREADS];
+    tcache_set_enabled(1);
+
+    for (uintptr_t i = 0; i < THREADS; i++)
+        ASSERT(pthread_create(&threads[i], NULL, worker, (void *)i) == 0);
+
+    for (size_t i = 0; i < THREADS; i++)
+    {
+        void *res;
+        pthread_join(threads[i], &res);
+        ASSERT(res == NULL);
+    }
+
+    for (size_t i = 0; i < THREADS; i++)
+    {
+        ASSERT(check_list(slots[i]));
+        list_free(slots[i]);
+    }
+
+    tcache_flush();
+    tcache_trim();
+    tcache_set_enabled(0);
+    SUCCESS
+}
+
+
+int
+main(void)
+{
+    test_switch();
+    test_threads();
+
+    return 0;
+}